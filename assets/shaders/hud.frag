@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D atlas;
+
+void main() {
+    // Shapes carry negative texture coordinates and skip the glyph atlas.
+    float coverage = TexCoord.x < 0.0 ? 1.0 : texture(atlas, TexCoord).a;
+    FragColor = vec4(Color.rgb, Color.a * coverage);
+}
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+uniform vec2 screenSize;
+uniform vec2 atlasSize;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main() {
+    vec2 ndc = aPos / screenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    TexCoord = aTexCoord / atlasSize;
+    Color = aColor;
+}
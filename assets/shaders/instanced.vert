@@ -3,20 +3,42 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 layout (location = 2) in vec3 aNormal;
 
-layout (location = 3) in mat4 aInstanceMatrix;
+layout (location = 3) in vec3 aInstancePos;
+layout (location = 4) in uint aInstanceScaleMaterial;
 
 out vec2 TexCoord;
 out vec3 Normal;
 out vec3 FragPos;
+#ifdef MATERIAL_TEXTURES
+flat out uint Material;
+#endif
 
 uniform mat4 view;
 uniform mat4 projection;
 
+// The depth prepass and the GL_EQUAL shading pass must produce bit-identical depth.
+invariant gl_Position;
+
+const float SCALE_STEP = 1.0 / 32.0;
+// MaterialID::CEILING in InstanceData.h.
+const uint MATERIAL_CEILING = 2u;
+
 void main() {
+    vec3 scale = vec3(
+        float(aInstanceScaleMaterial & 0xFFu),
+        float((aInstanceScaleMaterial >> 8) & 0xFFu),
+        float((aInstanceScaleMaterial >> 16) & 0xFFu)
+    ) * SCALE_STEP;
 
-    FragPos = vec3(aInstanceMatrix * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(aInstanceMatrix))) * aNormal;
+    FragPos = aInstancePos + aPos * scale;
+    // Positive axis scale keeps the cube's axis-aligned face normals unchanged.
+    Normal = aNormal;
     TexCoord = aTexCoord;
+    // Ceiling cubes used to be drawn rotated 180 degrees about X; keep their underside unmirrored.
+    if ((aInstanceScaleMaterial >> 24) == MATERIAL_CEILING) TexCoord.y = 1.0 - TexCoord.y;
+#ifdef MATERIAL_TEXTURES
+    Material = aInstanceScaleMaterial >> 24;
+#endif
 
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
@@ -0,0 +1,41 @@
+#version 330 core
+in vec2 Local;
+out vec4 FragColor;
+
+uniform sampler2D cells;
+uniform vec2 center;        // player x/z in cells
+uniform vec2 heading;       // normalized facing on the x/z plane
+uniform float viewCells;
+
+const vec4 PALETTE[5] = vec4[5](
+    vec4(0.0, 0.0, 0.0, 0.35),      // unknown
+    vec4(0.30, 0.30, 0.26, 0.85),   // floor
+    vec4(0.75, 0.75, 0.70, 0.95),   // wall
+    vec4(0.55, 0.35, 0.15, 0.95),   // door
+    vec4(0.80, 0.15, 0.10, 0.95)    // locked door
+);
+
+void main() {
+    float radius = length(Local);
+    if (radius > 1.0) discard;
+
+    // Screen y grows downwards, which lines up with +z in the maze.
+    vec2 world = center + Local * (viewCells * 0.5);
+    ivec2 cell = ivec2(floor(world));
+    ivec2 size = textureSize(cells, 0);
+    int kind = 0;
+    if (all(greaterThanEqual(cell, ivec2(0))) && all(lessThan(cell, size))) {
+        kind = int(texelFetch(cells, cell, 0).r * 255.0 + 0.5);
+    }
+    vec4 color = PALETTE[clamp(kind, 0, 4)];
+
+    // Player marker: an arrow along the heading, built in marker-local coordinates.
+    vec2 offset = (world - center) / 0.6;
+    vec2 local = vec2(dot(offset, heading), dot(offset, vec2(-heading.y, heading.x)));
+    bool arrow = local.x < 1.0 && local.x > -0.6 && abs(local.y) < (1.0 - local.x) * 0.45;
+    if (arrow) color = vec4(1.0, 0.85, 0.2, 1.0);
+
+    // Thin rim.
+    if (radius > 0.96) color = vec4(0.8, 0.8, 0.8, 0.9);
+    FragColor = color;
+}
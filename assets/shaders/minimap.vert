@@ -0,0 +1,13 @@
+#version 330 core
+uniform vec2 screenSize;
+uniform vec4 rect;      // x, y, width, height in pixels, top-left origin
+
+out vec2 Local;
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 pixel = rect.xy + corner * rect.zw;
+    vec2 ndc = pixel / screenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    Local = corner * 2.0 - 1.0;
+}
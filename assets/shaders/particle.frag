@@ -0,0 +1,13 @@
+#version 330 core
+in vec2 Corner;
+in vec3 Color;
+
+out vec4 FragColor;
+
+void main() {
+    float r2 = dot(Corner, Corner);
+    if (r2 > 1.0) discard;
+    float falloff = 1.0 - r2;
+    // Additive blend: alpha is ignored.
+    FragColor = vec4(Color * falloff * falloff, 1.0);
+}
@@ -0,0 +1,39 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;
+layout (location = 1) in vec4 aCenterSize;
+layout (location = 2) in float aAlpha;
+
+uniform mat4 projection;
+uniform mat4 view;
+uniform vec3 cameraRight;
+uniform vec3 cameraUp;
+
+uniform vec3 viewPos;
+uniform vec3 lightPos;
+uniform vec3 lightDir;
+uniform float cutOff;
+uniform float outerCutOff;
+uniform float lightIntensity;
+uniform float fogDensity;
+
+out vec2 Corner;
+out vec3 Color;
+
+void main() {
+    vec3 center = aCenterSize.xyz;
+    vec3 world = center + (cameraRight * aCorner.x + cameraUp * aCorner.y) * aCenterSize.w;
+
+    // Same flashlight cone and falloff as shader.frag, evaluated once per mote.
+    vec3 toLight = lightPos - center;
+    float dist = length(toLight);
+    float theta = dot(toLight / max(dist, 1e-4), -lightDir);
+    float cone = clamp((theta - outerCutOff) / (cutOff - outerCutOff), 0.0, 1.0);
+    float attenuation = 1.0 / (1.0 + 0.045 * dist + 0.0075 * dist * dist);
+
+    float fogDist = length(viewPos - center) * fogDensity;
+    float fog = exp(-fogDist * fogDist);
+
+    Color = vec3(2.5, 2.4, 2.0) * (cone * attenuation * lightIntensity * fog * aAlpha);
+    Corner = aCorner;
+    gl_Position = projection * view * vec4(world, 1.0);
+}
@@ -0,0 +1,3 @@
+vec3 Bloom(vec3 color, vec2 uv) {
+    return color + texture(bloom, uv).rgb * 0.8;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D inputTexture;
+uniform vec2 texelSize;
+uniform vec2 direction;
+
+// 9-tap gaussian folded into 5 bilinear fetches.
+const float offsets[3] = float[](0.0, 1.3846153846, 3.2307692308);
+const float weights[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main() {
+    vec3 result = texture(inputTexture, TexCoords).rgb * weights[0];
+    for (int i = 1; i < 3; i++) {
+        vec2 offset = direction * texelSize * offsets[i];
+        result += texture(inputTexture, TexCoords + offset).rgb * weights[i];
+        result += texture(inputTexture, TexCoords - offset).rgb * weights[i];
+    }
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D inputTexture;
+uniform vec2 texelSize;
+uniform float threshold;
+
+void main() {
+    // Four bilinear taps average a 4x4 footprint, so the downsample doesn't shimmer.
+    vec3 color = texture(inputTexture, TexCoords + texelSize * vec2(-1.0, -1.0)).rgb;
+    color += texture(inputTexture, TexCoords + texelSize * vec2( 1.0, -1.0)).rgb;
+    color += texture(inputTexture, TexCoords + texelSize * vec2(-1.0,  1.0)).rgb;
+    color += texture(inputTexture, TexCoords + texelSize * vec2( 1.0,  1.0)).rgb;
+    color *= 0.25;
+
+    float brightness = max(color.r, max(color.g, color.b));
+    float contribution = max(brightness - threshold, 0.0) / max(brightness, 0.0001);
+    FragColor = vec4(color * contribution, 1.0);
+}
@@ -0,0 +1,9 @@
+// Film grain with a slightly different period per channel, so it reads as colour noise.
+vec3 ChromaNoise(vec3 color, vec2 uv) {
+    float x = (uv.x + 4.0) * (uv.y + 4.0) * (time * 10.0);
+    vec3 grain = vec3(
+        mod((mod(x, 13.0) + 1.0) * (mod(x, 123.0) + 1.0), 0.01),
+        mod((mod(x, 17.0) + 1.0) * (mod(x, 127.0) + 1.0), 0.01),
+        mod((mod(x, 19.0) + 1.0) * (mod(x, 131.0) + 1.0), 0.01)) - 0.005;
+    return color + grain * 0.05;
+}
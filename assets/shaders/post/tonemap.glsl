@@ -0,0 +1,6 @@
+// Leaves the 0..0.8 range untouched and rolls emissive highlights off towards 1, then applies gamma.
+vec3 Tonemap(vec3 color, vec2 uv) {
+    vec3 over = max(color - 0.8, 0.0);
+    color = min(color, 0.8) + over / (1.0 + over * 5.0);
+    return pow(color, vec3(1.0 / 2.2));
+}
@@ -0,0 +1,5 @@
+vec3 Vignette(vec3 color, vec2 uv) {
+    vec2 edge = uv * (1.0 - uv.yx);
+    float vig = pow(edge.x * edge.y * 15.0, 0.2);
+    return color * vig;
+}
@@ -5,11 +5,35 @@ in vec2 TexCoord;
 in vec3 Normal;
 in vec3 FragPos;
 
+#ifdef MATERIAL_TEXTURES
+// GPU-driven path: one multi-draw covers every material, so pick the texture per instance.
+flat in uint Material;
+uniform sampler2D materialTextures[5];
+
+vec4 SampleAlbedo() {
+    switch (Material) {
+        case 0u: return texture(materialTextures[0], TexCoord);
+        case 1u: return texture(materialTextures[1], TexCoord);
+        case 2u: return texture(materialTextures[2], TexCoord);
+        case 3u: return texture(materialTextures[3], TexCoord);
+        default: return texture(materialTextures[4], TexCoord);
+    }
+}
+#else
 uniform sampler2D texture1;
+
+vec4 SampleAlbedo() {
+    return texture(texture1, TexCoord);
+}
+#endif
+
 uniform vec3 viewPos;
 uniform float batteryRatio;
 uniform float flicker;
 uniform bool isUnlit;
+// Unlit pickups are pushed past 1.0 so the post-process bright pass blooms them.
+uniform float emissiveBoost;
+uniform float fogDensity;
 
 struct SpotLight {
     vec3 position;
@@ -26,16 +50,88 @@ struct SpotLight {
 
 uniform SpotLight spotLight;
 
+// Tile-grid light lists built by LightGrid: per cell (offset, count) into lightIndices,
+// each light is three texels in lightData: (pos, radius), (color, intensity), (dir, cosOuterCutOff).
+uniform usampler2D lightCells;
+uniform usamplerBuffer lightIndices;
+uniform samplerBuffer lightData;
+uniform bool useLightGrid;
+
+// Baked static lighting from LightmapBaker: each map cell owns a 3x2 grid of square face blocks,
+// rgb = irradiance / 4, a = ambient occlusion.
+uniform sampler2D lightmap;
+uniform bool useLightmap;
+// Texels per face block edge; smaller on maps whose atlas would not fit at full size.
+uniform float lightmapBlock;
+
+const float LIGHTMAP_RANGE = 4.0;
+// Wall blocks span the wall boxes from below the floor up to the ceiling.
+const float WALL_BOTTOM = -0.5;
+const float CEILING_Y = 3.5;
+
+vec4 SampleLightmap(vec3 norm) {
+    vec3 inside = FragPos - norm * 0.01;
+    vec2 cell = floor(inside.xz);
+    vec3 axis = abs(norm);
+
+    int face;
+    vec2 uv;
+    if (axis.x > axis.y && axis.x > axis.z) {
+        face = norm.x > 0.0 ? 0 : 1;
+        uv = vec2(FragPos.z - cell.y, (FragPos.y - WALL_BOTTOM) / (CEILING_Y - WALL_BOTTOM));
+    } else if (axis.y > axis.z) {
+        face = norm.y > 0.0 ? 2 : 3;
+        uv = FragPos.xz - cell;
+    } else {
+        face = norm.z > 0.0 ? 4 : 5;
+        uv = vec2(FragPos.x - cell.x, (FragPos.y - WALL_BOTTOM) / (CEILING_Y - WALL_BOTTOM));
+    }
+
+    vec2 block = (cell * vec2(3.0, 2.0) + vec2(float(face % 3), float(face / 3))) * lightmapBlock;
+    vec2 texel = block + 0.5 + clamp(uv, 0.0, 1.0) * (lightmapBlock - 1.0);
+    return texture(lightmap, texel / vec2(textureSize(lightmap, 0)));
+}
+
+vec3 EvaluateGridLights(vec3 norm, vec3 viewDir, vec3 albedo) {
+    ivec2 cell = ivec2(floor(FragPos.xz + norm.xz * 0.01));
+    ivec2 gridSize = textureSize(lightCells, 0);
+    if (cell.x < 0 || cell.y < 0 || cell.x >= gridSize.x || cell.y >= gridSize.y) return vec3(0.0);
+
+    uvec2 range = texelFetch(lightCells, cell, 0).xy;
+    vec3 total = vec3(0.0);
+    for (uint i = 0u; i < range.y; i++) {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 posRadius = texelFetch(lightData, light * 3);
+        vec4 colorIntensity = texelFetch(lightData, light * 3 + 1);
+        vec4 dirCone = texelFetch(lightData, light * 3 + 2);
+
+        vec3 toLight = posRadius.xyz - FragPos;
+        float dist = length(toLight);
+        if (dist >= posRadius.w) continue;
+        vec3 L = toLight / dist;
+
+        float window = 1.0 - (dist * dist) / (posRadius.w * posRadius.w);
+        float falloff = window * window / (1.0 + dist * dist);
+
+        float cone = 1.0;
+        if (dirCone.w > -1.0) cone = smoothstep(dirCone.w, mix(dirCone.w, 1.0, 0.3), dot(-L, dirCone.xyz));
+
+        float diff = max(dot(norm, L), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-L, norm)), 0.0), 32.0);
+        total += colorIntensity.rgb * colorIntensity.a * falloff * cone * (diff * albedo + spec * 0.2 * albedo);
+    }
+    return total;
+}
+
 void main() {
-    vec4 texColor = texture(texture1, TexCoord);
+    vec4 texColor = SampleAlbedo();
 
 
     if (isUnlit) {
-        FragColor = texColor;
+        FragColor = vec4(texColor.rgb * (1.0 + emissiveBoost), texColor.a);
 
         float dist = length(viewPos - FragPos);
-        float dens = 0.09;
-        float fog = 1.0 / exp(dist * dist * dens * dens);
+        float fog = 1.0 / exp(dist * dist * fogDensity * fogDensity);
         FragColor = mix(vec4(0.0, 0.0, 0.0, 1.0), FragColor, clamp(fog, 0.0, 1.0));
         return;
     }
@@ -59,6 +155,10 @@ void main() {
 
 
     vec3 ambient = spotLight.ambient * texColor.rgb;
+    if (useLightmap) {
+        vec4 baked = SampleLightmap(norm);
+        ambient = (spotLight.ambient * baked.a + baked.rgb * LIGHTMAP_RANGE) * texColor.rgb;
+    }
 
     float diff = max(dot(norm, lightDir), 0.0);
     vec3 diffuse = spotLight.diffuse * diff * texColor.rgb;
@@ -69,12 +169,12 @@ void main() {
     vec3 specular = spotLight.specular * spec * texColor.rgb;
 
     vec3 result = ambient + (diffuse + specular) * intensity * attenuation * powerFactor;
+    if (useLightGrid) result += EvaluateGridLights(norm, viewDir, texColor.rgb);
 
 
 
 
     float fogDistance = length(viewPos - FragPos);
-    float fogDensity = 0.09;
     float fogFactor = 1.0 / exp(fogDistance * fogDistance * fogDensity * fogDensity);
     fogFactor = clamp(fogFactor, 0.0, 1.0);
 
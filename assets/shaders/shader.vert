@@ -8,12 +8,13 @@ out vec3 Normal;
 out vec3 FragPos;
 
 uniform mat4 model;
+uniform mat3 normalMatrix;
 uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = normalMatrix * aNormal;
     TexCoord = aTexCoord;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -1,93 +1,534 @@
 #include "AudioManager.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "../Entities/SoundPropagation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 #include <SFML/Audio.hpp>
 
+namespace {
+    // Spatial voices quieter than this at the listener give up their source.
+    constexpr float AUDIBLE_GAIN = 0.01f;
+    constexpr float MIN_DISTANCE = 1.0f;
+    constexpr float TWO_PI = 6.28318530718f;
+    // How often the audio thread drains commands and updates voices.
+    constexpr auto AUDIO_TICK = std::chrono::milliseconds(5);
+
+    std::unique_ptr<sf::SoundBuffer> DecodeFromBank(const SoundBankEntry& entry) {
+        MAZE_PROFILE_SCOPE("AudioManager::DecodeFromBank");
+        std::vector<std::int16_t> samples = SoundBank::Decode(entry);
+        std::vector<sf::SoundChannel> channelMap = entry.channels == 1
+            ? std::vector<sf::SoundChannel>{sf::SoundChannel::Mono}
+            : std::vector<sf::SoundChannel>{sf::SoundChannel::FrontLeft, sf::SoundChannel::FrontRight};
+        auto buffer = std::make_unique<sf::SoundBuffer>();
+        if (!buffer->loadFromSamples(samples.data(), samples.size(), entry.channels, entry.sampleRate, channelMap)) {
+            std::cerr << "ERROR: Failed to decode sound: " << entry.name << std::endl;
+            return nullptr;
+        }
+        return buffer;
+    }
+}
+
 AudioManager::AudioManager() {
     sf::Listener::setGlobalVolume(100.0f);
+
+    m_ActiveHead.fill(-1);
+    m_ActiveTail.fill(-1);
+    m_FreeVoices.reserve(MAX_VOICES);
+    for (int i = MAX_VOICES - 1; i >= 0; i--) m_FreeVoices.push_back(i);
+    m_FreeSources.reserve(MAX_SOURCES);
+    for (int i = MAX_SOURCES - 1; i >= 0; i--) m_FreeSources.push_back(i);
+
+    m_Thread = std::thread(&AudioManager::AudioLoop, this);
+}
+
+// Bank decodes on the JobSystem read the mapped bank; let them finish before it is unmapped.
+AudioManager::~AudioManager() {
+    m_Quit.store(true, std::memory_order_release);
+    m_Thread.join();
+
+    m_SoundPool.ForEach([](SoundHandle, SoundEntry& entry) {
+        if (entry.loading.valid()) entry.loading.wait();
+    });
+}
+
+// Commands that change state must arrive, so a full queue is waited out rather than dropped.
+void AudioManager::Send(const Command& command) {
+    while (!m_Commands.TryPush(command)) std::this_thread::yield();
 }
 
-void AudioManager::LoadSound(const std::string& name, const std::string& path) {
-    sf::SoundBuffer buffer;
-    if (!buffer.loadFromFile(path)) {
-        std::cerr << "ERROR: Failed to load sound: " << path << std::endl;
-        return;
+bool AudioManager::TrySend(const Command& command) {
+    return m_Commands.TryPush(command);
+}
+
+void AudioManager::AudioLoop() {
+    MAZE_PROFILE_THREAD("Audio");
+    auto last = std::chrono::steady_clock::now();
+    while (true) {
+        // Read before draining, so every command pushed before shutdown is executed.
+        const bool quit = m_Quit.load(std::memory_order_acquire);
+        {
+            MAZE_PROFILE_SCOPE("AudioManager::Tick");
+            Command command;
+            while (m_Commands.TryPop(command)) Execute(command);
+            if (quit) break;
+
+            auto now = std::chrono::steady_clock::now();
+            Update(std::chrono::duration<float>(now - last).count());
+            last = now;
+        }
+        std::this_thread::sleep_for(AUDIO_TICK);
+    }
+
+    StopVoices();
+    for (auto& music : m_Music) {
+        if (music) music->stop();
     }
-    m_Buffers[name] = buffer;
 }
 
-void AudioManager::PlayGlobal(const std::string& name, float volume) {
-    CleanFinishedSounds();
+void AudioManager::Execute(const Command& command) {
+    switch (command.type) {
+        case Command::Type::PLAY:
+            Play(command.sound, command.spatial, command.position, command.volume, command.attenuation);
+            break;
+        case Command::Type::SET_LISTENER:
+            m_ListenerPos = command.position;
+            sf::Listener::setPosition({command.position.x, command.position.y, command.position.z});
+            sf::Listener::setDirection({command.forward.x, command.forward.y, command.forward.z});
+            sf::Listener::setUpVector({command.up.x, command.up.y, command.up.z});
+            break;
+        case Command::Type::STOP_SOUNDS:
+            StopVoices();
+            break;
+        case Command::Type::LOAD_MUSIC:
+            m_Music[command.index].reset(command.music);
+            break;
+        case Command::Type::PLAY_MUSIC:
+            for (int i = 0; i < MAX_MUSIC; i++) {
+                if (m_Music[i] && i != command.index) m_Music[i]->stop();
+            }
+            if (sf::Music* music = m_Music[command.index].get()) {
+                music->setVolume(command.volume);
+                music->play();
+            }
+            break;
+        case Command::Type::STOP_MUSIC:
+            for (auto& music : m_Music) {
+                if (music) music->stop();
+            }
+            break;
+        case Command::Type::SET_PROPAGATION:
+            // Fields belong to the old grid; playing voices take new ones from the new grid.
+            for (Voice& voice : m_Voices) voice.field = -1;
+            m_Propagation.reset(command.propagation);
+            for (Voice& voice : m_Voices) {
+                if (voice.buffer && voice.spatial && m_Propagation) voice.field = m_Propagation->AcquireField(voice.position);
+            }
+            break;
+        case Command::Type::SET_TILE:
+            if (m_Propagation) m_Propagation->SetTile(command.x, command.z, command.index);
+            break;
+        case Command::Type::SET_PCM_BUDGET:
+            m_PcmBudget = command.bytes;
+            break;
+    }
+}
 
+void AudioManager::SetPcmCacheBudget(std::size_t bytes) {
+    Command command;
+    command.type = Command::Type::SET_PCM_BUDGET;
+    command.bytes = bytes;
+    Send(command);
+}
+
+void AudioManager::SetPropagation(std::unique_ptr<SoundPropagation> propagation) {
+    Command command;
+    command.type = Command::Type::SET_PROPAGATION;
+    command.propagation = propagation.release();
+    Send(command);
+}
 
-    if (!m_Buffers.contains(name)) return;
+void AudioManager::SetPropagationTile(int x, int z, int tile) {
+    Command command;
+    command.type = Command::Type::SET_TILE;
+    command.x = x;
+    command.z = z;
+    command.index = tile;
+    Send(command);
+}
 
+bool AudioManager::LoadBank(const std::string& path) {
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) return false;
+    auto bank = std::make_unique<SoundBank>();
+    if (!bank->Open(path)) return false;
+    m_Bank = std::move(bank);
+    return true;
+}
 
-    if (name == "footstep") {
-        for (const auto& s : m_Sounds) {
+SoundHandle AudioManager::LoadSound(const std::string& name, const std::string& path, SoundSettings settings) {
+    std::lock_guard<std::mutex> lock(m_NamesMutex);
+    auto found = m_SoundNames.find(name);
+    if (found != m_SoundNames.end()) {
+        m_SoundPool.AddRef(found->second);
+        return found->second;
+    }
 
-            if (s->getStatus() == sf::SoundSource::Status::Playing && s->getVolume() > 0.0f) {
+    // The bank stands in for the source file unless the file was edited after the bank was built.
+    const SoundBankEntry* banked = m_Bank ? m_Bank->Find(std::filesystem::path(path).filename().string()) : nullptr;
+    std::error_code error;
+    if (banked && std::filesystem::exists(path, error) &&
+        std::filesystem::last_write_time(path, error) > std::filesystem::last_write_time(m_Bank->GetPath(), error)) {
+        banked = nullptr;
+    }
 
-                return;
+    std::future<std::unique_ptr<sf::SoundBuffer>> loading;
+    const bool onDemand = banked && banked->GetPcmBytes() > RESIDENT_PCM_BYTES;
+    if (banked && !onDemand) {
+        loading = JobSystem::Shared().Submit([banked] { return DecodeFromBank(*banked); });
+    } else if (!banked) {
+        loading = JobSystem::Shared().Submit([path]() -> std::unique_ptr<sf::SoundBuffer> {
+            auto buffer = std::make_unique<sf::SoundBuffer>();
+            if (!buffer->loadFromFile(path)) {
+                std::cerr << "ERROR: Failed to load sound: " << path << std::endl;
+                return nullptr;
             }
+            return buffer;
+        });
+    }
+
+    SoundHandle handle = m_SoundPool.Create(name, std::move(loading), settings, onDemand ? banked : nullptr);
+    if (!handle.IsValid()) {
+        std::cerr << "ERROR: Sound table is full, cannot load " << path << std::endl;
+        return handle;
+    }
+    m_SoundNames[name] = handle;
+    return handle;
+}
+
+void AudioManager::ReleaseSound(SoundHandle handle) {
+    std::lock_guard<std::mutex> lock(m_NamesMutex);
+    const SoundEntry* entry = m_SoundPool.Get(handle);
+    if (!entry) return;
+    std::string name = entry->name;
+    if (m_SoundPool.Release(handle)) m_SoundNames.erase(name);
+}
+
+AudioManager::SoundEntry* AudioManager::FindEntry(SoundHandle sound) {
+    SoundEntry* entry = m_SoundPool.Get(sound);
+    if (!entry) return nullptr;
+    if (entry->loading.valid()) {
+        entry->buffer = entry->loading.get();
+        if (entry->buffer) entry->duration = entry->buffer->getDuration().asSeconds();
+    }
+    if (entry->cached) {
+        entry->lastPlayed = ++m_PlayCount;
+        if (!entry->buffer) {
+            EvictPcm(entry->cached->GetPcmBytes());
+            entry->buffer = DecodeFromBank(*entry->cached);
+            if (entry->buffer) m_CachedPcmBytes += entry->cached->GetPcmBytes();
         }
     }
+    return entry->buffer ? entry : nullptr;
+}
+
+// Drops the least recently played cached sounds that no voice is using until incoming fits.
+// A sound that is playing is never evicted, so the cache can run over budget until it stops.
+void AudioManager::EvictPcm(std::size_t incoming) {
+    while (m_CachedPcmBytes + incoming > m_PcmBudget) {
+        SoundEntry* victim = nullptr;
+        m_SoundPool.ForEach([&victim](SoundHandle, SoundEntry& entry) {
+            if (!entry.cached || !entry.buffer || entry.instances > 0) return;
+            if (!victim || entry.lastPlayed < victim->lastPlayed) victim = &entry;
+        });
+        if (!victim) return;
+        victim->buffer.reset();
+        m_CachedPcmBytes -= victim->cached->GetPcmBytes();
+    }
+}
+
+void AudioManager::PlayGlobal(SoundHandle sound, float volume) {
+    Command command;
+    command.sound = sound;
+    command.volume = volume;
+    TrySend(command);
+}
 
-    auto sound = std::make_unique<sf::Sound>(m_Buffers[name]);
-    sound->setVolume(volume);
-    sound->setRelativeToListener(true);
-    sound->setPosition({0, 0, 0});
-    sound->play();
-    m_Sounds.push_back(std::move(sound));
+void AudioManager::PlaySpatial(SoundHandle sound, glm::vec3 position, float volume, float attenuation) {
+    Command command;
+    command.sound = sound;
+    command.spatial = true;
+    command.position = position;
+    command.volume = volume;
+    command.attenuation = attenuation;
+    TrySend(command);
 }
 
-void AudioManager::PlaySpatial(const std::string& name, glm::vec3 position, float volume, float attenuation) {
-    CleanFinishedSounds();
+void AudioManager::Play(SoundHandle sound, bool spatial, glm::vec3 position, float volume, float attenuation) {
+    SoundEntry* entry = FindEntry(sound);
+    if (!entry || entry->instances >= entry->settings.maxInstances) return;
 
-    if (!m_Buffers.contains(name)) return;
+    const int index = AcquireVoice(entry->settings.priority);
+    if (index < 0) return;
 
-    auto sound = std::make_unique<sf::Sound>(m_Buffers[name]);
-    sound->setVolume(volume);
-    sound->setPosition({position.x, position.y, position.z});
-    sound->setMinDistance(1.0f);
-    sound->setAttenuation(attenuation);
-    sound->play();
-    m_Sounds.push_back(std::move(sound));
+    Voice& voice = m_Voices[index];
+    voice.sound = sound;
+    voice.buffer = entry->buffer.get();
+    voice.priority = entry->settings.priority;
+    voice.spatial = spatial;
+    voice.position = position;
+    voice.field = spatial && m_Propagation ? m_Propagation->AcquireField(position) : -1;
+    voice.volume = volume;
+    voice.attenuation = attenuation;
+    voice.elapsed = 0.0f;
+    voice.duration = entry->duration;
+    voice.source = -1;
+    entry->instances++;
+    LinkVoice(index);
+    UpdatePath(voice);
+
+    if (IsAudible(voice)) Realize(index);
 }
 
-void AudioManager::PlayMusic(const std::string& path, float volume) {
-    if (!m_Music) m_Music = std::make_unique<sf::Music>();
+// A free voice, else the oldest of the lowest priority that does not outrank the request.
+int AudioManager::AcquireVoice(SoundPriority priority) {
+    if (m_FreeVoices.empty()) {
+        for (int p = 0; p <= static_cast<int>(priority); p++) {
+            if (m_ActiveHead[p] < 0) continue;
+            FreeVoice(m_ActiveHead[p]);
+            break;
+        }
+        if (m_FreeVoices.empty()) return -1;
+    }
+    int index = m_FreeVoices.back();
+    m_FreeVoices.pop_back();
+    return index;
+}
+
+void AudioManager::FreeVoice(int index) {
+    Voice& voice = m_Voices[index];
+    if (voice.source >= 0) {
+        m_Sources[voice.source]->stop();
+        m_FreeSources.push_back(voice.source);
+        voice.source = -1;
+    }
+    if (SoundEntry* entry = m_SoundPool.Get(voice.sound)) entry->instances--;
+    if (voice.field >= 0) m_Propagation->ReleaseField(voice.field);
+    voice.field = -1;
+    UnlinkVoice(index);
+    voice.sound = {};
+    voice.buffer = nullptr;
+    m_FreeVoices.push_back(index);
+}
+
+void AudioManager::LinkVoice(int index) {
+    Voice& voice = m_Voices[index];
+    const int p = static_cast<int>(voice.priority);
+    voice.prev = m_ActiveTail[p];
+    voice.next = -1;
+    if (voice.prev >= 0) m_Voices[voice.prev].next = index;
+    else m_ActiveHead[p] = index;
+    m_ActiveTail[p] = index;
+}
+
+void AudioManager::UnlinkVoice(int index) {
+    Voice& voice = m_Voices[index];
+    const int p = static_cast<int>(voice.priority);
+    if (voice.prev >= 0) m_Voices[voice.prev].next = voice.next;
+    else m_ActiveHead[p] = voice.next;
+    if (voice.next >= 0) m_Voices[voice.next].prev = voice.prev;
+    else m_ActiveTail[p] = voice.prev;
+    voice.prev = voice.next = -1;
+}
+
+// Same inverse distance model OpenAL applies, with the MIN_DISTANCE every spatial voice uses.
+bool AudioManager::IsAudible(const Voice& voice) const {
+    if (!voice.spatial) return true;
+    float distance = std::max(glm::distance(voice.heardPosition, m_ListenerPos), MIN_DISTANCE);
+    float gain = MIN_DISTANCE / (MIN_DISTANCE + voice.attenuation * (distance - MIN_DISTANCE));
+    return gain * voice.volume * voice.transmission * 0.01f >= AUDIBLE_GAIN;
+}
+
+// Gives the voice a source, taking one from an older voice of no higher priority if none is free.
+// That voice goes virtual rather than stopping.
+bool AudioManager::Realize(int index) {
+    Voice& voice = m_Voices[index];
+    if (m_FreeSources.empty()) {
+        for (int p = 0; p <= static_cast<int>(voice.priority) && m_FreeSources.empty(); p++) {
+            for (int other = m_ActiveHead[p]; other >= 0 && other != index; other = m_Voices[other].next) {
+                if (m_Voices[other].source < 0) continue;
+                Virtualize(other);
+                break;
+            }
+        }
+        if (m_FreeSources.empty()) return false;
+    }
+    voice.source = m_FreeSources.back();
+    m_FreeSources.pop_back();
 
-    if (m_Music->openFromFile(path)) {
-        m_Music->setLooping(true);
-        m_Music->setVolume(volume);
-        m_Music->play();
+    std::optional<sf::Sound>& source = m_Sources[voice.source];
+    if (source) {
+        source->setBuffer(*voice.buffer);
     } else {
+        source.emplace(*voice.buffer);
+        LowPass* filter = &m_LowPass[voice.source];
+        source->setEffectProcessor([filter](const float* input, unsigned int& inputFrames, float* output,
+                                            unsigned int& outputFrames, unsigned int channels) {
+            // No input means the source is draining; the filter has no tail to flush.
+            const unsigned int frames = input ? std::min(inputFrames, outputFrames) : 0;
+            const float alpha = filter->alpha.load(std::memory_order_relaxed);
+            if (frames > 0 && filter->reset.exchange(false, std::memory_order_relaxed)) {
+                for (unsigned int c = 0; c < channels && c < 2; c++) filter->state[c] = input[c];
+            }
+            for (unsigned int f = 0; f < frames; f++) {
+                for (unsigned int c = 0; c < channels; c++) {
+                    const float sample = input[f * channels + c];
+                    if (c >= 2) {
+                        output[f * channels + c] = sample;
+                        continue;
+                    }
+                    filter->state[c] += alpha * (sample - filter->state[c]);
+                    output[f * channels + c] = filter->state[c];
+                }
+            }
+            inputFrames = outputFrames = frames;
+        });
+    }
+    m_LowPass[voice.source].reset.store(true, std::memory_order_relaxed);
+    ApplyPath(voice);
+    source->setRelativeToListener(!voice.spatial);
+    source->setMinDistance(MIN_DISTANCE);
+    source->setAttenuation(voice.spatial ? voice.attenuation : 0.0f);
+    source->setPlayingOffset(sf::seconds(voice.elapsed));
+    source->play();
+    return true;
+}
+
+void AudioManager::Virtualize(int index) {
+    Voice& voice = m_Voices[index];
+    sf::Sound& source = *m_Sources[voice.source];
+    voice.elapsed = source.getPlayingOffset().asSeconds();
+    source.stop();
+    m_FreeSources.push_back(voice.source);
+    voice.source = -1;
+}
+
+// Straight-line unless the voice has a propagation field; unreachable voices get no transmission.
+void AudioManager::UpdatePath(Voice& voice) {
+    voice.heardPosition = voice.position;
+    voice.transmission = 1.0f;
+    voice.cutoffHz = 0.0f;
+    if (voice.field < 0) return;
+
+    SoundPath path = m_Propagation->Query(voice.field, voice.position, m_ListenerPos);
+    voice.heardPosition = path.position;
+    voice.transmission = path.audible ? path.transmission : 0.0f;
+    voice.cutoffHz = path.cutoffHz;
+}
+
+void AudioManager::ApplyPath(const Voice& voice) {
+    sf::Sound& source = *m_Sources[voice.source];
+    source.setVolume(voice.volume * voice.transmission);
+    source.setPosition(voice.spatial ? sf::Vector3f(voice.heardPosition.x, voice.heardPosition.y, voice.heardPosition.z) : sf::Vector3f(0, 0, 0));
+
+    float alpha = 1.0f;
+    if (voice.cutoffHz > 0.0f) {
+        alpha = 1.0f - std::exp(-TWO_PI * voice.cutoffHz / static_cast<float>(voice.buffer->getSampleRate()));
+    }
+    m_LowPass[voice.source].alpha.store(alpha, std::memory_order_relaxed);
+}
+
+void AudioManager::Update(float dt) {
+    m_SoundPool.CollectRetired([this](SoundEntry& entry) {
+        if (!entry.buffer) return;
+        for (int i = 0; i < MAX_VOICES; i++) {
+            if (m_Voices[i].buffer == entry.buffer.get()) FreeVoice(i);
+        }
+        if (entry.cached) m_CachedPcmBytes -= entry.cached->GetPcmBytes();
+    });
+    // Catches up on evictions that had to wait for a sound to stop playing.
+    if (m_CachedPcmBytes > m_PcmBudget) EvictPcm(0);
+
+    // Highest priority first, so it gets first pick of the sources.
+    for (int p = PRIORITY_COUNT - 1; p >= 0; p--) {
+        for (int index = m_ActiveHead[p]; index >= 0;) {
+            Voice& voice = m_Voices[index];
+            const int next = voice.next;
+            if (voice.field >= 0) UpdatePath(voice);
+            if (voice.source >= 0) {
+                if (m_Sources[voice.source]->getStatus() == sf::SoundSource::Status::Stopped) FreeVoice(index);
+                else if (!IsAudible(voice)) Virtualize(index);
+                else if (voice.field >= 0) ApplyPath(voice);
+            } else {
+                voice.elapsed += dt;
+                if (voice.elapsed >= voice.duration) FreeVoice(index);
+                else if (IsAudible(voice)) Realize(index);
+            }
+            index = next;
+        }
+    }
+}
+
+int AudioManager::LoadMusic(const std::string& path) {
+    if (m_MusicCount >= MAX_MUSIC) {
+        std::cerr << "ERROR: Too many music tracks, cannot load " << path << std::endl;
+        return -1;
+    }
+    auto music = std::make_unique<sf::Music>();
+    if (!music->openFromFile(path)) {
         std::cerr << "ERROR: Failed to load music: " << path << std::endl;
+        return -1;
     }
+    music->setLooping(true);
+
+    Command command;
+    command.type = Command::Type::LOAD_MUSIC;
+    command.index = m_MusicCount++;
+    command.music = music.release();
+    Send(command);
+    return command.index;
+}
+
+void AudioManager::PlayMusic(int music, float volume) {
+    if (music < 0 || music >= m_MusicCount) return;
+    Command command;
+    command.type = Command::Type::PLAY_MUSIC;
+    command.index = music;
+    command.volume = volume;
+    Send(command);
 }
 
 void AudioManager::StopMusic() {
-    if (m_Music) m_Music->stop();
+    Command command;
+    command.type = Command::Type::STOP_MUSIC;
+    Send(command);
 }
 
+void AudioManager::StopSounds() {
+    Command command;
+    command.type = Command::Type::STOP_SOUNDS;
+    Send(command);
+}
 
 void AudioManager::StopAllSounds() {
-    for (auto& sound : m_Sounds) {
-        sound->stop();
-    }
-    m_Sounds.clear();
+    StopSounds();
     StopMusic();
 }
 
-void AudioManager::UpdateListener(glm::vec3 position, glm::vec3 forward, glm::vec3 up) {
-    sf::Listener::setPosition({position.x, position.y, position.z});
-    sf::Listener::setDirection({forward.x, forward.y, forward.z});
-    sf::Listener::setUpVector({up.x, up.y, up.z});
+void AudioManager::StopVoices() {
+    for (int p = 0; p < PRIORITY_COUNT; p++) {
+        while (m_ActiveHead[p] >= 0) FreeVoice(m_ActiveHead[p]);
+    }
 }
 
-void AudioManager::CleanFinishedSounds() {
-    std::erase_if(m_Sounds, [](const auto& sound) {
-
-        return sound->getStatus() == sf::SoundSource::Status::Stopped;
-    });
-}
\ No newline at end of file
+void AudioManager::UpdateListener(glm::vec3 position, glm::vec3 forward, glm::vec3 up) {
+    Command command;
+    command.type = Command::Type::SET_LISTENER;
+    command.position = position;
+    command.forward = forward;
+    command.up = up;
+    TrySend(command);
+}
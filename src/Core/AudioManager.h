@@ -1,32 +1,218 @@
 #pragma once
 #include <SFML/Audio.hpp>
+#include <array>
+#include <optional>
 #include <unordered_map>
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <glm/glm.hpp>
+#include "ResourcePool.h"
+#include "SoundBank.h"
+#include "SpscQueue.h"
 
+class SoundPropagation;
+
+enum class SoundPriority {
+    LOW,
+    NORMAL,
+    HIGH,
+    CRITICAL,
+    COUNT
+};
+
+struct SoundSettings {
+    SoundPriority priority = SoundPriority::NORMAL;
+    // Plays past the limit are dropped rather than cutting an instance off.
+    int maxInstances = 4;
+};
+
+// Sound effects play on a fixed set of logical voices, of which at most MAX_SOURCES are backed by a
+// real sf::Sound (an OpenAL source) at any time. Spatial voices too far away to hear go virtual:
+// they give up their source but keep counting playback time, and resume at the right offset when
+// they come back in range. When every voice is busy, the oldest voice of the lowest priority not
+// above the new one is stolen. Nothing is allocated after construction.
+//
+// With a sound bank loaded, effects found in it are decoded from the bank instead of their source
+// files. Short ones are decoded up front; longer ones are decoded when first played into a PCM
+// cache that evicts the least recently played idle sounds once it is over budget.
+//
+// With a SoundPropagation set, spatial voices are heard along their path through the maze rather
+// than through walls: positioned along the path's first leg, quieter and low-passed per closed door.
+//
+// Everything that touches SFML/OpenAL runs on the manager's own audio thread. Play, stop, listener,
+// music and propagation calls only push a fixed-size command onto a single-producer queue, so they
+// must all come from one thread (the simulation thread). Plays and listener updates are dropped if
+// the queue is ever full; commands that change state wait for room instead.
 class AudioManager {
 public:
+    static constexpr int MAX_VOICES = 48;
+    static constexpr int MAX_SOURCES = 16;
+    // Bank effects up to this much PCM stay decoded for as long as they are loaded.
+    static constexpr std::size_t RESIDENT_PCM_BYTES = 256 * 1024;
+    static constexpr int MAX_MUSIC = 4;
+
     AudioManager();
+    ~AudioManager();
+
+    // Call before loading the sounds it should serve. A missing bank is not an error.
+    bool LoadBank(const std::string& path);
+    void SetPcmCacheBudget(std::size_t bytes);
+    // Replaces the current propagation grid; voices already playing move over to the new one.
+    void SetPropagation(std::unique_ptr<SoundPropagation> propagation);
+    void SetPropagationTile(int x, int z, int tile);
 
-    void LoadSound(const std::string& name, const std::string& path);
+    // Decodes on the JobSystem; playing a sound that is still decoding waits for it. Loading a
+    // name that is already loaded adds a reference to the existing sound.
+    SoundHandle LoadSound(const std::string& name, const std::string& path, SoundSettings settings = {});
+    // Any thread. The buffer is freed by the next Update, after stopping whatever still uses it.
+    void ReleaseSound(SoundHandle handle);
 
 
-    void PlayGlobal(const std::string& name, float volume = 100.0f);
+    void PlayGlobal(SoundHandle sound, float volume = 100.0f);
 
 
-    void PlaySpatial(const std::string& name, glm::vec3 position, float volume = 100.0f, float attenuation = 10.0f);
+    void PlaySpatial(SoundHandle sound, glm::vec3 position, float volume = 100.0f, float attenuation = 10.0f);
 
     void UpdateListener(glm::vec3 position, glm::vec3 forward, glm::vec3 up);
-    void PlayMusic(const std::string& path, float volume = 50.0f);
+    // Opens the stream on the calling thread, so load music up front. -1 if it cannot be opened.
+    int LoadMusic(const std::string& path);
+    void PlayMusic(int music, float volume = 50.0f);
     void StopMusic();
+    // Effects only; the music keeps playing.
+    void StopSounds();
     void StopAllSounds();
 
 private:
-    std::unordered_map<std::string, sf::SoundBuffer> m_Buffers;
-    std::vector<std::unique_ptr<sf::Sound>> m_Sounds;
-    std::unique_ptr<sf::Music> m_Music;
+    struct SoundEntry {
+        SoundEntry(std::string name, std::future<std::unique_ptr<sf::SoundBuffer>> loading, SoundSettings settings,
+                   const SoundBankEntry* cached)
+            : name(std::move(name)), loading(std::move(loading)), settings(settings), cached(cached)
+        {
+            if (cached) duration = static_cast<float>(cached->frames) / cached->sampleRate;
+        }
+
+        std::string name;
+        std::future<std::unique_ptr<sf::SoundBuffer>> loading;
+        std::unique_ptr<sf::SoundBuffer> buffer;
+        SoundSettings settings;
+        float duration = 0.0f;
+        int instances = 0;
+        // Set for sounds decoded on demand into the PCM cache.
+        const SoundBankEntry* cached = nullptr;
+        std::uint64_t lastPlayed = 0;
+    };
+
+    // Active voices sit in one list per priority, oldest first; free ones in m_FreeVoices.
+    struct Voice {
+        SoundHandle sound;
+        const sf::SoundBuffer* buffer = nullptr;
+        SoundPriority priority = SoundPriority::NORMAL;
+        bool spatial = false;
+        glm::vec3 position{0.0f};
+        // Where the voice is heard from and how much of it gets there, along its propagation path.
+        glm::vec3 heardPosition{0.0f};
+        float transmission = 1.0f;
+        float cutoffHz = 0.0f;
+        int field = -1;
+        float volume = 100.0f;
+        float attenuation = 1.0f;
+        float elapsed = 0.0f;
+        float duration = 0.0f;
+        int source = -1;            // -1 while virtual
+        int prev = -1, next = -1;
+    };
+
+    // One-pole low-pass run by each source's effect processor on the audio thread.
+    struct LowPass {
+        std::atomic<float> alpha{1.0f};
+        std::atomic<bool> reset{true};
+        float state[2] = {0.0f, 0.0f};
+    };
+
+    struct Command {
+        enum class Type {
+            PLAY,
+            SET_LISTENER,
+            STOP_SOUNDS,
+            LOAD_MUSIC,
+            PLAY_MUSIC,
+            STOP_MUSIC,
+            SET_PROPAGATION,
+            SET_TILE,
+            SET_PCM_BUDGET
+        };
+
+        Type type = Type::PLAY;
+        SoundHandle sound;
+        bool spatial = false;
+        glm::vec3 position{0.0f};
+        glm::vec3 forward{0.0f};
+        glm::vec3 up{0.0f};
+        float volume = 100.0f;
+        float attenuation = 1.0f;
+        int index = -1;             // music slot, or tile type for SET_TILE
+        int x = 0, z = 0;
+        std::size_t bytes = 0;
+        // Ownership handed to the audio thread by LOAD_MUSIC and SET_PROPAGATION.
+        sf::Music* music = nullptr;
+        SoundPropagation* propagation = nullptr;
+    };
+
+    static constexpr std::size_t COMMAND_CAPACITY = 1024;
+    static constexpr int PRIORITY_COUNT = static_cast<int>(SoundPriority::COUNT);
+
+    mutable std::mutex m_NamesMutex;
+    std::unordered_map<std::string, SoundHandle> m_SoundNames;
+    // Declared before the sources so they are destroyed before the buffers they play.
+    ResourcePool<SoundEntry, SoundTag> m_SoundPool;
+
+    std::array<Voice, MAX_VOICES> m_Voices;
+    std::array<int, PRIORITY_COUNT> m_ActiveHead;
+    std::array<int, PRIORITY_COUNT> m_ActiveTail;
+    std::vector<int> m_FreeVoices;
+    // Outlives the sources whose effect processors use it.
+    std::array<LowPass, MAX_SOURCES> m_LowPass;
+    // Constructed with the first buffer they play, rebound with setBuffer afterwards.
+    std::array<std::optional<sf::Sound>, MAX_SOURCES> m_Sources;
+    std::vector<int> m_FreeSources;
+
+    std::unique_ptr<SoundBank> m_Bank;
+    std::size_t m_PcmBudget = 4 << 20;
+    std::size_t m_CachedPcmBytes = 0;
+    std::uint64_t m_PlayCount = 0;
+
+    glm::vec3 m_ListenerPos{0.0f};
+    std::unique_ptr<SoundPropagation> m_Propagation;
+    std::array<std::unique_ptr<sf::Music>, MAX_MUSIC> m_Music;
+    int m_MusicCount = 0;          // producer side
+
+    SpscQueue<Command, COMMAND_CAPACITY> m_Commands;
+    std::atomic<bool> m_Quit{false};
+    // Last, so it starts after and stops before everything it uses.
+    std::thread m_Thread;
+
+    void Send(const Command& command);
+    bool TrySend(const Command& command);
+    void AudioLoop();
+    void Execute(const Command& command);
+    void Update(float dt);
+    void StopVoices();
 
-    void CleanFinishedSounds();
-};
\ No newline at end of file
+    SoundEntry* FindEntry(SoundHandle sound);
+    void EvictPcm(std::size_t incoming);
+    void Play(SoundHandle sound, bool spatial, glm::vec3 position, float volume, float attenuation);
+    int AcquireVoice(SoundPriority priority);
+    void FreeVoice(int index);
+    void LinkVoice(int index);
+    void UnlinkVoice(int index);
+    bool IsAudible(const Voice& voice) const;
+    bool Realize(int index);
+    void Virtualize(int index);
+    void UpdatePath(Voice& voice);
+    void ApplyPath(const Voice& voice);
+};
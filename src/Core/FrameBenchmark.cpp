@@ -0,0 +1,236 @@
+#include "FrameBenchmark.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+    constexpr float FEET_Y = -0.5f;
+    constexpr float EYE_HEIGHT = 1.8f;
+    constexpr float BENCHMARK_FOV = 60.0f;
+    constexpr float FULL_BATTERY = 180.0f;
+    constexpr float FULL_STAMINA = 100.0f;
+
+    void PrintStats(const char* label, std::vector<float> samples) {
+        if (samples.empty()) {
+            std::cout << "  " << label << ": no samples" << std::endl;
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](float p) {
+            std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1) + 0.5f);
+            return samples[index];
+        };
+        double sum = 0.0;
+        for (float s : samples) sum += s;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  " << label << " ms: avg " << sum / samples.size()
+                  << "  min " << samples.front()
+                  << "  p50 " << percentile(0.5f)
+                  << "  p95 " << percentile(0.95f)
+                  << "  p99 " << percentile(0.99f)
+                  << "  max " << samples.back()
+                  << "  (" << samples.size() << " frames)" << std::endl;
+    }
+}
+
+FrameBenchmark::FrameBenchmark(const BenchmarkOptions& options)
+    : m_Options(options), m_SegmentFrames(60), m_FrameCount(0), m_GLFrames(0), m_Compared(0), m_Failed(0), m_Skipped(0)
+{
+    LoadPath(options.cameraPath);
+}
+
+void FrameBenchmark::LoadPath(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open camera path " + path);
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream stream(line);
+        std::string directive;
+        if (!(stream >> directive)) continue;
+
+        bool ok = true;
+        if (directive == "segment") {
+            ok = static_cast<bool>(stream >> m_SegmentFrames) && m_SegmentFrames > 0;
+        } else if (directive == "key") {
+            Key key;
+            ok = static_cast<bool>(stream >> key.position.x >> key.position.y >> key.yaw >> key.pitch);
+            if (ok) m_Keys.push_back(key);
+        } else if (directive == "capture") {
+            int frame;
+            while (stream >> frame) m_Captures.push_back(frame);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "ERROR: " << path << ":" << lineNumber << ": cannot parse '" << line << "'" << std::endl;
+        }
+    }
+
+    if (m_Keys.empty()) {
+        throw std::runtime_error("Camera path " + path + " has no keys");
+    }
+    m_FrameCount = m_Keys.size() == 1 ? 1 : static_cast<int>(m_Keys.size() - 1) * m_SegmentFrames + 1;
+    std::sort(m_Captures.begin(), m_Captures.end());
+    m_Captures.erase(std::remove_if(m_Captures.begin(), m_Captures.end(),
+        [this](int frame) { return frame < 0 || frame >= m_FrameCount; }), m_Captures.end());
+}
+
+bool FrameBenchmark::IsCaptureFrame(int frame) const {
+    return std::binary_search(m_Captures.begin(), m_Captures.end(), frame);
+}
+
+FrameSnapshot FrameBenchmark::MakeFrame(const FrameSnapshot& base, int frame) const {
+    int segment = std::min(frame / m_SegmentFrames, static_cast<int>(m_Keys.size()) - 1);
+    const Key& from = m_Keys[segment];
+    const Key& to = m_Keys[std::min(segment + 1, static_cast<int>(m_Keys.size()) - 1)];
+    float t = static_cast<float>(frame - segment * m_SegmentFrames) / m_SegmentFrames;
+
+    glm::vec2 position = glm::mix(from.position, to.position, t);
+    float yaw = glm::radians(glm::mix(from.yaw, to.yaw, t));
+    float pitch = glm::radians(glm::mix(from.pitch, to.pitch, t));
+
+    // Same basis Player::UpdateCameraVectors builds, with the head bob at rest.
+    glm::vec3 front = glm::normalize(glm::vec3(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch)));
+    glm::vec3 right = glm::normalize(glm::cross(front, glm::vec3(0.0f, 1.0f, 0.0f)));
+    glm::vec3 up = glm::normalize(glm::cross(right, front));
+
+    glm::vec3 feet(position.x, FEET_Y, position.y);
+    glm::vec3 eye = feet + glm::vec3(0.0f, EYE_HEIGHT, 0.0f);
+
+    FrameSnapshot out = base;
+    out.state = GameState::PLAYING;
+    out.interactPrompt.clear();
+    out.view = glm::lookAt(eye, eye + front, up);
+    out.viewPos = feet;
+    out.front = front;
+    out.flashlightPos = eye + right * 0.35f + front * 0.2f - up * 0.3f;
+    out.fov = BENCHMARK_FOV;
+    out.flashIntensity = 1.0f;
+    out.battery = FULL_BATTERY;
+    out.stamina = FULL_STAMINA;
+    out.hasRedKey = false;
+    out.time = frame * FRAME_DT;
+    // Drop the simulation's random flicker.
+    if (base.geometry) out.frameLights = base.geometry->dynamicLights;
+    return out;
+}
+
+void FrameBenchmark::RecordTiming(float cpuMs, float gpuMs) {
+    m_CpuMs.push_back(cpuMs);
+    if (gpuMs >= 0.0f) m_GpuMs.push_back(gpuMs);
+}
+
+void FrameBenchmark::RecordGLStats(const GLFrameStats& stats) {
+    m_GLTotals.drawCalls += stats.drawCalls;
+    m_GLTotals.triangles += stats.triangles;
+    m_GLTotals.programBinds += stats.programBinds;
+    m_GLTotals.textureBinds += stats.textureBinds;
+    m_GLTotals.stateChanges += stats.stateChanges;
+    m_GLTotals.uniformCalls += stats.uniformCalls;
+    m_GLTotals.bytesUploaded += stats.bytesUploaded;
+    m_GLFrames++;
+}
+
+std::string FrameBenchmark::GoldenPath(int frame) const {
+    std::string level = std::filesystem::path(m_Options.levelPath).stem().string();
+    std::ostringstream name;
+    name << level << "_" << m_Options.width << "x" << m_Options.height << "_" << std::setw(4) << std::setfill('0') << frame << ".png";
+    return (std::filesystem::path(m_Options.goldenDir) / name.str()).string();
+}
+
+void FrameBenchmark::CheckFrame(int frame, const std::vector<std::uint8_t>& pixels) {
+    const sf::Vector2u size(static_cast<unsigned int>(m_Options.width), static_cast<unsigned int>(m_Options.height));
+    sf::Image actual(size, pixels.data());
+    std::string goldenPath = GoldenPath(frame);
+
+    if (m_Options.updateGolden) {
+        std::filesystem::create_directories(m_Options.goldenDir);
+        if (!actual.saveToFile(goldenPath)) {
+            std::cerr << "ERROR: Failed to write " << goldenPath << std::endl;
+            m_Failed++;
+        } else {
+            std::cout << "Wrote golden " << goldenPath << std::endl;
+        }
+        return;
+    }
+
+    if (!std::filesystem::exists(goldenPath)) {
+        std::cout << "Frame " << frame << ": SKIP  no golden " << goldenPath << " (run with --update-golden)" << std::endl;
+        m_Skipped++;
+        return;
+    }
+
+    m_Compared++;
+    sf::Image golden;
+    if (!golden.loadFromFile(goldenPath) || golden.getSize() != size) {
+        std::cerr << "ERROR: Unreadable or mismatched golden " << goldenPath << " (run with --update-golden)" << std::endl;
+        m_Failed++;
+        return;
+    }
+
+    const std::uint8_t* expected = golden.getPixelsPtr();
+    std::size_t pixelCount = static_cast<std::size_t>(size.x) * size.y;
+    std::size_t differing = 0;
+    double totalError = 0.0;
+    for (std::size_t i = 0; i < pixelCount; i++) {
+        int worst = 0;
+        for (int c = 0; c < 3; c++) {
+            int diff = std::abs(static_cast<int>(pixels[i * 4 + c]) - static_cast<int>(expected[i * 4 + c]));
+            worst = std::max(worst, diff);
+            totalError += diff;
+        }
+        if (worst > PIXEL_THRESHOLD) differing++;
+    }
+
+    float fraction = static_cast<float>(differing) / pixelCount;
+    bool pass = fraction <= m_Options.tolerance;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Frame " << frame << ": " << (pass ? "PASS" : "FAIL")
+              << "  differing " << fraction * 100.0f << "%"
+              << "  mean error " << totalError / (pixelCount * 3.0) << std::endl;
+
+    if (!pass) {
+        m_Failed++;
+        std::filesystem::create_directories(m_Options.outputDir);
+        std::string actualPath = (std::filesystem::path(m_Options.outputDir) / std::filesystem::path(goldenPath).filename()).string();
+        if (actual.saveToFile(actualPath)) std::cout << "  actual frame written to " << actualPath << std::endl;
+    }
+}
+
+int FrameBenchmark::Report() const {
+    std::cout << "Benchmark " << m_Options.levelPath << " @ " << m_Options.width << "x" << m_Options.height << std::endl;
+    PrintStats("CPU", m_CpuMs);
+    PrintStats("GPU", m_GpuMs);
+    if (m_GLFrames > 0) {
+        const GLFrameStats& t = m_GLTotals;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  GL per frame: draws " << static_cast<float>(t.drawCalls) / m_GLFrames
+                  << "  triangles " << static_cast<double>(t.triangles) / m_GLFrames
+                  << "  program binds " << static_cast<float>(t.programBinds) / m_GLFrames
+                  << "  texture binds " << static_cast<float>(t.textureBinds) / m_GLFrames
+                  << "  state " << static_cast<float>(t.stateChanges) / m_GLFrames
+                  << "  uniforms " << static_cast<float>(t.uniformCalls) / m_GLFrames
+                  << "  upload KiB " << static_cast<double>(t.bytesUploaded) / 1024.0 / m_GLFrames << std::endl;
+    }
+    if (!m_Options.updateGolden) {
+        std::cout << "  Golden images: " << (m_Compared - m_Failed) << "/" << m_Compared << " passed";
+        if (m_Skipped > 0) std::cout << ", " << m_Skipped << " skipped without a golden";
+        std::cout << std::endl;
+    }
+    return m_Failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "FrameSnapshot.h"
+#include "../Graphics/GLStats.h"
+
+struct BenchmarkOptions {
+    std::string levelPath = "assets/levels/level1.txt";
+    std::string cameraPath = "assets/benchmarks/level1.path";
+    std::string goldenDir = "assets/benchmarks/golden";
+    // Mismatching captures are written here for inspection.
+    std::string outputDir = "benchmark_out";
+    int width = 1280;
+    int height = 720;
+    int warmupFrames = 30;
+    bool updateGolden = false;
+    // Fraction of pixels allowed to differ from the golden image by more than PIXEL_THRESHOLD.
+    float tolerance = 0.005f;
+};
+
+// Scripted, deterministic camera run for the headless renderer. Reads a keyframed camera path,
+// turns each frame into a FrameSnapshot, collects CPU/GPU frame times and checks captured frames
+// against golden images.
+//
+// Path file, one directive per line ('#' starts a comment):
+//   segment <frames>             frames between consecutive keys (default 60)
+//   key <x> <z> <yaw> <pitch>    feet position on the floor, angles in degrees as in Player
+//   capture <frame> [<frame>...] frames compared against golden images
+class FrameBenchmark {
+public:
+    static constexpr float FRAME_DT = 1.0f / 60.0f;
+    static constexpr int PIXEL_THRESHOLD = 16;
+
+    explicit FrameBenchmark(const BenchmarkOptions& options);
+
+    const BenchmarkOptions& GetOptions() const { return m_Options; }
+    int GetFrameCount() const { return m_FrameCount; }
+    bool IsCaptureFrame(int frame) const;
+
+    // base supplies level content (geometry, pickups, lights); camera, time and HUD values are
+    // overwritten from the path so every run renders identical frames.
+    FrameSnapshot MakeFrame(const FrameSnapshot& base, int frame) const;
+
+    // gpuMs may be negative while the timer queries are still in flight.
+    void RecordTiming(float cpuMs, float gpuMs);
+    void RecordGLStats(const GLFrameStats& stats);
+
+    // pixels are RGBA8, top row first. Writes the golden image instead when updateGolden is set.
+    // A frame without a golden image is skipped, not failed.
+    void CheckFrame(int frame, const std::vector<std::uint8_t>& pixels);
+
+    // Prints timing statistics and image results; returns the process exit code.
+    int Report() const;
+
+private:
+    struct Key {
+        glm::vec2 position;
+        float yaw, pitch;
+    };
+
+    void LoadPath(const std::string& path);
+    std::string GoldenPath(int frame) const;
+
+    BenchmarkOptions m_Options;
+    std::vector<Key> m_Keys;
+    std::vector<int> m_Captures;
+    int m_SegmentFrames;
+    int m_FrameCount;
+
+    std::vector<float> m_CpuMs;
+    std::vector<float> m_GpuMs;
+    GLFrameStats m_GLTotals;
+    int m_GLFrames;
+    int m_Compared;
+    int m_Failed;
+    int m_Skipped;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../Graphics/GridLight.h"
+#include "../Graphics/LightmapBaker.h"
+#include "../Graphics/MazeGeometry.h"
+#include "../Entities/ExploredMap.h"
+
+enum class GameState {
+    MENU,
+    PLAYING,
+    PAUSED,
+    GAME_OVER,
+    WIN
+};
+
+// Everything the render thread needs for one frame, written by the Simulation and read-only afterwards.
+struct FrameSnapshot {
+    GameState state = GameState::MENU;
+    int pauseSelection = 0;
+    std::string interactPrompt;
+
+    glm::mat4 view{1.0f};
+    glm::vec3 viewPos{0.0f};
+    glm::vec3 front{0.0f, 0.0f, -1.0f};
+    glm::vec3 flashlightPos{0.0f};
+    float fov = 60.0f;
+    float flashIntensity = 0.0f;
+
+    float battery = 0.0f;
+    float stamina = 0.0f;
+    bool hasRedKey = false;
+
+    float time = 0.0f;
+    glm::vec3 paperPos{0.0f};
+    std::vector<glm::vec3> keyPositions;
+    std::vector<GridLight> frameLights;
+
+    // Shared and immutable; the renderer re-uploads when mapRevision or levelSerial changes.
+    // Revisions are per Map, so only levelSerial tells two levels apart.
+    std::shared_ptr<const MazeGeometry> geometry;
+    std::shared_ptr<const LightmapData> lightmap;
+    unsigned int mapRevision = 0;
+    unsigned int levelSerial = 0;
+    // Only what changed since the previous snapshot; every snapshot must reach the renderer.
+    MinimapUpdate minimap;
+
+    // Window requests, applied by the main thread.
+    bool cursorGrabbed = false;
+    bool closeRequested = false;
+
+    float simMs = 0.0f;
+};
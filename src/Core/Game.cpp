@@ -1,58 +1,111 @@
 #include "Game.h"
 #include "ResourceManager.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "../Graphics/Frustum.h"
+#include "../Graphics/GLStats.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "../Graphics/MazeGeometry.h"
+
+namespace {
+    constexpr int LIGHT_GRID_TEXTURE_UNIT = 5;
+    constexpr int LIGHTMAP_TEXTURE_UNIT = 8;
+    constexpr float EMISSIVE_BOOST = 1.5f;
+    constexpr const char* LEVEL_PATH = "assets/levels/level1.txt";
+    // One level file per line, relative to the campaign file; blank lines and '#' comments are skipped.
+    constexpr const char* CAMPAIGN_PATH = "assets/levels/campaign.txt";
+    // Main-thread time per frame spent copying decoded textures to the GPU while assets stream in.
+    constexpr float TEXTURE_UPLOAD_BUDGET_MS = 2.0f;
+
+    std::vector<std::string> ReadCampaign(const std::string& path) {
+        std::vector<std::string> levels;
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Campaign file not found: " << path << ", playing " << LEVEL_PATH << std::endl;
+            return {LEVEL_PATH};
+        }
+
+        std::filesystem::path directory = std::filesystem::path(path).parent_path();
+        std::string line;
+        while (std::getline(file, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') continue;
+            levels.push_back((directory / line).generic_string());
+        }
+        if (levels.empty()) levels.push_back(LEVEL_PATH);
+        return levels;
+    }
+}
 
-Game::Game()
-    : m_State(GameState::MENU),
-      m_UIText(m_Font),
-      m_CenterText(m_Font),
-      m_InteractText(m_Font),
-      m_PauseMenuSelection(0),
-      m_AudioStopped(false)
+Game::Game(const RenderSettings& renderSettings, const BenchmarkOptions* benchmark)
+    : m_Settings(renderSettings),
+      m_CursorGrabbed(false),
+      m_ShowGLStats(false),
+      m_MapRevision(0),
+      m_LevelSerial(0),
+      m_LightmapTex(0),
+      m_LightmapBlock(LightmapBaker::BLOCK_SIZE),
+      m_ParticleTime(0.0f)
 {
-    sf::ContextSettings settings;
-    settings.depthBits = 24;
-    settings.majorVersion = 3;
-    settings.minorVersion = 3;
-    settings.antiAliasingLevel = 8;
-    settings.attributeFlags = sf::ContextSettings::Default;
-
-    sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
-    m_Window.create(desktop, "3D Maze - Mahmoud Mamdouh", sf::Style::Default, sf::State::Fullscreen, settings);
-    m_Window.setFramerateLimit(165);
-    m_Window.setMouseCursorVisible(true);
-
-    std::random_device rd;
-    m_RNG = std::mt19937(rd());
-
-    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(sf::Context::getFunction))) {
-        throw std::runtime_error("Failed to initialize GLAD");
+    MAZE_PROFILE_THREAD("Main");
+    MAZE_PROFILE_SCOPE("Game::Game");
+    // Workers start before anything below queues level, texture or sound loads onto them.
+    JobSystem::Shared();
+    std::vector<std::string> levelPaths = benchmark ? std::vector<std::string>{benchmark->levelPath} : ReadCampaign(CAMPAIGN_PATH);
+
+    if (benchmark) {
+        m_Headless = std::make_unique<HeadlessContext>(benchmark->width, benchmark->height);
+        m_FramebufferSize = sf::Vector2u(static_cast<unsigned int>(benchmark->width), static_cast<unsigned int>(benchmark->height));
+        // Fixed quality so timings and golden images are comparable between runs.
+        m_Settings.adaptiveQuality = false;
+    } else {
+        sf::ContextSettings settings;
+        settings.depthBits = 24;
+        settings.majorVersion = 3;
+        settings.minorVersion = 3;
+        // MSAA lives in the PostProcessor's offscreen target, where the QualityGovernor can scale it.
+        settings.antiAliasingLevel = 0;
+        settings.attributeFlags = sf::ContextSettings::Default;
+
+        sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+        m_Window.create(desktop, "3D Maze - Mahmoud Mamdouh", sf::Style::Default, sf::State::Fullscreen, settings);
+        m_Window.setFramerateLimit(165);
+        m_Window.setMouseCursorVisible(true);
+        m_FramebufferSize = desktop.size;
+
+        if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(sf::Context::getFunction))) {
+            throw std::runtime_error("Failed to initialize GLAD");
+        }
     }
+    GLStats::Install();
+
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    LightmapBaker::SetMaxTextureSize(maxTextureSize);
 
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    m_Shader = std::make_unique<Shader>();
-    m_Shader->Load("assets/shaders/shader.vert", "assets/shaders/shader.frag");
-
-    m_InstancedShader = std::make_unique<Shader>();
-    m_InstancedShader->Load("assets/shaders/instanced.vert", "assets/shaders/shader.frag");
+    ResourceManager::Init();
+    m_Shader = ResourceManager::LoadShader("assets/shaders/shader.vert", "assets/shaders/shader.frag");
+    m_InstancedShader = ResourceManager::LoadShader("assets/shaders/instanced.vert", "assets/shaders/shader.frag");
 
     m_Renderer = std::make_unique<Renderer>();
-    m_Audio = std::make_unique<AudioManager>();
 
-    m_PostProcessor = std::make_unique<PostProcessor>(desktop.size.x, desktop.size.y);
-
-    m_Map = std::make_unique<Map>();
-
-    if (!m_Map->LoadLevel("assets/levels/level1.txt", m_PlayerStartPos, m_PaperPos)) {
-        throw std::runtime_error("FATAL: Failed to load assets/levels/level1.txt");
-    }
+    m_PostProcessor = std::make_unique<PostProcessor>(m_FramebufferSize.x, m_FramebufferSize.y);
+    m_PostProcessor->SetQuality(m_Settings.renderScale, m_Settings.msaaSamples);
+    if (m_Headless) m_PostProcessor->SetOutputFramebuffer(m_Headless->GetFramebuffer());
+    m_GpuTimer = std::make_unique<GpuTimer>();
 
-    m_Player = std::make_unique<Player>(m_PlayerStartPos);
+    ResourceManager::SetTextureBudget(static_cast<std::size_t>(m_Settings.textureBudgetMB) << 20);
+    m_Simulation = std::make_unique<Simulation>(std::move(levelPaths), static_cast<std::size_t>(m_Settings.soundCacheKB) << 10);
 
     m_FloorTex = ResourceManager::LoadTexture("floor", "assets/textures/floor/fabricfloor.png");
     m_WallTex = ResourceManager::LoadTexture("wall", "assets/textures/wall/PaintedPlaster.png");
@@ -62,456 +115,535 @@ Game::Game()
     m_LockedDoorTex = ResourceManager::LoadTexture("locked_door", "assets/textures/door/DoorLocked.png");
     m_KeyTex = ResourceManager::LoadTexture("key", "assets/textures/key/KeyCard.png");
 
-    m_Audio->LoadSound("footstep", "assets/sounds/footstep.wav");
-    m_Audio->LoadSound("hum", "assets/sounds/fluorescent_hum.wav");
-    m_Audio->LoadSound("win", "assets/sounds/win.wav");
-    m_Audio->LoadSound("lose", "assets/sounds/lose.wav");
-    m_Audio->LoadSound("flicker", "assets/sounds/flicker.wav");
-    m_Audio->LoadSound("click", "assets/sounds/flashlight_click.wav");
-
-    m_Audio->PlayMusic("assets/sounds/ambience.ogg", 25.0f);
-    m_Audio->PlaySpatial("hum", m_PaperPos, 100.0f, 1.5f);
-
-    m_WallTransforms.clear();
-    for (int x = 0; x < m_Map->GetWidth(); x++) {
-        for (int z = 0; z < m_Map->GetHeight(); z++) {
-            if (m_Map->GetTile(x, z) == 1 || m_Map->GetTile(x, z) == 9) {
-                glm::mat4 model = glm::mat4(1.0f);
-                model = glm::translate(model, glm::vec3(x + 0.5f, 1.5f, z + 0.5f));
-                model = glm::scale(model, glm::vec3(1.0f, 4.0f, 1.0f));
-                m_WallTransforms.push_back(model);
-            }
-        }
+    m_DepthShader = ResourceManager::LoadShader("assets/shaders/instanced.vert", "assets/shaders/depth.frag");
+
+    m_MazeChunks = std::make_unique<MazeChunks>(*m_Renderer);
+    m_Particles = std::make_unique<ParticleSystem>();
+
+    if (GpuCuller::IsSupported()) {
+        m_GpuCuller = std::make_unique<GpuCuller>(*m_Renderer);
+        m_GpuShader = ResourceManager::LoadShader("assets/shaders/instanced.vert", "assets/shaders/shader.frag", "#define MATERIAL_TEXTURES\n");
+        m_Settings.gpuCulling = true;
     }
-    m_Renderer->SetupInstancedWalls(m_WallTransforms);
+    m_LightGrid = std::make_unique<LightGrid>();
 
     if (!m_Font.openFromFile("assets/textures/Font/font.TTF")) {
         std::cerr << "CRITICAL: Font not found!" << std::endl;
     }
-    m_UIText.setCharacterSize(24); m_UIText.setFillColor(sf::Color::White);
-    m_CenterText.setCharacterSize(40); m_CenterText.setFillColor(sf::Color::Red);
-    m_InteractText.setCharacterSize(30); m_InteractText.setFillColor(sf::Color::Yellow);
+    SetupHud();
+    m_Minimap = std::make_unique<Minimap>();
 
-    sf::Vector2u size = m_Window.getSize();
-    m_InteractText.setPosition({static_cast<float>(size.x)/2.0f - 100.0f, static_cast<float>(size.y)/2.0f + 50.0f});
-    m_InteractText.setString("");
+    m_SimThread = std::make_unique<SimulationThread>(*m_Simulation);
 }
 
 Game::~Game() {
+    m_SimThread.reset();
+    glDeleteTextures(1, &m_LightmapTex);
+    for (TextureHandle texture : {m_FloorTex, m_WallTex, m_CeilingTex, m_PaperTex, m_DoorTex, m_LockedDoorTex, m_KeyTex}) {
+        ResourceManager::ReleaseTexture(texture);
+    }
+    for (ShaderHandle shader : {m_Shader, m_InstancedShader, m_GpuShader, m_DepthShader}) {
+        ResourceManager::ReleaseShader(shader);
+    }
     ResourceManager::Clear();
 }
 
+// Two-stage pipeline: while the worker simulates frame N+1 from freshly captured input,
+// the main thread submits frame N from its snapshot. Frame N+1 is displayed one loop later.
 void Game::Run() {
+    m_SimThread->Kick(InputState(), 0.0f);
+    const FrameSnapshot* frame = &m_SimThread->Wait();
+
     while (m_Window.isOpen()) {
+        MAZE_PROFILE_SCOPE("Frame");
         float dt = m_DeltaClock.restart().asSeconds();
         if (dt > 0.1f) dt = 0.1f;
-        ProcessEvents();
-        Update(dt);
-        Render();
+        m_FrameClock.restart();
+
+        InputState input = ProcessEvents(*frame);
+        if (!m_Window.isOpen()) break;
+
+        m_SimThread->Kick(input, dt);
+        ResourceManager::PumpUploads(TEXTURE_UPLOAD_BUDGET_MS);
+        m_PostProcessor->Update(dt);
+        Render(*frame);
+
+        {
+            MAZE_PROFILE_SCOPE("WaitForSimulation");
+            frame = &m_SimThread->Wait();
+        }
+        ApplyWindowRequests(*frame);
+    }
+}
+
+// One frame from the level's simulation seeds pickups and lights; after that the camera path drives
+// everything, so frames are identical between runs. Warmup frames repeat frame 0 and are not timed.
+int Game::RunBenchmark(FrameBenchmark& benchmark) {
+    if (!m_Simulation->FinishLoading()) return 1;
+    ResourceManager::FinishLoading();
+    m_SimThread->Kick(InputState(), 0.0f);
+    const FrameSnapshot base = m_SimThread->Wait();
+
+    std::vector<std::uint8_t> pixels;
+    const int warmup = benchmark.GetOptions().warmupFrames;
+    for (int i = -warmup; i < benchmark.GetFrameCount(); i++) {
+        int index = std::max(i, 0);
+        FrameSnapshot frame = benchmark.MakeFrame(base, index);
+
+        m_FrameClock.restart();
+        m_PostProcessor->Update(i > 0 ? FrameBenchmark::FRAME_DT : 0.0f);
+        Render(frame);
+        glFlush();
+        float cpuMs = m_FrameClock.getElapsedTime().asSeconds() * 1000.0f;
+
+        if (i < 0) continue;
+        benchmark.RecordTiming(cpuMs, m_GpuTimer->GetLastMs());
+        if (GLStats::IsAvailable()) benchmark.RecordGLStats(GLStats::GetLastFrame());
+        if (benchmark.IsCaptureFrame(index)) {
+            m_Headless->ReadPixels(pixels);
+            benchmark.CheckFrame(index, pixels);
+        }
     }
+    return benchmark.Report();
 }
 
-void Game::ProcessEvents() {
+InputState Game::ProcessEvents(const FrameSnapshot& frame) {
+    MAZE_PROFILE_SCOPE("Game::ProcessEvents");
+    InputState input;
+
     while (const std::optional event = m_Window.pollEvent()) {
         if (event->is<sf::Event::Closed>()) m_Window.close();
 
         if (const auto* resizeEvent = event->getIf<sf::Event::Resized>()) {
              glViewport(0, 0, static_cast<GLsizei>(resizeEvent->size.x), static_cast<GLsizei>(resizeEvent->size.y));
              m_PostProcessor->Resize(static_cast<int>(resizeEvent->size.x), static_cast<int>(resizeEvent->size.y));
+             m_FramebufferSize = resizeEvent->size;
         }
 
         if (const auto* keyEvent = event->getIf<sf::Event::KeyPressed>()) {
-            if (keyEvent->scancode == sf::Keyboard::Scan::Escape) {
-                if (m_State == GameState::PLAYING) {
-                    m_State = GameState::PAUSED;
-                    m_Audio->PlayGlobal("click", 50.0f);
-                    m_Window.setMouseCursorVisible(true); m_Window.setMouseCursorGrabbed(false);
-                } else if (m_State == GameState::PAUSED) {
-                    m_State = GameState::PLAYING;
-                    m_Audio->PlayGlobal("click", 50.0f);
-                    m_Window.setMouseCursorVisible(false); m_Window.setMouseCursorGrabbed(true);
-                }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F1 && m_GpuCuller) {
+                m_Settings.gpuCulling = !m_Settings.gpuCulling;
+                std::cout << "GPU-driven culling: " << (m_Settings.gpuCulling ? "ON" : "OFF") << std::endl;
             }
-
-            if (m_State == GameState::PAUSED) {
-                if (keyEvent->scancode == sf::Keyboard::Scan::W || keyEvent->scancode == sf::Keyboard::Scan::Up) {
-                    m_PauseMenuSelection--;
-                    if (m_PauseMenuSelection < 0) m_PauseMenuSelection = 2;
-                    m_Audio->PlayGlobal("click", 50.0f);
-                }
-                if (keyEvent->scancode == sf::Keyboard::Scan::S || keyEvent->scancode == sf::Keyboard::Scan::Down) {
-                    m_PauseMenuSelection++;
-                    if (m_PauseMenuSelection > 2) m_PauseMenuSelection = 0;
-                    m_Audio->PlayGlobal("click", 50.0f);
-                }
-                if (keyEvent->scancode == sf::Keyboard::Scan::Enter) {
-                    m_Audio->PlayGlobal("click", 80.0f);
-                    if (m_PauseMenuSelection == 0) {
-                        m_State = GameState::PLAYING;
-                        m_Window.setMouseCursorVisible(false); m_Window.setMouseCursorGrabbed(true);
-                    }
-                    else if (m_PauseMenuSelection == 1) {
-                        ResetGame();
-                    }
-                    else if (m_PauseMenuSelection == 2) {
-                        m_Window.close();
-                    }
-                }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F2) {
+                m_Settings.depthPrepass = !m_Settings.depthPrepass;
+                std::cout << "Depth prepass: " << (m_Settings.depthPrepass ? "ON" : "OFF") << std::endl;
             }
-
-            if ((m_State == GameState::MENU || m_State == GameState::GAME_OVER || m_State == GameState::WIN) &&
-                keyEvent->scancode == sf::Keyboard::Scan::Enter) {
-                ResetGame();
+            if (keyEvent->scancode == sf::Keyboard::Scan::F3) {
+                m_Settings.frontToBackSort = !m_Settings.frontToBackSort;
+                std::cout << "Front-to-back chunk sort: " << (m_Settings.frontToBackSort ? "ON" : "OFF") << std::endl;
             }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F4) {
+                m_Settings.adaptiveQuality = !m_Settings.adaptiveQuality;
+                std::cout << "Adaptive quality: " << (m_Settings.adaptiveQuality ? "ON" : "OFF") << std::endl;
+            }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F5) {
+                PostProcessGraph& graph = m_PostProcessor->GetGraph();
+                graph.SetEffectEnabled("bloom", !graph.IsEffectEnabled("bloom"));
+                std::cout << "Bloom: " << (graph.IsEffectEnabled("bloom") ? "ON" : "OFF") << std::endl;
+            }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F7) {
+                if (Profiler::IsAvailable()) Profiler::WriteTrace("maze_trace.json");
+                else std::cout << "Profiler needs a build with -DMAZE_PROFILER=ON" << std::endl;
+            }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F6) {
+                if (GLStats::IsAvailable()) m_ShowGLStats = !m_ShowGLStats;
+                else std::cout << "GL stats overlay needs a build with -DMAZE_GL_STATS=ON" << std::endl;
+            }
+            if (keyEvent->scancode == sf::Keyboard::Scan::F8) {
+                m_Settings.particles = !m_Settings.particles;
+                std::cout << "Particles: " << (m_Settings.particles ? "ON" : "OFF") << std::endl;
+            }
+
+            input.pressedKeys.push_back(keyEvent->scancode);
         }
     }
+
+    input.forward = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::W);
+    input.back = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::S);
+    input.left = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::A);
+    input.right = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::D);
+    input.sprint = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::LShift);
+    input.jump = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Space);
+    input.flashlight = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::F);
+    input.interact = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::E);
+    input.mouseLeft = sf::Mouse::isButtonPressed(sf::Mouse::Button::Left);
+
+    // Mouse look recenters the cursor, so it stays here on the thread that owns the window.
+    if (frame.state == GameState::PLAYING && m_Window.hasFocus()) {
+        sf::Vector2i mousePos = sf::Mouse::getPosition(m_Window);
+        sf::Vector2u size = m_Window.getSize();
+        sf::Vector2i center(size.x / 2, size.y / 2);
+        input.mouseDelta = glm::vec2(mousePos.x - center.x, center.y - mousePos.y);
+        sf::Mouse::setPosition(center, m_Window);
+    }
+
+    return input;
 }
 
-void Game::ResetGame() {
-    m_State = GameState::PLAYING;
-    m_Player->Reset(m_PlayerStartPos);
-    m_Window.setMouseCursorVisible(false); m_Window.setMouseCursorGrabbed(true);
+void Game::ApplyWindowRequests(const FrameSnapshot& frame) {
+    if (frame.closeRequested) m_Window.close();
 
-    m_Audio->StopAllSounds();
-    m_AudioStopped = false;
-    m_Audio->PlayMusic("assets/sounds/ambience.ogg", 25.0f);
-    m_Audio->PlaySpatial("hum", m_PaperPos, 100.0f, 1.5f);
+    if (frame.cursorGrabbed != m_CursorGrabbed) {
+        m_CursorGrabbed = frame.cursorGrabbed;
+        m_Window.setMouseCursorVisible(!m_CursorGrabbed);
+        m_Window.setMouseCursorGrabbed(m_CursorGrabbed);
+    }
 }
 
-void Game::Update(float dt) {
-    m_Audio->UpdateListener(m_Player->GetPosition(), m_Player->GetFront(), glm::vec3(0,1,0));
-    m_PostProcessor->Update(dt);
+void Game::Render(const FrameSnapshot& frame) {
+    MAZE_PROFILE_SCOPE("Game::Render");
+    sf::Vector2u windowSize = m_FramebufferSize;
 
-    if (m_State == GameState::GAME_OVER || m_State == GameState::WIN) {
-        if (!m_AudioStopped) {
-            m_Audio->StopAllSounds();
-            m_AudioStopped = true;
-            if (m_State == GameState::WIN) m_Audio->PlayGlobal("win", 100.0f);
-            if (m_State == GameState::GAME_OVER) m_Audio->PlayGlobal("lose", 100.0f);
-        }
+    bool usePostProcessing = (frame.state == GameState::PLAYING || frame.state == GameState::PAUSED);
+    if (frame.levelSerial != m_LevelSerial) EnterLevel(frame);
+
+    if (usePostProcessing) {
+        m_GpuTimer->Begin();
+        m_PostProcessor->BeginRender();
     } else {
-        if (m_State == GameState::PLAYING) m_AudioStopped = false;
+        glBindFramebuffer(GL_FRAMEBUFFER, m_Headless ? m_Headless->GetFramebuffer() : 0);
+        glClearColor(0.005f, 0.005f, 0.01f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     }
 
-    if (m_State == GameState::PLAYING) {
-        m_Player->HandleInput(m_Window, dt, *m_Audio);
-        m_Player->Update(dt, *m_Map, *m_Audio);
+    if (usePostProcessing) {
+        MAZE_PROFILE_GPU_SCOPE("Scene");
+        glm::mat4 projection = glm::perspective(glm::radians(frame.fov),
+            static_cast<float>(windowSize.x) / static_cast<float>(windowSize.y), 0.01f, 100.0f);
 
-        if (m_Player->GetBattery() < 20.0f && m_Player->GetBattery() > 0.0f && m_Player->IsFlashlightOn()) {
-            std::uniform_int_distribution<int> chance(0, 40);
-            if (chance(m_RNG) == 0) {
-                m_Audio->PlayGlobal("flicker", 60.0f);
-            }
+        const glm::mat4& view = frame.view;
+
+        if (frame.mapRevision != m_MapRevision) UploadMazeGeometry(frame.geometry, frame.mapRevision);
+        m_LightGrid->SetLights(frame.frameLights);
+
+        bool gpuPath = m_Settings.gpuCulling && m_GpuCuller;
+        std::array<unsigned int, MATERIAL_COUNT> materialTextures = {
+            ResourceManager::GetTextureId(m_WallTex), ResourceManager::GetTextureId(m_FloorTex),
+            ResourceManager::GetTextureId(m_CeilingTex), ResourceManager::GetTextureId(m_DoorTex),
+            ResourceManager::GetTextureId(m_LockedDoorTex)};
+        Shader& shader = *ResourceManager::GetShader(m_Shader);
+        Shader& instancedShader = *ResourceManager::GetShader(m_InstancedShader);
+        Shader& depthShader = *ResourceManager::GetShader(m_DepthShader);
+        Shader* gpuShader = ResourceManager::GetShader(m_GpuShader);
+        const std::vector<int>* chunkOrder = nullptr;
+        Frustum frustum = Frustum::FromMatrix(projection * view);
+        NoteTextureUses(frame, frustum, windowSize.y / (2.0f * std::tan(glm::radians(frame.fov) * 0.5f)));
+
+        if (gpuPath) {
+            m_GpuCuller->Cull(projection * view, frame.viewPos, FogCullDistance(m_Settings.fogDensity));
+        } else {
+            chunkOrder = &m_MazeChunks->GatherVisible(frustum, frame.viewPos, m_Settings.frontToBackSort);
         }
 
-        m_InteractText.setString("");
-        auto ray = m_Map->CastRay(m_Player->GetEyePosition(), m_Player->GetFront(), 3.0f);
+        if (m_Settings.depthPrepass) {
+            glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            depthShader.Use();
+            depthShader.SetMat4("projection", projection);
+            depthShader.SetMat4("view", view);
 
-        if (ray.hit) {
-            if (ray.tileType == 2) {
-                m_InteractText.setString("[E] Open Door");
-                if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::E)) {
-                    m_Map->SetTile(ray.tileX, ray.tileZ, 3);
-                    m_Audio->PlaySpatial("footstep", {ray.tileX, 1.5, ray.tileZ});
-                }
-            }
-            else if (ray.tileType == 5) {
-                if (m_Player->HasRedKey()) {
-                    m_InteractText.setString("[E] UNLOCK Door");
-                    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::E)) {
-                        m_Map->SetTile(ray.tileX, ray.tileZ, 3);
-                        m_Audio->PlaySpatial("footstep", {ray.tileX, 1.5, ray.tileZ});
-                    }
-                } else {
-                    m_InteractText.setString("LOCKED [Requires Access Key]");
-                }
-            }
-        }
+            if (gpuPath) m_GpuCuller->DrawDepth(depthShader);
+            else m_MazeChunks->Draw(depthShader, *chunkOrder, nullptr);
 
-        int playerX = static_cast<int>(std::round(m_Player->GetPosition().x - 0.5f));
-        int playerZ = static_cast<int>(std::round(m_Player->GetPosition().z - 0.5f));
-        if (m_Map->GetTile(playerX, playerZ) == 4) {
-            m_Player->PickUpRedKey();
-            m_Map->SetTile(playerX, playerZ, 0);
-            m_Audio->PlayGlobal("win", 70.0f);
-            m_UIText.setString("Acquired ACCESS KEY");
+            glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+            glDepthFunc(GL_EQUAL);
+            glDepthMask(GL_FALSE);
         }
 
-        if (glm::distance(m_Player->GetPosition(), m_PaperPos) < 1.0f) {
-            m_State = GameState::WIN;
-            m_Audio->StopAllSounds();
-            m_Audio->PlayGlobal("win", 100.0f);
-            m_Window.setMouseCursorVisible(true); m_Window.setMouseCursorGrabbed(false);
+        if (gpuPath) {
+            ApplySceneUniforms(*gpuShader, frame, projection);
+            m_GpuCuller->Draw(*gpuShader, materialTextures);
+        } else {
+            ApplySceneUniforms(instancedShader, frame, projection);
+            m_MazeChunks->Draw(instancedShader, *chunkOrder, &materialTextures);
         }
-        if (m_Player->IsDead()) {
-            m_State = GameState::GAME_OVER;
-            m_Audio->StopAllSounds();
-            m_Audio->PlayGlobal("lose", 100.0f);
-            m_Window.setMouseCursorVisible(true); m_Window.setMouseCursorGrabbed(false);
+
+        if (m_Settings.depthPrepass) {
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
         }
-    }
-}
 
-void Game::Render() {
-    sf::Vector2u windowSize = m_Window.getSize();
+        ApplySceneUniforms(shader, frame, projection);
+        shader.SetBool("isUnlit", true);
+        shader.SetFloat("emissiveBoost", EMISSIVE_BOOST);
+        for (const auto& keyPos : frame.keyPositions) DrawKey(keyPos, frame.time);
 
+        glm::mat4 model = glm::mat4(1.0f);
+        float floatY = frame.paperPos.y + std::sin(frame.time * 2.0f) * 0.1f;
+        model = glm::translate(model, glm::vec3(frame.paperPos.x, floatY, frame.paperPos.z));
+        model = glm::scale(model, glm::vec3(0.3f, 0.01f, 0.4f));
+        m_Renderer->DrawCube(shader, model, ResourceManager::GetTextureId(m_PaperTex));
+        shader.SetBool("isUnlit", false);
+        shader.SetFloat("emissiveBoost", 0.0f);
+
+        if (m_Settings.particles) {
+            // Clamped so a hitch doesn't integrate a whole burst of emission in one step.
+            float dt = frame.state == GameState::PLAYING ? std::clamp(frame.time - m_ParticleTime, 0.0f, 0.1f) : 0.0f;
+            m_Particles->Update(dt, frame.viewPos);
+            m_Particles->Draw(projection, view, frame.viewPos, frame.flashlightPos, frame.front,
+                              frame.flashIntensity, m_Settings.fogDensity);
+        }
+        m_ParticleTime = frame.time;
+    }
 
-    bool usePostProcessing = (m_State == GameState::PLAYING || m_State == GameState::PAUSED);
+    glBindVertexArray(0);
+    glUseProgram(0);
 
     if (usePostProcessing) {
+        m_PostProcessor->EndRender();
+        m_GpuTimer->End();
+    }
 
-        m_PostProcessor->BeginRender();
-    } else {
-
-        glClearColor(0.005f, 0.005f, 0.01f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderUI(frame);
+
+    // CPU time is taken before display() so the frame limiter's sleep doesn't count against the budget.
+    // With the pipeline the frame costs whichever of render submission and simulation is slower.
+    // The governor waits for the first resolved GPU query so the timer's negative placeholder never
+    // reads as an idle GPU.
+    float gpuMs = m_GpuTimer->GetLastMs();
+    if (frame.state == GameState::PLAYING && gpuMs >= 0.0f) {
+        float cpuMs = std::max(m_FrameClock.getElapsedTime().asSeconds() * 1000.0f, frame.simMs);
+        m_Governor.Update(cpuMs, gpuMs, m_Settings);
+        m_PostProcessor->SetQuality(m_Settings.renderScale, m_Settings.msaaSamples);
     }
 
+    GLStats::EndFrame();
+    Profiler::EndFrame();
+    if (!m_Headless) m_Window.display();
+}
+
+void Game::ApplySceneUniforms(Shader& shader, const FrameSnapshot& frame, const glm::mat4& projection) {
+    shader.Use();
+    shader.SetMat4("projection", projection);
+    shader.SetMat4("view", frame.view);
+    shader.SetVec3("viewPos", frame.viewPos);
+
+    shader.SetVec3("spotLight.position", frame.flashlightPos);
+    shader.SetVec3("spotLight.direction", frame.front);
+    shader.SetFloat("spotLight.cutOff", std::cos(glm::radians(12.5f)));
+    shader.SetFloat("spotLight.outerCutOff", std::cos(glm::radians(25.0f)));
+    shader.SetFloat("spotLight.constant", 1.0f);
+    shader.SetFloat("spotLight.linear", 0.045f);
+    shader.SetFloat("spotLight.quadratic", 0.0075f);
+
+    shader.SetVec3("spotLight.ambient", glm::vec3(0.01f, 0.01f, 0.02f));
+    shader.SetVec3("spotLight.diffuse", glm::vec3(2.5f, 2.4f, 2.0f));
+    shader.SetVec3("spotLight.specular", glm::vec3(1.0f));
+    shader.SetFloat("batteryRatio", frame.flashIntensity);
+    shader.SetFloat("flicker", 1.0f);
+    shader.SetFloat("fogDensity", m_Settings.fogDensity);
+
+    m_LightGrid->Bind(shader, LIGHT_GRID_TEXTURE_UNIT);
+
+    glActiveTexture(GL_TEXTURE0 + LIGHTMAP_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, m_LightmapTex);
+    glActiveTexture(GL_TEXTURE0);
+    shader.SetInt("lightmap", LIGHTMAP_TEXTURE_UNIT);
+    shader.SetBool("useLightmap", m_LightmapTex != 0);
+    shader.SetFloat("lightmapBlock", static_cast<float>(m_LightmapBlock));
+}
 
+// One texture repeat spans one world unit, so a surface at distance d gets pixelsPerUnit / d pixels
+// per repeat. Walls, floor and ceiling are always right next to the camera.
+void Game::NoteTextureUses(const FrameSnapshot& frame, const Frustum& frustum, float pixelsPerUnit) {
+    glm::vec3 eye = frame.viewPos + glm::vec3(0.0f, 1.8f, 0.0f);
+    auto note = [&](TextureHandle texture, glm::vec3 center, glm::vec3 halfExtent) {
+        if (!frustum.IntersectsAABB(center, halfExtent)) return;
+        glm::vec3 nearest = glm::clamp(eye, center - halfExtent, center + halfExtent);
+        float distance = std::max(glm::length(nearest - eye), 0.5f);
+        ResourceManager::NoteTextureUse(texture, pixelsPerUnit / distance);
+    };
+
+    for (TextureHandle texture : {m_WallTex, m_FloorTex, m_CeilingTex}) {
+        ResourceManager::NoteTextureUse(texture, pixelsPerUnit / 0.5f);
+    }
+    for (const DoorBox& door : m_DoorBoxes) note(door.texture, door.center, door.halfExtent);
+    for (const glm::vec3& key : frame.keyPositions) note(m_KeyTex, key, glm::vec3(0.2f));
+    note(m_PaperTex, frame.paperPos, glm::vec3(0.2f));
+}
 
-    if (m_State == GameState::PLAYING || m_State == GameState::PAUSED) {
-        glm::mat4 projection = glm::perspective(glm::radians(m_Player->GetCurrentFOV()),
-            static_cast<float>(windowSize.x) / static_cast<float>(windowSize.y), 0.01f, 100.0f);
+void Game::DrawKey(glm::vec3 tileCenter, float time) {
+    glm::mat4 model = glm::mat4(1.0f);
+    float floatY = tileCenter.y + std::sin(time * 2.0f) * 0.1f;
+    model = glm::translate(model, glm::vec3(tileCenter.x, floatY, tileCenter.z));
+    model = glm::rotate(model, time, glm::vec3(0,1,0));
+    model = glm::scale(model, glm::vec3(0.3f, 0.05f, 0.4f));
+    m_Renderer->DrawCube(*ResourceManager::GetShader(m_Shader), model, ResourceManager::GetTextureId(m_KeyTex));
+}
 
-        glm::mat4 view = m_Player->GetViewMatrix();
-
-        float flashInt = (m_Player->IsFlashlightOn() && m_Player->GetBattery() > 0.0f) ? 1.0f : 0.0f;
-        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
-        if (m_Player->GetBattery() < 20.0f) flashInt *= (dist(m_RNG) > 0.9f ? 0.2f : 1.0f);
-
-
-        m_InstancedShader->Use();
-        m_InstancedShader->SetMat4("projection", projection);
-        m_InstancedShader->SetMat4("view", view);
-        m_InstancedShader->SetVec3("viewPos", m_Player->GetPosition());
-
-
-        m_InstancedShader->SetVec3("spotLight.position", m_Player->GetFlashlightPosition());
-        m_InstancedShader->SetVec3("spotLight.direction", m_Player->GetFront());
-        m_InstancedShader->SetFloat("spotLight.cutOff", std::cos(glm::radians(12.5f)));
-        m_InstancedShader->SetFloat("spotLight.outerCutOff", std::cos(glm::radians(25.0f)));
-        m_InstancedShader->SetFloat("spotLight.constant", 1.0f);
-        m_InstancedShader->SetFloat("spotLight.linear", 0.045f);
-        m_InstancedShader->SetFloat("spotLight.quadratic", 0.0075f);
-
-        m_InstancedShader->SetVec3("spotLight.ambient", glm::vec3(0.01f, 0.01f, 0.02f));
-        m_InstancedShader->SetVec3("spotLight.diffuse", glm::vec3(2.5f, 2.4f, 2.0f));
-        m_InstancedShader->SetVec3("spotLight.specular", glm::vec3(1.0f));
-        m_InstancedShader->SetFloat("batteryRatio", flashInt);
-        m_InstancedShader->SetFloat("flicker", 1.0f);
-
-        m_Renderer->DrawInstancedWalls(*m_InstancedShader, m_WallTex, static_cast<GLsizei>(m_WallTransforms.size()));
-
-
-        m_Shader->Use();
-        m_Shader->SetMat4("projection", projection);
-        m_Shader->SetMat4("view", view);
-        m_Shader->SetVec3("viewPos", m_Player->GetPosition());
-
-        m_Shader->SetVec3("spotLight.position", m_Player->GetFlashlightPosition());
-        m_Shader->SetVec3("spotLight.direction", m_Player->GetFront());
-        m_Shader->SetFloat("spotLight.cutOff", std::cos(glm::radians(12.5f)));
-        m_Shader->SetFloat("spotLight.outerCutOff", std::cos(glm::radians(25.0f)));
-        m_Shader->SetFloat("spotLight.constant", 1.0f);
-        m_Shader->SetFloat("spotLight.linear", 0.045f);
-        m_Shader->SetFloat("spotLight.quadratic", 0.0075f);
-        m_Shader->SetVec3("spotLight.ambient", glm::vec3(0.01f, 0.01f, 0.02f));
-        m_Shader->SetVec3("spotLight.diffuse", glm::vec3(2.5f, 2.4f, 2.0f));
-        m_Shader->SetVec3("spotLight.specular", glm::vec3(1.0f));
-        m_Shader->SetFloat("batteryRatio", flashInt);
-        m_Shader->SetFloat("flicker", 1.0f);
-        m_Shader->SetBool("isUnlit", false);
-
-        for (int x = 0; x < m_Map->GetWidth(); x++) {
-            for (int z = 0; z < m_Map->GetHeight(); z++) {
-                int tile = m_Map->GetTile(x, z);
-
-                if (tile == 0 || tile == 3 || tile == 4 || tile == 9) {
-                    glm::mat4 model = glm::mat4(1.0f);
-                    model = glm::translate(model, glm::vec3(x + 0.5f, -0.5f, z + 0.5f));
-                    m_Renderer->DrawCube(*m_Shader, model, m_FloorTex);
-
-                    model = glm::mat4(1.0f);
-
-                    model = glm::translate(model, glm::vec3(x + 0.5f, 4.0f, z + 0.5f));
-                    model = glm::rotate(model, glm::radians(180.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-                    m_Renderer->DrawCube(*m_Shader, model, m_CeilingTex);
-                }
-
-                if (tile == 2 || tile == 5) {
-                    unsigned int tex = (tile == 2) ? m_DoorTex : m_LockedDoorTex;
-                    glm::mat4 model = glm::mat4(1.0f);
-                    model = glm::translate(model, glm::vec3(x + 0.5f, 0.75f, z + 0.5f));
-                    model = glm::scale(model, glm::vec3(1.0f, 2.5f, 1.0f));
-                    m_Renderer->DrawCube(*m_Shader, model, tex);
-
-                    model = glm::mat4(1.0f);
-                    model = glm::translate(model, glm::vec3(x + 0.5f, 2.75f, z + 0.5f));
-                    model = glm::scale(model, glm::vec3(1.0f, 1.5f, 1.0f));
-                    m_Renderer->DrawCube(*m_Shader, model, m_WallTex);
-                }
-
-                if (tile == 4) {
-                    m_Shader->SetBool("isUnlit", true);
-                    glm::mat4 model = glm::mat4(1.0f);
-                    float floatY = 0.5f + std::sin(m_GameTime.getElapsedTime().asSeconds() * 2.0f) * 0.1f;
-                    model = glm::translate(model, glm::vec3(x + 0.5f, floatY, z + 0.5f));
-                    model = glm::rotate(model, m_GameTime.getElapsedTime().asSeconds(), glm::vec3(0,1,0));
-                    model = glm::scale(model, glm::vec3(0.3f, 0.05f, 0.4f));
-                    m_Renderer->DrawCube(*m_Shader, model, m_KeyTex);
-                    m_Shader->SetBool("isUnlit", false);
-                }
-            }
-        }
+// Runs on the frame whose snapshot first shows the new level; everything it needs was built by the simulation.
+void Game::EnterLevel(const FrameSnapshot& frame) {
+    MAZE_PROFILE_SCOPE("Game::EnterLevel");
+    glDeleteTextures(1, &m_LightmapTex);
+    m_LightmapTex = frame.lightmap->CreateTexture();
+    m_LightmapBlock = frame.lightmap->blockSize;
+    UploadMazeGeometry(frame.geometry, frame.mapRevision);
+    m_LevelSerial = frame.levelSerial;
+}
 
-        glm::mat4 model = glm::mat4(1.0f);
-        float floatY = m_PaperPos.y + std::sin(m_GameTime.getElapsedTime().asSeconds() * 2.0f) * 0.1f;
-        model = glm::translate(model, glm::vec3(m_PaperPos.x, floatY, m_PaperPos.z));
-        model = glm::scale(model, glm::vec3(0.3f, 0.01f, 0.4f));
-        m_Renderer->DrawCube(*m_Shader, model, m_PaperTex);
+void Game::UploadMazeGeometry(const std::shared_ptr<const MazeGeometry>& geometry, unsigned int revision) {
+    m_DoorBoxes.clear();
+    for (const PackedInstance& instance : geometry->instances) {
+        MaterialID material = UnpackMaterial(instance);
+        if (material != MaterialID::DOOR && material != MaterialID::LOCKED_DOOR) continue;
+        TextureHandle texture = material == MaterialID::DOOR ? m_DoorTex : m_LockedDoorTex;
+        m_DoorBoxes.push_back({instance.position, UnpackScale(instance) * 0.5f, texture});
     }
 
-    glBindVertexArray(0);
-    glUseProgram(0);
+    m_MazeChunks->Upload(geometry->instances);
+    if (m_GpuCuller) m_GpuCuller->Upload(geometry->instances);
+    m_Particles->SetEmitters(geometry->emitters);
+    m_LightGrid->SetBins(geometry);
+    m_MapRevision = revision;
+}
 
-    if (usePostProcessing) {
-        m_PostProcessor->EndRender();
+void Game::SetupHud() {
+    m_Hud = std::make_unique<HudRenderer>(m_Font);
+    HudRenderer& hud = *m_Hud;
+    HudElements& ids = m_HudIds;
+
+    ids.pauseOverlay = hud.AddRect(sf::Color(0, 0, 0, 150));
+    ids.pauseTitle = hud.AddText(40, sf::Color::Red);
+    hud.SetText(ids.pauseTitle, "PAUSED");
+    const char* options[3] = {"Resume", "Restart", "Quit"};
+    for (int i = 0; i < 3; i++) {
+        ids.pauseOptions[i] = hud.AddText(24, sf::Color::White);
+        hud.SetText(ids.pauseOptions[i], options[i]);
     }
 
-    RenderUI();
-    m_Window.display();
+    ids.menuText = hud.AddText(24, sf::Color::White);
+    hud.SetText(ids.menuText, "3d-maze-explorer \"By Mahmoud Mamdouh\"\n\n\nCONTROLS:\n\n\n[WASD] Move\n\n\n[F] Toggle Light\n\n\n[E] Open Locked Doors\n\n\nPRESS ENTER to Play");
+    ids.endText = hud.AddText(40, sf::Color::Red);
+
+    ids.crosshair = hud.AddCircle(sf::Color(200, 200, 200, 150));
+    ids.interactText = hud.AddText(30, sf::Color::Yellow);
+
+    ids.batteryOutline = hud.AddRect(sf::Color::White, 2.0f);
+    ids.batteryBack = hud.AddRect(sf::Color(50, 50, 50, 200));
+    ids.batteryFront = hud.AddRect(sf::Color::Green);
+    ids.batteryLabel = hud.AddText(24, sf::Color::White);
+    hud.SetText(ids.batteryLabel, "FLASHLIGHT [F]");
+    hud.SetScale(ids.batteryLabel, glm::vec2(0.8f));
+
+    ids.staminaBack = hud.AddRect(sf::Color(50, 50, 50, 200));
+    ids.staminaFront = hud.AddRect(sf::Color::Cyan);
+    ids.staminaLabel = hud.AddText(24, sf::Color::Cyan);
+    hud.SetText(ids.staminaLabel, "STAMINA");
+    hud.SetScale(ids.staminaLabel, glm::vec2(0.6f));
+
+    ids.keyOutline = hud.AddRect(sf::Color::White, 3.0f);
+    ids.keyIcon = hud.AddRect(sf::Color(255, 215, 0));
+    ids.keyLabel = hud.AddText(24, sf::Color::White);
+    hud.SetText(ids.keyLabel, "ACCESS KEY");
+
+    ids.glStats = hud.AddText(16, sf::Color(120, 255, 120));
+    hud.SetPosition(ids.glStats, glm::vec2(10.0f, 10.0f));
 }
 
-void Game::RenderUI() {
-    m_Window.pushGLStates();
-    sf::Vector2u windowSize = m_Window.getSize();
+void Game::RenderUI(const FrameSnapshot& frame) {
+    sf::Vector2u windowSize = m_FramebufferSize;
     float centerX = windowSize.x / 2.0f;
     float centerY = windowSize.y / 2.0f;
-
-    if (m_State == GameState::MENU) {
-        m_UIText.setString("3d-maze-explorer \"By Mahmoud Mamdouh\"\n\n\nCONTROLS:\n\n\n[WASD] Move\n\n\n[F] Toggle Light\n\n\n[E] Open Locked Doors\n\n\nPRESS ENTER to Play");
-        sf::FloatRect bounds = m_UIText.getLocalBounds();
-        m_UIText.setPosition({centerX - bounds.size.x/2, centerY - bounds.size.y/2});
-        m_Window.draw(m_UIText);
-
-        if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)) {
-            ResetGame();
-        }
+    HudRenderer& hud = *m_Hud;
+    const HudElements& ids = m_HudIds;
+
+    bool playing = frame.state == GameState::PLAYING;
+    bool paused = frame.state == GameState::PAUSED;
+    bool ended = frame.state == GameState::GAME_OVER || frame.state == GameState::WIN;
+
+    // Centers a text element's glyphs horizontally on the screen with their top edge at y.
+    auto placeCentered = [&](HudRenderer::ElementId id, float y) {
+        glm::vec2 min = hud.GetTextMin(id);
+        glm::vec2 size = hud.GetTextSize(id);
+        hud.SetPosition(id, glm::vec2(centerX - size.x / 2.0f - min.x, y - min.y));
+    };
+
+    hud.SetVisible(ids.menuText, frame.state == GameState::MENU);
+    hud.SetVisible(ids.endText, ended);
+    hud.SetVisible(ids.pauseOverlay, paused);
+    hud.SetVisible(ids.pauseTitle, paused);
+    for (int i = 0; i < 3; i++) hud.SetVisible(ids.pauseOptions[i], paused);
+    for (HudRenderer::ElementId id : {ids.crosshair, ids.batteryOutline, ids.batteryBack, ids.batteryFront, ids.batteryLabel,
+                                      ids.staminaBack, ids.staminaFront, ids.staminaLabel}) {
+        hud.SetVisible(id, playing);
     }
-    else if (m_State == GameState::PAUSED) {
-        sf::RectangleShape overlay(sf::Vector2f(static_cast<float>(windowSize.x), static_cast<float>(windowSize.y)));
-        overlay.setFillColor(sf::Color(0, 0, 0, 150));
-        m_Window.draw(overlay);
+    hud.SetVisible(ids.interactText, playing && !frame.interactPrompt.empty());
+    for (HudRenderer::ElementId id : {ids.keyOutline, ids.keyIcon, ids.keyLabel}) {
+        hud.SetVisible(id, playing && frame.hasRedKey);
+    }
+    // Shows the previous frame's counts; the overlay's own draw lands in the next frame.
+    hud.SetVisible(ids.glStats, m_ShowGLStats);
+    if (m_ShowGLStats) hud.SetText(ids.glStats, GLStats::FormatLastFrame());
 
-        m_CenterText.setString("PAUSED");
-        sf::FloatRect titleBounds = m_CenterText.getLocalBounds();
-        m_CenterText.setPosition({centerX - titleBounds.size.x/2, centerY - 200});
-        m_Window.draw(m_CenterText);
+    if (frame.state == GameState::MENU) {
+        placeCentered(ids.menuText, centerY - hud.GetTextSize(ids.menuText).y / 2.0f);
+    }
+    else if (paused) {
+        hud.SetScale(ids.pauseOverlay, glm::vec2(windowSize.x, windowSize.y));
+        placeCentered(ids.pauseTitle, centerY - 200.0f);
 
-        std::vector<std::string> options = {"Resume", "Restart", "Quit"};
         for (int i = 0; i < 3; i++) {
-            sf::Text opt = m_UIText;
-            opt.setString(options[i]);
-            if (i == m_PauseMenuSelection) opt.setFillColor(sf::Color::Yellow);
-            else opt.setFillColor(sf::Color::White);
-
-            sf::FloatRect b = opt.getLocalBounds();
-            opt.setPosition({centerX - b.size.x/2, centerY + i * 50.0f});
-            m_Window.draw(opt);
+            hud.SetColor(ids.pauseOptions[i], i == frame.pauseSelection ? sf::Color::Yellow : sf::Color::White);
+            placeCentered(ids.pauseOptions[i], centerY + i * 50.0f);
         }
     }
-    else if (m_State == GameState::PLAYING) {
-        sf::CircleShape crosshair(3.0f);
-        crosshair.setOrigin({3.0f, 3.0f});
-        crosshair.setPosition({centerX, centerY});
-        if (!m_InteractText.getString().isEmpty()) {
-            crosshair.setFillColor(sf::Color::Red);
-            crosshair.setScale({1.5f, 1.5f});
-            m_InteractText.setPosition({centerX + 20, centerY + 20});
-            m_Window.draw(m_InteractText);
+    else if (playing) {
+        hud.SetPosition(ids.crosshair, glm::vec2(centerX, centerY));
+        if (!frame.interactPrompt.empty()) {
+            hud.SetColor(ids.crosshair, sf::Color::Red);
+            hud.SetScale(ids.crosshair, glm::vec2(4.5f));
+            hud.SetText(ids.interactText, frame.interactPrompt);
+            hud.SetPosition(ids.interactText, glm::vec2(centerX + 20.0f, centerY + 20.0f));
         } else {
-            crosshair.setFillColor(sf::Color(200, 200, 200, 150));
+            hud.SetColor(ids.crosshair, sf::Color(200, 200, 200, 150));
+            hud.SetScale(ids.crosshair, glm::vec2(3.0f));
         }
-        m_Window.draw(crosshair);
 
         float barWidth = 200.0f;
         float barHeight = 20.0f;
-
-        sf::Vector2f barPos(20.0f, static_cast<float>(windowSize.y) - barHeight - 80.0f);
-
-        sf::RectangleShape backBar(sf::Vector2f(barWidth, barHeight));
-        backBar.setPosition(barPos);
-        backBar.setFillColor(sf::Color(50, 50, 50, 200));
-        backBar.setOutlineColor(sf::Color::White);
-        backBar.setOutlineThickness(2.0f);
-        m_Window.draw(backBar);
-
-        float batteryPct = m_Player->GetBattery() / 180.0f;
-        sf::RectangleShape frontBar(sf::Vector2f(barWidth * batteryPct, barHeight));
-        frontBar.setPosition(barPos);
-        if (batteryPct > 0.5f) frontBar.setFillColor(sf::Color::Green);
-        else if (batteryPct > 0.2f) frontBar.setFillColor(sf::Color::Yellow);
-        else frontBar.setFillColor(sf::Color::Red);
-        m_Window.draw(frontBar);
-
-        m_UIText.setString("FLASHLIGHT [F]");
-        m_UIText.setPosition({barPos.x, barPos.y - 30.0f});
-        m_UIText.setScale({0.8f, 0.8f});
-        m_UIText.setFillColor(sf::Color::White);
-        m_Window.draw(m_UIText);
-
-        sf::Vector2f stamPos = barPos;
-        stamPos.y += 35.0f;
-
-
-        m_UIText.setString("STAMINA");
-        m_UIText.setPosition({stamPos.x, stamPos.y - 25.0f});
-        m_UIText.setScale({0.6f, 0.6f});
-        m_UIText.setFillColor(sf::Color::Cyan);
-        m_Window.draw(m_UIText);
-
-        sf::RectangleShape backStam(sf::Vector2f(barWidth, 10.0f));
-        backStam.setPosition(stamPos);
-        backStam.setFillColor(sf::Color(50, 50, 50, 200));
-        m_Window.draw(backStam);
-
-        float staminaPct = m_Player->GetStamina() / 100.0f;
-        sf::RectangleShape frontStam(sf::Vector2f(barWidth * staminaPct, 10.0f));
-        frontStam.setPosition(stamPos);
-        frontStam.setFillColor(sf::Color::Cyan);
-        m_Window.draw(frontStam);
-
-
-        m_UIText.setScale({1.0f, 1.0f});
-        m_UIText.setFillColor(sf::Color::White);
-
-        if (m_Player->HasRedKey()) {
-             sf::RectangleShape keyIcon(sf::Vector2f(30.0f, 40.0f));
-             keyIcon.setScale({1.5f, 1.5f});
-             keyIcon.setPosition({barPos.x + barWidth + 20.0f, barPos.y - 20.0f});
-
-             keyIcon.setFillColor(sf::Color(255, 215, 0));
-             keyIcon.setOutlineColor(sf::Color::White);
-             keyIcon.setOutlineThickness(2.0f);
-             m_Window.draw(keyIcon);
-
-             m_UIText.setString("ACCESS KEY");
-             m_UIText.setPosition({barPos.x + barWidth + 80.0f, barPos.y - 15.0f});
-             m_Window.draw(m_UIText);
-        }
+        glm::vec2 barPos(20.0f, static_cast<float>(windowSize.y) - barHeight - 80.0f);
+
+        hud.SetPosition(ids.batteryOutline, barPos - glm::vec2(2.0f));
+        hud.SetScale(ids.batteryOutline, glm::vec2(barWidth + 4.0f, barHeight + 4.0f));
+        hud.SetPosition(ids.batteryBack, barPos);
+        hud.SetScale(ids.batteryBack, glm::vec2(barWidth, barHeight));
+
+        float batteryPct = frame.battery / 180.0f;
+        hud.SetPosition(ids.batteryFront, barPos);
+        hud.SetScale(ids.batteryFront, glm::vec2(barWidth * batteryPct, barHeight));
+        if (batteryPct > 0.5f) hud.SetColor(ids.batteryFront, sf::Color::Green);
+        else if (batteryPct > 0.2f) hud.SetColor(ids.batteryFront, sf::Color::Yellow);
+        else hud.SetColor(ids.batteryFront, sf::Color::Red);
+        hud.SetPosition(ids.batteryLabel, glm::vec2(barPos.x, barPos.y - 30.0f));
+
+        glm::vec2 stamPos = barPos + glm::vec2(0.0f, 35.0f);
+        float staminaPct = frame.stamina / 100.0f;
+        hud.SetPosition(ids.staminaBack, stamPos);
+        hud.SetScale(ids.staminaBack, glm::vec2(barWidth, 10.0f));
+        hud.SetPosition(ids.staminaFront, stamPos);
+        hud.SetScale(ids.staminaFront, glm::vec2(barWidth * staminaPct, 10.0f));
+        hud.SetPosition(ids.staminaLabel, glm::vec2(stamPos.x, stamPos.y - 25.0f));
+
+        glm::vec2 keyPos(barPos.x + barWidth + 20.0f, barPos.y - 20.0f);
+        hud.SetPosition(ids.keyIcon, keyPos);
+        hud.SetScale(ids.keyIcon, glm::vec2(45.0f, 60.0f));
+        hud.SetPosition(ids.keyOutline, keyPos - glm::vec2(3.0f));
+        hud.SetScale(ids.keyOutline, glm::vec2(51.0f, 66.0f));
+        hud.SetPosition(ids.keyLabel, glm::vec2(barPos.x + barWidth + 80.0f, barPos.y - 15.0f));
     }
-    else if (m_State == GameState::GAME_OVER) {
-        m_CenterText.setString("LIGHTS OUT.\n\n\nPress ENTER to Retry");
-        sf::FloatRect bounds = m_CenterText.getLocalBounds();
-        m_CenterText.setPosition({centerX - bounds.size.x/2, centerY - bounds.size.y/2});
-        m_Window.draw(m_CenterText);
+    else if (ended) {
+        hud.SetText(ids.endText, frame.state == GameState::WIN ? "FORM SUBMITTED.\n\n\nPress ENTER to Continue"
+                                                           : "LIGHTS OUT.\n\n\nPress ENTER to Retry");
+        placeCentered(ids.endText, centerY - hud.GetTextSize(ids.endText).y / 2.0f);
     }
-    else if (m_State == GameState::WIN) {
-        m_CenterText.setString("FORM SUBMITTED.\n\n\nPress ENTER to Continue");
-        sf::FloatRect bounds = m_CenterText.getLocalBounds();
-        m_CenterText.setPosition({centerX - bounds.size.x/2, centerY - bounds.size.y/2});
-        m_Window.draw(m_CenterText);
+
+    m_Minimap->Apply(frame.minimap);
+    if (playing) {
+        const float minimapSize = 220.0f;
+        glm::vec2 minimapPos(static_cast<float>(windowSize.x) - minimapSize - 20.0f, 20.0f);
+        m_Minimap->Draw(minimapPos, minimapSize, static_cast<int>(windowSize.x), static_cast<int>(windowSize.y),
+                        frame.viewPos, frame.front);
     }
 
-    m_Window.popGLStates();
-}
\ No newline at end of file
+    hud.Draw(static_cast<int>(windowSize.x), static_cast<int>(windowSize.y));
+}
@@ -2,66 +2,111 @@
 #include <glad/glad.h>
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
-#include <SFML/Audio.hpp>
 #include <memory>
-#include <random>
 
 #include "../Graphics/Shader.h"
 #include "../Graphics/Renderer.h"
-#include "../Entities/Player.h"
-#include "../Entities/Map.h"
-#include "AudioManager.h"
+#include "Simulation.h"
+#include "SimulationThread.h"
+#include "ResourceHandle.h"
+#include "FrameSnapshot.h"
+#include "InputState.h"
+#include "HeadlessContext.h"
+#include "FrameBenchmark.h"
 #include "../Graphics/PostProcessor.h"
+#include "../Graphics/GpuCuller.h"
+#include "../Graphics/MazeChunks.h"
+#include "../Graphics/RenderSettings.h"
+#include "../Graphics/LightGrid.h"
+#include "../Graphics/LightmapBaker.h"
+#include "../Graphics/GpuTimer.h"
+#include "../Graphics/QualityGovernor.h"
+#include "../Graphics/HudRenderer.h"
+#include "../Graphics/ParticleSystem.h"
+#include "../Graphics/Minimap.h"
+#include "../Graphics/Frustum.h"
 
-enum class GameState {
-    MENU,
-    PLAYING,
-    PAUSED,
-    GAME_OVER,
-    WIN
-};
-
+// Owns the window and all GL state. Each frame the main thread captures input and hands it to
+// the SimulationThread, then renders the previous frame's snapshot while the next one simulates.
+// With benchmark options it renders into a HeadlessContext instead of opening a window.
 class Game {
 public:
-    Game();
+    explicit Game(const RenderSettings& renderSettings = RenderSettings(), const BenchmarkOptions* benchmark = nullptr);
     ~Game();
 
     void Run();
+    // Headless only: renders the benchmark's camera path and returns its exit code.
+    int RunBenchmark(FrameBenchmark& benchmark);
 
 private:
-    void ProcessEvents();
-    void Update(float dt);
-    void Render();
-    void RenderUI();
-    void ResetGame();
+    InputState ProcessEvents(const FrameSnapshot& frame);
+    void ApplyWindowRequests(const FrameSnapshot& frame);
+    void Render(const FrameSnapshot& frame);
+    void RenderUI(const FrameSnapshot& frame);
+    void SetupHud();
+
+    void ApplySceneUniforms(Shader& shader, const FrameSnapshot& frame, const glm::mat4& projection);
+    void DrawKey(glm::vec3 tileCenter, float time);
+    void EnterLevel(const FrameSnapshot& frame);
+    void UploadMazeGeometry(const std::shared_ptr<const MazeGeometry>& geometry, unsigned int revision);
+    void NoteTextureUses(const FrameSnapshot& frame, const Frustum& frustum, float pixelsPerUnit);
 
     sf::RenderWindow m_Window;
+    // Declared ahead of every GL-owning member so the context outlives them.
+    std::unique_ptr<HeadlessContext> m_Headless;
+    sf::Vector2u m_FramebufferSize;
     sf::Clock m_DeltaClock;
-    sf::Clock m_GameTime;
-    GameState m_State;
-    std::mt19937 m_RNG;
+    sf::Clock m_FrameClock;
 
-    std::unique_ptr<Shader> m_Shader;
-    std::unique_ptr<Shader> m_InstancedShader;
+    ShaderHandle m_Shader;
+    ShaderHandle m_InstancedShader;
     std::unique_ptr<Renderer> m_Renderer;
-    std::unique_ptr<AudioManager> m_Audio;
     std::unique_ptr<PostProcessor> m_PostProcessor;
+    std::unique_ptr<GpuCuller> m_GpuCuller;
+    ShaderHandle m_GpuShader;
+    ShaderHandle m_DepthShader;
+    std::unique_ptr<MazeChunks> m_MazeChunks;
+    std::unique_ptr<LightGrid> m_LightGrid;
+    std::unique_ptr<GpuTimer> m_GpuTimer;
+    std::unique_ptr<ParticleSystem> m_Particles;
 
-    std::unique_ptr<Map> m_Map;
-    std::unique_ptr<Player> m_Player;
+    // Declared after the simulation so the worker is joined before the simulation goes away.
+    std::unique_ptr<Simulation> m_Simulation;
+    std::unique_ptr<SimulationThread> m_SimThread;
 
-    unsigned int m_FloorTex, m_WallTex, m_CeilingTex;
-    unsigned int m_PaperTex, m_DoorTex, m_LockedDoorTex, m_KeyTex;
-    std::vector<glm::mat4> m_WallTransforms;
+    TextureHandle m_FloorTex, m_WallTex, m_CeilingTex;
+    TextureHandle m_PaperTex, m_DoorTex, m_LockedDoorTex, m_KeyTex;
 
-    glm::vec3 m_PlayerStartPos;
-    glm::vec3 m_PaperPos;
+    // Door boxes of the current geometry, for texture residency.
+    struct DoorBox {
+        glm::vec3 center, halfExtent;
+        TextureHandle texture;
+    };
+    std::vector<DoorBox> m_DoorBoxes;
 
     sf::Font m_Font;
-    sf::Text m_UIText;
-    sf::Text m_CenterText;
-    sf::Text m_InteractText;
+    std::unique_ptr<HudRenderer> m_Hud;
+    std::unique_ptr<Minimap> m_Minimap;
 
-    int m_PauseMenuSelection;
-    bool m_AudioStopped;
-};
\ No newline at end of file
+    struct HudElements {
+        HudRenderer::ElementId pauseOverlay, pauseTitle;
+        HudRenderer::ElementId pauseOptions[3];
+        HudRenderer::ElementId menuText, endText;
+        HudRenderer::ElementId crosshair, interactText;
+        HudRenderer::ElementId batteryOutline, batteryBack, batteryFront, batteryLabel;
+        HudRenderer::ElementId staminaBack, staminaFront, staminaLabel;
+        HudRenderer::ElementId keyOutline, keyIcon, keyLabel;
+        HudRenderer::ElementId glStats;
+    };
+    HudElements m_HudIds;
+
+    RenderSettings m_Settings;
+    QualityGovernor m_Governor;
+    bool m_CursorGrabbed;
+    bool m_ShowGLStats;
+    unsigned int m_MapRevision;
+    unsigned int m_LevelSerial;
+    unsigned int m_LightmapTex;
+    int m_LightmapBlock;
+    float m_ParticleTime;
+};
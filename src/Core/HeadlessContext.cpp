@@ -0,0 +1,167 @@
+#include "HeadlessContext.h"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef MAZE_HEADLESS_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext(int width, int height)
+    : m_Width(width), m_Height(height), FBO(0), colorRBO(0), depthRBO(0)
+#ifdef MAZE_HEADLESS_EGL
+    , m_Display(nullptr), m_Context(nullptr), m_Surface(nullptr)
+#endif
+{
+    CreateContext();
+
+    glGenFramebuffers(1, &FBO);
+    glGenRenderbuffers(1, &colorRBO);
+    glGenRenderbuffers(1, &depthRBO);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_Width, m_Height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Width, m_Height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        DestroyContext();
+        throw std::runtime_error("Headless framebuffer is not complete");
+    }
+    glViewport(0, 0, m_Width, m_Height);
+}
+
+HeadlessContext::~HeadlessContext() {
+    glDeleteFramebuffers(1, &FBO);
+    glDeleteRenderbuffers(1, &colorRBO);
+    glDeleteRenderbuffers(1, &depthRBO);
+    DestroyContext();
+}
+
+void HeadlessContext::ReadPixels(std::vector<std::uint8_t>& out) const {
+    const std::size_t rowBytes = static_cast<std::size_t>(m_Width) * 4;
+    std::vector<std::uint8_t> bottomUp(rowBytes * m_Height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, bottomUp.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    out.resize(bottomUp.size());
+    for (int y = 0; y < m_Height; y++) {
+        std::memcpy(&out[y * rowBytes], &bottomUp[(m_Height - 1 - y) * rowBytes], rowBytes);
+    }
+}
+
+#ifdef MAZE_HEADLESS_EGL
+
+void HeadlessContext::CreateContext() {
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Surfaceless needs no display server at all; fall back to the default display otherwise.
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay && clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    }
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        throw std::runtime_error("Failed to initialize EGL");
+    }
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        eglTerminate(display);
+        throw std::runtime_error("EGL has no desktop OpenGL support");
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        eglTerminate(display);
+        throw std::runtime_error("No suitable EGL config");
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        eglTerminate(display);
+        throw std::runtime_error("Failed to create EGL context");
+    }
+
+    // Everything renders into our own FBO, so a 1x1 pbuffer is only needed without surfaceless support.
+    EGLSurface surface = EGL_NO_SURFACE;
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!displayExtensions || !std::strstr(displayExtensions, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+    }
+
+    m_Display = display;
+    m_Context = context;
+    m_Surface = surface;
+
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        DestroyContext();
+        throw std::runtime_error("Failed to make the EGL context current");
+    }
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        DestroyContext();
+        throw std::runtime_error("Failed to initialize GLAD");
+    }
+
+    std::cout << "Headless EGL " << major << "." << minor << ": " << glGetString(GL_RENDERER) << std::endl;
+}
+
+void HeadlessContext::DestroyContext() {
+    if (!m_Display) return;
+    EGLDisplay display = static_cast<EGLDisplay>(m_Display);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_Surface) eglDestroySurface(display, static_cast<EGLSurface>(m_Surface));
+    if (m_Context) eglDestroyContext(display, static_cast<EGLContext>(m_Context));
+    eglTerminate(display);
+    m_Display = m_Context = m_Surface = nullptr;
+}
+
+#else
+
+void HeadlessContext::CreateContext() {
+    sf::ContextSettings settings;
+    settings.depthBits = 24;
+    settings.majorVersion = 3;
+    settings.minorVersion = 3;
+    settings.attributeFlags = sf::ContextSettings::Default;
+
+    m_Context = std::make_unique<sf::Context>(settings, sf::Vector2u(1, 1));
+    if (!m_Context->setActive(true)) {
+        throw std::runtime_error("Failed to activate the headless GL context");
+    }
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(sf::Context::getFunction))) {
+        throw std::runtime_error("Failed to initialize GLAD");
+    }
+
+    std::cout << "Headless SFML context: " << glGetString(GL_RENDERER) << std::endl;
+}
+
+void HeadlessContext::DestroyContext() {
+    m_Context.reset();
+}
+
+#endif
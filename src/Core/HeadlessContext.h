@@ -0,0 +1,44 @@
+#pragma once
+#include <glad/glad.h>
+#include <SFML/Window/Context.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Offscreen GL context plus an RGBA8 framebuffer that stands in for the window, for benchmarks and
+// golden-image runs. Built with MAZE_HEADLESS_EGL it uses an EGL surfaceless (or pbuffer) context,
+// which works on GPU-less CI boxes through Mesa llvmpipe; otherwise it falls back to an SFML
+// context, which still needs a display server but never opens a window.
+class HeadlessContext {
+public:
+    HeadlessContext(int width, int height);
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    unsigned int GetFramebuffer() const { return FBO; }
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+
+    // Synchronous readback of the framebuffer as RGBA8, top row first.
+    void ReadPixels(std::vector<std::uint8_t>& out) const;
+
+private:
+    void CreateContext();
+    void DestroyContext();
+
+    int m_Width, m_Height;
+
+    unsigned int FBO;
+    unsigned int colorRBO;
+    unsigned int depthRBO;
+
+#ifdef MAZE_HEADLESS_EGL
+    void* m_Display;
+    void* m_Context;
+    void* m_Surface;
+#else
+    std::unique_ptr<sf::Context> m_Context;
+#endif
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <SFML/Window/Keyboard.hpp>
+#include <vector>
+#include <glm/glm.hpp>
+
+// Keyboard and mouse state sampled on the main thread once per frame. The simulation only ever
+// sees this, never sf::Keyboard, sf::Mouse or the window.
+struct InputState {
+    bool forward = false;
+    bool back = false;
+    bool left = false;
+    bool right = false;
+    bool sprint = false;
+    bool jump = false;
+    bool flashlight = false;
+    bool interact = false;
+    bool mouseLeft = false;
+
+    // Pixels the cursor moved from the window center (x right, y up) since the last recenter.
+    glm::vec2 mouseDelta{0.0f};
+
+    // KeyPressed events of this frame, in arrival order.
+    std::vector<sf::Keyboard::Scancode> pressedKeys;
+};
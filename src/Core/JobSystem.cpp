@@ -0,0 +1,149 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+namespace {
+    // Which system's worker the current thread is, if any.
+    thread_local const JobSystem* t_System = nullptr;
+    thread_local int t_Worker = -1;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+    : m_Quit(false)
+{
+    // Threads that are not workers still need a queue to hand jobs to when there are none.
+    for (unsigned int i = 0; i < std::max(1u, workerCount); i++) m_Queues.push_back(std::make_unique<WorkerQueue>());
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Quit = true;
+    }
+    m_SleepCondition.notify_all();
+    for (std::thread& worker : m_Workers) worker.join();
+}
+
+JobSystem& JobSystem::Shared() {
+    static JobSystem jobs(std::max(2u, std::thread::hardware_concurrency()) - 1);
+    return jobs;
+}
+
+void JobSystem::Run(std::function<void()> task, JobCounter* signal, JobCounter* dependency) {
+    if (signal) signal->m_Pending.fetch_add(1, std::memory_order_relaxed);
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+        if (dependency->m_Pending.load(std::memory_order_relaxed) > 0) {
+            dependency->m_Waiting.push_back({std::move(task), signal});
+            return;
+        }
+    }
+    Push({std::move(task), signal});
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    while (!counter.IsDone()) {
+        if (!TryRunOne(false)) std::this_thread::yield();
+    }
+    // The last job may still be unlocking the counter it just finished.
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::Push(Job job) {
+    const int index = t_System == this ? t_Worker : static_cast<int>(m_NextQueue.fetch_add(1, std::memory_order_relaxed) % m_Queues.size());
+    {
+        std::lock_guard<std::mutex> lock(m_Queues[index]->mutex);
+        m_Queues[index]->jobs.push_back(std::move(job));
+    }
+    m_Queued.fetch_add(1);
+    Wake();
+}
+
+// Paired with the sleep check in WorkerLoop: either the pusher sees the sleeper or the sleeper
+// sees the job, so the lock is only taken when someone may actually be asleep.
+void JobSystem::Wake() {
+    if (m_Sleeping.load() == 0) return;
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+    m_SleepCondition.notify_one();
+}
+
+bool JobSystem::TryPop(int index, Job& job) {
+    WorkerQueue& queue = *m_Queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_Queued.fetch_sub(1);
+    return true;
+}
+
+// Oldest first, which for ParallelFor and job trees is the biggest piece of remaining work.
+bool JobSystem::TrySteal(int thief, Job& job) {
+    const int count = static_cast<int>(m_Queues.size());
+    const int start = thief >= 0 ? thief + 1 : static_cast<int>(m_NextQueue.load(std::memory_order_relaxed));
+    for (int i = 0; i < count; i++) {
+        const int victim = (start + i) % count;
+        if (victim == thief) continue;
+        WorkerQueue& queue = *m_Queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        m_Queued.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::TryRunOne(bool background) {
+    const int self = t_System == this ? t_Worker : -1;
+    Job job;
+    if ((self >= 0 && TryPop(self, job)) || TrySteal(self, job)) {
+        Execute(job);
+        return true;
+    }
+    if (!background) return false;
+
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(m_BackgroundMutex);
+        if (m_Background.empty()) return false;
+        task = std::move(m_Background.front());
+        m_Background.pop_front();
+    }
+    m_Queued.fetch_sub(1);
+    task();
+    return true;
+}
+
+void JobSystem::Execute(Job& job) {
+    job.task();
+    if (job.signal) Finish(job.signal);
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+    std::vector<JobCounter::Waiting> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) released.swap(counter->m_Waiting);
+    }
+    for (JobCounter::Waiting& waiting : released) Push({std::move(waiting.task), waiting.signal});
+}
+
+// Queued jobs still run on shutdown so nobody is left waiting on a broken future or counter.
+void JobSystem::WorkerLoop(int index) {
+    MAZE_PROFILE_THREAD("Worker");
+    t_System = this;
+    t_Worker = index;
+    while (true) {
+        if (TryRunOne(true)) continue;
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_Sleeping.fetch_add(1);
+        m_SleepCondition.wait(lock, [this] { return m_Quit || m_Queued.load() > 0; });
+        m_Sleeping.fetch_sub(1);
+        if (m_Quit && m_Queued.load() == 0) return;
+    }
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class JobSystem;
+
+// Counts unfinished jobs. Jobs started with a counter as their signal add to it until they finish;
+// jobs started with it as their dependency are held back until it reaches zero. Reuse a counter only
+// once it is done.
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return m_Pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    struct Waiting {
+        std::function<void()> task;
+        JobCounter* signal;
+    };
+
+    std::atomic<int> m_Pending{0};
+    std::mutex m_Mutex;
+    std::vector<Waiting> m_Waiting;
+};
+
+// Work-stealing scheduler. Every worker owns a deque: it pushes and pops its own jobs at the back
+// and, when that runs dry, steals from the front of the others'. Threads that are not workers hand
+// their jobs to the workers in turn. Wait() runs queued jobs on the waiting thread instead of
+// blocking, so jobs may wait on jobs they start without tying up a worker.
+//
+// Submit() is for long tasks like decoding assets or preparing a level. They go on one shared FIFO
+// only workers take from, after their own and stolen jobs, so a thread waiting on a short
+// ParallelFor never picks up a long task.
+class JobSystem {
+public:
+    // Submit() needs at least one worker; with none, Run() jobs are only run by Wait().
+    explicit JobSystem(unsigned int workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // One worker per core, leaving one for the thread that starts it.
+    static JobSystem& Shared();
+
+    void Run(std::function<void()> task, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+    void Wait(JobCounter& counter);
+
+    // Calls body(first, last) over [begin, end) in chunks of about grain items, the calling thread
+    // included, and returns when all of them are done. grain <= 0 picks a few chunks per thread.
+    template <typename Body>
+    void ParallelFor(int begin, int end, int grain, Body&& body) {
+        if (end <= begin) return;
+        if (grain <= 0) grain = std::max(1, (end - begin) / (static_cast<int>(GetThreadCount()) * 4));
+
+        JobCounter counter;
+        for (int first = begin + grain; first < end; first += grain) {
+            const int last = std::min(first + grain, end);
+            Run([&body, first, last] { body(first, last); }, &counter);
+        }
+        body(begin, std::min(begin + grain, end));
+        Wait(counter);
+    }
+
+    template <typename Task>
+    std::future<std::invoke_result_t<Task>> Submit(Task task) {
+        using Result = std::invoke_result_t<Task>;
+        // std::function needs a copyable target, packaged_task is move-only.
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_BackgroundMutex);
+            m_Background.emplace_back([packaged] { (*packaged)(); });
+        }
+        m_Queued.fetch_add(1);
+        Wake();
+        return future;
+    }
+
+    unsigned int GetWorkerCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+    // Workers plus the thread calling ParallelFor.
+    unsigned int GetThreadCount() const { return GetWorkerCount() + 1; }
+
+private:
+    struct Job {
+        std::function<void()> task;
+        JobCounter* signal = nullptr;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(int index);
+    void Push(Job job);
+    bool TryPop(int index, Job& job);
+    bool TrySteal(int thief, Job& job);
+    bool TryRunOne(bool background);
+    void Execute(Job& job);
+    void Finish(JobCounter* counter);
+    void Wake();
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    std::atomic<unsigned int> m_NextQueue{0};
+
+    std::mutex m_BackgroundMutex;
+    std::deque<std::function<void()>> m_Background;
+
+    // Jobs queued but not yet taken, and workers asleep; the pair lets Wake() skip the lock.
+    std::atomic<int> m_Queued{0};
+    std::atomic<int> m_Sleeping{0};
+    std::mutex m_SleepMutex;
+    std::condition_variable m_SleepCondition;
+    bool m_Quit;
+
+    std::vector<std::thread> m_Workers;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are faulted in on first touch, so opening a
+// large file is cheap and only what is actually read costs I/O.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const std::uint8_t* GetData() const { return m_Data; }
+    std::size_t GetSize() const { return m_Size; }
+
+private:
+    const std::uint8_t* m_Data = nullptr;
+    std::size_t m_Size = 0;
+#ifdef _WIN32
+    void* m_File = nullptr;
+    void* m_Mapping = nullptr;
+#endif
+};
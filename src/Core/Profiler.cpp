@@ -0,0 +1,257 @@
+#include "Profiler.h"
+#include <chrono>
+
+#ifdef MAZE_PROFILER
+
+#include <glad/glad.h>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+    constexpr std::uint64_t RING_CAPACITY = 1 << 16;
+    // Oldest events skipped on export of a wrapped ring, since the owner may be overwriting them.
+    constexpr std::uint64_t EXPORT_MARGIN = 256;
+    constexpr int GPU_FRAMES = 2;
+    constexpr int GPU_CALIBRATION_INTERVAL = 120;
+
+    struct ProfileEvent {
+        const char* name;
+        std::uint64_t startNs;
+        std::uint64_t endNs;
+    };
+
+    // Written only by its owning thread; head is published with release so exports see whole events.
+    struct ThreadBuffer {
+        std::string name;
+        std::uint32_t id = 0;
+        std::unique_ptr<ProfileEvent[]> events{new ProfileEvent[RING_CAPACITY]};
+        std::atomic<std::uint64_t> head{0};
+        bool inUse = true;
+
+        void Push(const char* eventName, std::uint64_t startNs, std::uint64_t endNs) {
+            std::uint64_t index = head.load(std::memory_order_relaxed);
+            events[index & (RING_CAPACITY - 1)] = {eventName, startNs, endNs};
+            head.store(index + 1, std::memory_order_release);
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::uint32_t nextId = 1;
+
+        // Buffers of finished threads are recycled, so short-lived workers don't grow the registry.
+        ThreadBuffer* Acquire() {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& buffer : buffers) {
+                if (!buffer->inUse) {
+                    buffer->inUse = true;
+                    buffer->name = "Thread " + std::to_string(buffer->id);
+                    return buffer.get();
+                }
+            }
+            buffers.push_back(std::make_unique<ThreadBuffer>());
+            buffers.back()->id = nextId++;
+            buffers.back()->name = "Thread " + std::to_string(buffers.back()->id);
+            return buffers.back().get();
+        }
+
+        void Release(ThreadBuffer* buffer) {
+            std::lock_guard<std::mutex> lock(mutex);
+            buffer->inUse = false;
+        }
+    };
+
+    Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    struct ThreadHandle {
+        ThreadBuffer* buffer = GetRegistry().Acquire();
+        ~ThreadHandle() { GetRegistry().Release(buffer); }
+    };
+
+    ThreadBuffer& LocalBuffer() {
+        thread_local ThreadHandle handle;
+        return *handle.buffer;
+    }
+
+    struct GpuZone {
+        const char* name;
+        unsigned int startQuery;
+        unsigned int endQuery;
+    };
+
+    struct GpuFrame {
+        std::vector<unsigned int> queries;
+        std::size_t usedQueries = 0;
+        std::vector<GpuZone> zones;
+    };
+
+    struct GpuState {
+        GpuFrame frames[GPU_FRAMES];
+        int current = 0;
+        std::vector<std::size_t> openZones;
+        ThreadBuffer* track = nullptr;
+        std::int64_t offsetNs = 0;
+        int framesSinceCalibration = GPU_CALIBRATION_INTERVAL;
+
+        unsigned int NextQuery() {
+            GpuFrame& frame = frames[current];
+            if (frame.usedQueries == frame.queries.size()) {
+                unsigned int query;
+                glGenQueries(1, &query);
+                frame.queries.push_back(query);
+            }
+            return frame.queries[frame.usedQueries++];
+        }
+
+        // GPU timestamps share no epoch with steady_clock; re-measure the offset now and then for drift.
+        void Calibrate() {
+            if (++framesSinceCalibration < GPU_CALIBRATION_INTERVAL) return;
+            framesSinceCalibration = 0;
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            offsetNs = static_cast<std::int64_t>(gpuNow) - static_cast<std::int64_t>(Profiler::NowNs());
+        }
+    };
+
+    GpuState& Gpu() {
+        static GpuState state;
+        return state;
+    }
+
+    void WriteEscaped(std::ostream& out, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+    }
+}
+
+bool Profiler::IsAvailable() {
+    return true;
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+    buffer.name = name;
+}
+
+void Profiler::Record(const char* name, std::uint64_t startNs, std::uint64_t endNs) {
+    LocalBuffer().Push(name, startNs, endNs);
+}
+
+void Profiler::BeginGpuZone(const char* name) {
+    GpuState& gpu = Gpu();
+    GpuFrame& frame = gpu.frames[gpu.current];
+    GpuZone zone{name, gpu.NextQuery(), 0};
+    glQueryCounter(zone.startQuery, GL_TIMESTAMP);
+    gpu.openZones.push_back(frame.zones.size());
+    frame.zones.push_back(zone);
+}
+
+void Profiler::EndGpuZone() {
+    GpuState& gpu = Gpu();
+    if (gpu.openZones.empty()) return;
+    GpuFrame& frame = gpu.frames[gpu.current];
+    GpuZone& zone = frame.zones[gpu.openZones.back()];
+    gpu.openZones.pop_back();
+    zone.endQuery = gpu.NextQuery();
+    glQueryCounter(zone.endQuery, GL_TIMESTAMP);
+}
+
+void Profiler::EndFrame() {
+    GpuState& gpu = Gpu();
+    if (!gpu.track) {
+        gpu.track = GetRegistry().Acquire();
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        gpu.track->name = "GPU";
+    }
+    gpu.Calibrate();
+    gpu.openZones.clear();
+
+    gpu.current = (gpu.current + 1) % GPU_FRAMES;
+    GpuFrame& frame = gpu.frames[gpu.current];
+
+    // A frame whose last query isn't done yet is dropped rather than waited on.
+    if (!frame.zones.empty()) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[frame.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            for (const GpuZone& zone : frame.zones) {
+                if (zone.endQuery == 0) continue;
+                GLuint64 start = 0, end = 0;
+                glGetQueryObjectui64v(zone.startQuery, GL_QUERY_RESULT, &start);
+                glGetQueryObjectui64v(zone.endQuery, GL_QUERY_RESULT, &end);
+                gpu.track->Push(zone.name, static_cast<std::uint64_t>(static_cast<std::int64_t>(start) - gpu.offsetNs),
+                                static_cast<std::uint64_t>(static_cast<std::int64_t>(end) - gpu.offsetNs));
+            }
+        }
+    }
+    frame.zones.clear();
+    frame.usedQueries = 0;
+}
+
+bool Profiler::WriteTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Failed to write trace " << path << std::endl;
+        return false;
+    }
+
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    std::size_t eventCount = 0;
+    for (const auto& buffer : registry.buffers) {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"";
+        WriteEscaped(out, buffer->name);
+        out << "\"}}";
+        first = false;
+
+        std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        std::uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY + EXPORT_MARGIN : 0;
+        for (std::uint64_t i = begin; i < head; i++) {
+            const ProfileEvent& event = buffer->events[i & (RING_CAPACITY - 1)];
+            // Chrome trace timestamps are microseconds.
+            out << ",\n{\"name\":\"";
+            WriteEscaped(out, event.name);
+            out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << event.startNs / 1000.0
+                << ",\"dur\":" << (event.endNs > event.startNs ? (event.endNs - event.startNs) / 1000.0 : 0.0) << "}";
+            eventCount++;
+        }
+    }
+    out << "\n]}\n";
+
+    std::cout << "Wrote " << eventCount << " profile events to " << path << std::endl;
+    return true;
+}
+
+#else
+
+bool Profiler::IsAvailable() { return false; }
+void Profiler::SetThreadName(const char*) {}
+void Profiler::Record(const char*, std::uint64_t, std::uint64_t) {}
+void Profiler::BeginGpuZone(const char*) {}
+void Profiler::EndGpuZone() {}
+void Profiler::EndFrame() {}
+bool Profiler::WriteTrace(const std::string&) { return false; }
+
+#endif
+
+std::uint64_t Profiler::NowNs() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count());
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Scoped CPU/GPU zone profiler, compiled in with -DMAZE_PROFILER=ON. Without it the macros below
+// expand to nothing and the Profiler calls are no-ops.
+//
+// CPU zones are recorded into per-thread ring buffers (single writer, no locks on the hot path).
+// GPU zones bracket GL work with GL_TIMESTAMP queries, double-buffered per frame so results are
+// read a frame late instead of stalling; they appear on their own "GPU" track.
+// WriteTrace() exports what the rings currently hold as Chrome trace / Perfetto JSON.
+//
+// Zone names must be string literals (or otherwise outlive the profiler): only the pointer is stored.
+#ifdef MAZE_PROFILER
+#define MAZE_PROFILE_CONCAT_INNER(a, b) a##b
+#define MAZE_PROFILE_CONCAT(a, b) MAZE_PROFILE_CONCAT_INNER(a, b)
+#define MAZE_PROFILE_SCOPE(name) ProfileScope MAZE_PROFILE_CONCAT(profileScope_, __COUNTER__)(name)
+#define MAZE_PROFILE_FUNCTION() MAZE_PROFILE_SCOPE(__func__)
+#define MAZE_PROFILE_GPU_SCOPE(name) GpuProfileScope MAZE_PROFILE_CONCAT(gpuProfileScope_, __COUNTER__)(name)
+#define MAZE_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define MAZE_PROFILE_SCOPE(name) ((void)0)
+#define MAZE_PROFILE_FUNCTION() ((void)0)
+#define MAZE_PROFILE_GPU_SCOPE(name) ((void)0)
+#define MAZE_PROFILE_THREAD(name) ((void)0)
+#endif
+
+class Profiler {
+public:
+    static bool IsAvailable();
+
+    static std::uint64_t NowNs();
+
+    static void SetThreadName(const char* name);
+    static void Record(const char* name, std::uint64_t startNs, std::uint64_t endNs);
+
+    // Render thread only, with the GL context current.
+    static void BeginGpuZone(const char* name);
+    static void EndGpuZone();
+    // Resolves the GPU zones of the previous frame; call once per frame after submission.
+    static void EndFrame();
+
+    static bool WriteTrace(const std::string& path);
+
+private:
+    Profiler() {}
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : m_Name(name), m_Start(Profiler::NowNs()) {}
+    ~ProfileScope() { Profiler::Record(m_Name, m_Start, Profiler::NowNs()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    std::uint64_t m_Start;
+};
+
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) { Profiler::BeginGpuZone(name); }
+    ~GpuProfileScope() { Profiler::EndGpuZone(); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+// Slot index into one of the resource tables plus the generation the slot had when the handle was
+// issued. Generations are odd while a slot is alive, so a default handle never resolves and a
+// handle to a released resource stays dead even after its slot is reused.
+template <typename Tag>
+struct ResourceHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    bool IsValid() const { return generation != 0; }
+    bool operator==(const ResourceHandle&) const = default;
+};
+
+struct TextureTag;
+struct ShaderTag;
+struct SoundTag;
+using TextureHandle = ResourceHandle<TextureTag>;
+using ShaderHandle = ResourceHandle<ShaderTag>;
+using SoundHandle = ResourceHandle<SoundTag>;
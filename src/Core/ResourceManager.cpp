@@ -1,55 +1,268 @@
 #include "ResourceManager.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 
+namespace {
+    // EXT_texture_compression_s3tc, not in the core-profile glad header.
+    constexpr GLenum GL_COMPRESSED_RGBA_S3TC_DXT1 = 0x83F1;
+    constexpr GLenum GL_COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
 
-std::unordered_map<std::string, unsigned int> ResourceManager::textures;
+    // Rows are uploaded in blocks of about this many bytes between budget checks.
+    constexpr std::size_t UPLOAD_CHUNK_BYTES = 1 << 20;
+    // Every texture streams in down to this size before any use is known, and never drops below it.
+    constexpr int STARTUP_MIP_SIZE = 64;
 
-unsigned int ResourceManager::LoadTexture(const std::string& name, const std::string& path) {
+    using UploadClock = std::chrono::steady_clock;
+    UploadClock::time_point uploadDeadline;
 
-    if (textures.find(name) != textures.end()) {
-        return textures[name];
+    bool PastDeadline() { return UploadClock::now() >= uploadDeadline; }
+    bool NeverOutOfTime() { return false; }
+}
+
+
+std::mutex ResourceManager::namesMutex;
+std::unordered_map<std::string, TextureHandle> ResourceManager::textureNames;
+std::unordered_map<std::string, ShaderHandle> ResourceManager::shaderNames;
+ResourcePool<ResourceManager::TextureEntry, TextureTag> ResourceManager::textures;
+ResourcePool<ResourceManager::ShaderEntry, ShaderTag> ResourceManager::shaders;
+std::size_t ResourceManager::textureBudget = std::size_t(512) << 20;
+std::size_t ResourceManager::residentBytes = 0;
+std::uint64_t ResourceManager::frameIndex = 1;
+std::atomic<bool> ResourceManager::compressedSupported{false};
+std::atomic<unsigned int> ResourceManager::placeholderTexture{0};
+
+void ResourceManager::Init() {
+    compressedSupported = SupportsS3TC();
+    if (placeholderTexture == 0) placeholderTexture = CreatePlaceholder();
+}
+
+TextureHandle ResourceManager::LoadTexture(const std::string& name, const std::string& path) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    auto found = textureNames.find(name);
+    if (found != textureNames.end()) {
+        textures.AddRef(found->second);
+        return found->second;
     }
 
+    MAZE_PROFILE_SCOPE("ResourceManager::LoadTexture");
+    const bool allowCompressed = compressedSupported.load(std::memory_order_relaxed);
+    TextureHandle handle = textures.Create(name, JobSystem::Shared().Submit([path, allowCompressed] {
+        return LoadOnWorker(path, allowCompressed);
+    }));
+    if (!handle.IsValid()) {
+        std::cerr << "ERROR: Texture table is full, cannot load " << path << std::endl;
+        return handle;
+    }
+    textureNames[name] = handle;
+    return handle;
+}
 
-    unsigned int id = LoadTextureFromFile(path);
-    textures[name] = id;
-    return id;
+void ResourceManager::ReleaseTexture(TextureHandle handle) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    const TextureEntry* entry = textures.Get(handle);
+    if (!entry) return;
+    std::string name = entry->name;
+    if (textures.Release(handle)) textureNames.erase(name);
 }
 
-unsigned int ResourceManager::GetTexture(const std::string& name) {
-    if (textures.find(name) != textures.end()) {
-        return textures[name];
+unsigned int ResourceManager::GetTextureId(TextureHandle handle) {
+    const TextureEntry* entry = textures.Get(handle);
+    if (!entry) return 0;
+    unsigned int id = entry->id.load(std::memory_order_acquire);
+    return id != 0 ? id : placeholderTexture.load(std::memory_order_relaxed);
+}
+
+ShaderHandle ResourceManager::LoadShader(const std::string& vertPath, const std::string& fragPath, const std::string& defines) {
+    const std::string key = vertPath + "|" + fragPath + "|" + defines;
+    std::lock_guard<std::mutex> lock(namesMutex);
+    auto found = shaderNames.find(key);
+    if (found != shaderNames.end()) {
+        shaders.AddRef(found->second);
+        return found->second;
     }
-    std::cerr << "WARNING: ResourceManager could not find texture: " << name << std::endl;
-    return 0;
+
+    Shader shader;
+    shader.Load(vertPath.c_str(), fragPath.c_str(), defines);
+    ShaderHandle handle = shaders.Create(ShaderEntry{key, std::move(shader)});
+    if (handle.IsValid()) shaderNames[key] = handle;
+    return handle;
 }
 
-void ResourceManager::Clear() {
-    for (auto& iter : textures) {
-        glDeleteTextures(1, &iter.second);
+void ResourceManager::ReleaseShader(ShaderHandle handle) {
+    std::lock_guard<std::mutex> lock(namesMutex);
+    const ShaderEntry* entry = shaders.Get(handle);
+    if (!entry) return;
+    std::string key = entry->key;
+    if (shaders.Release(handle)) shaderNames.erase(key);
+}
+
+Shader* ResourceManager::GetShader(ShaderHandle handle) {
+    ShaderEntry* entry = shaders.Get(handle);
+    return entry ? &entry->shader : nullptr;
+}
+
+void ResourceManager::NoteTextureUse(TextureHandle handle, float pixelsPerRepeat) {
+    TextureEntry* entry = textures.Get(handle);
+    if (!entry) return;
+    entry->usePixels = std::max(entry->usePixels, pixelsPerRepeat);
+    entry->lastUsedFrame = frameIndex;
+}
+
+std::size_t ResourceManager::LevelBytes(const TextureEntry& entry, int level) {
+    return entry.texture.levels[level].size;
+}
+
+// Picks up a finished load. Nothing is resident yet: the placeholder keeps showing until the first
+// (smallest) level is uploaded.
+bool ResourceManager::Resolve(TextureEntry& entry) {
+    if (entry.ready) return true;
+    if (entry.loading.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+    entry.texture = entry.loading.get();
+    entry.ready = true;
+    const int levelCount = static_cast<int>(entry.texture.levels.size());
+    entry.residentLevel = levelCount;
+    entry.floorLevel = 0;
+    while (entry.floorLevel + 1 < levelCount &&
+           std::max(entry.texture.levels[entry.floorLevel].width, entry.texture.levels[entry.floorLevel].height) > STARTUP_MIP_SIZE) {
+        entry.floorLevel++;
     }
-    textures.clear();
+    entry.wantedLevel = entry.floorLevel;
+    return true;
 }
 
-unsigned int ResourceManager::LoadTextureFromFile(const std::string& path) {
-    sf::Image image;
-    if (!image.loadFromFile(path)) {
-        std::cerr << "ERROR: Failed to load texture: " << path << std::endl;
-        return 0;
+void ResourceManager::ReleaseLevel(TextureEntry& entry) {
+    const int level = entry.residentLevel;
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level + 1);
+    // A 0x0 image releases the level's storage; BASE_LEVEL already excludes it.
+    if (entry.texture.format == TextureFormat::RGBA8) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    } else {
+        GLenum internalFormat = entry.texture.format == TextureFormat::BC1 ? GL_COMPRESSED_RGBA_S3TC_DXT1 : GL_COMPRESSED_RGBA_S3TC_DXT5;
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, 0, 0, 0, 0, nullptr);
     }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    residentBytes -= LevelBytes(entry, level);
+    entry.residentLevel++;
+}
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+// Frees finest levels until bytes more fit in the budget: detail nobody wants any more first, then
+// least recently used textures, but never one used as recently as the requester.
+bool ResourceManager::EvictFor(std::size_t bytes, const TextureEntry& requester) {
+    const std::uint64_t requesterFrame = requester.lastUsedFrame;
+    auto rank = [](const TextureEntry& entry) {
+        bool surplus = entry.residentLevel < entry.wantedLevel;
+        return std::make_pair(surplus ? 0 : 1, entry.lastUsedFrame);
+    };
+
+    while (residentBytes + bytes > textureBudget) {
+        TextureEntry* victim = nullptr;
+        textures.ForEach([&](TextureHandle, TextureEntry& entry) {
+            if (&entry == &requester || !entry.ready || entry.uploadRow > 0 || entry.residentLevel >= entry.floorLevel) return;
+            bool surplus = entry.residentLevel < entry.wantedLevel;
+            if (!surplus && entry.lastUsedFrame >= requesterFrame) return;
+            if (!victim || rank(entry) < rank(*victim)) victim = &entry;
+        });
+        if (!victim) return false;
+        ReleaseLevel(*victim);
+    }
+    return true;
+}
+
+void ResourceManager::PumpUploads(float budgetMs) {
+    MAZE_PROFILE_SCOPE("ResourceManager::PumpUploads");
+    uploadDeadline = UploadClock::now() + std::chrono::microseconds(static_cast<long long>(budgetMs * 1000.0f));
+    textures.CollectRetired(DestroyTexture);
+    shaders.CollectRetired([](ShaderEntry& entry) { glDeleteProgram(entry.shader.GetID()); });
+
+    // Wanted levels from last frame's uses: the level whose texels come closest to one per pixel.
+    std::vector<TextureEntry*> streaming;
+    textures.ForEach([&streaming](TextureHandle, TextureEntry& entry) {
+        if (entry.id == 0) entry.id = CreatePlaceholder();
+        if (!Resolve(entry) || entry.texture.levels.empty()) return;
+        if (entry.usePixels > 0.0f) {
+            const TextureLevelView& top = entry.texture.levels[0];
+            float texelsPerPixel = static_cast<float>(std::max(top.width, top.height)) / entry.usePixels;
+            int level = texelsPerPixel > 1.0f ? static_cast<int>(std::floor(std::log2(texelsPerPixel))) : 0;
+            entry.wantedLevel = std::min(level, entry.floorLevel);
+            entry.usePixels = 0.0f;
+        }
+        // A half-uploaded level is finished even if it is no longer wanted; it already holds its memory.
+        if (entry.residentLevel > entry.wantedLevel || entry.uploadRow > 0) streaming.push_back(&entry);
+    });
+    frameIndex++;
+
+    // Missing startup levels first, then the textures that are furthest from what they want.
+    std::sort(streaming.begin(), streaming.end(), [](const TextureEntry* a, const TextureEntry* b) {
+        bool aStartup = a->residentLevel > a->floorLevel;
+        bool bStartup = b->residentLevel > b->floorLevel;
+        if (aStartup != bStartup) return aStartup;
+        int aDeficit = a->residentLevel - a->wantedLevel;
+        int bDeficit = b->residentLevel - b->wantedLevel;
+        if (aDeficit != bDeficit) return aDeficit > bDeficit;
+        return a->lastUsedFrame > b->lastUsedFrame;
+    });
 
+    for (TextureEntry* entry : streaming) {
+        if (PastDeadline()) break;
+        while ((entry->residentLevel > entry->wantedLevel || entry->uploadRow > 0) && !PastDeadline()) {
+            const bool startup = entry->residentLevel > entry->floorLevel;
+            if (entry->uploadRow == 0 && !startup && !EvictFor(LevelBytes(*entry, entry->residentLevel - 1), *entry)) break;
+            UploadStep(*entry, PastDeadline);
+        }
+    }
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
-                 static_cast<int>(image.getSize().x),
-                 static_cast<int>(image.getSize().y),
-                 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixelsPtr());
+void ResourceManager::FinishLoading() {
+    MAZE_PROFILE_SCOPE("ResourceManager::FinishLoading");
+    textures.CollectRetired(DestroyTexture);
+    textures.ForEach([](TextureHandle, TextureEntry& entry) {
+        if (entry.id == 0) entry.id = CreatePlaceholder();
+        if (!entry.ready) entry.loading.wait();
+        Resolve(entry);
+        entry.wantedLevel = 0;
+        while (entry.residentLevel > 0) UploadStep(entry, NeverOutOfTime);
+    });
+}
+
+void ResourceManager::Clear() {
+    textures.Clear(DestroyTexture);
+    shaders.Clear([](ShaderEntry& entry) { glDeleteProgram(entry.shader.GetID()); });
+    residentBytes = 0;
 
-    glGenerateMipmap(GL_TEXTURE_2D);
+    std::lock_guard<std::mutex> lock(namesMutex);
+    textureNames.clear();
+    shaderNames.clear();
+    unsigned int placeholder = placeholderTexture.exchange(0);
+    glDeleteTextures(1, &placeholder);
+}
+
+// Everything from residentLevel down is resident, plus the level being uploaded if one is.
+// A load still in flight captures nothing of ours; its result is dropped with the future.
+void ResourceManager::DestroyTexture(TextureEntry& entry) {
+    if (entry.ready) {
+        const int levelCount = static_cast<int>(entry.texture.levels.size());
+        for (int level = entry.residentLevel; level < levelCount; level++) residentBytes -= LevelBytes(entry, level);
+        if (entry.uploadRow > 0) residentBytes -= LevelBytes(entry, entry.residentLevel - 1);
+    }
+    unsigned int id = entry.id;
+    glDeleteTextures(1, &id);
+}
 
+unsigned int ResourceManager::CreatePlaceholder() {
+    const std::uint8_t grey[4] = {128, 128, 128, 255};
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -57,4 +270,93 @@ unsigned int ResourceManager::LoadTextureFromFile(const std::string& path) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     return textureID;
-}
\ No newline at end of file
+}
+
+bool ResourceManager::SupportsS3TC() {
+    static const bool supported = [] {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (name && std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) return true;
+        }
+        return false;
+    }();
+    return supported;
+}
+
+// Worker thread. Mips are built here rather than with glGenerateMipmap so the GL thread only ever
+// copies texels.
+ResourceManager::LoadedTexture ResourceManager::LoadOnWorker(const std::string& path, bool allowCompressed) {
+    MAZE_PROFILE_SCOPE("ResourceManager::LoadOnWorker");
+    LoadedTexture loaded;
+
+    auto cache = std::make_unique<TextureCache>();
+    if (cache->Open(TextureCache::GetCachePath(path), path) &&
+        (allowCompressed || cache->GetFormat() == TextureFormat::RGBA8)) {
+        loaded.format = cache->GetFormat();
+        loaded.levels = cache->GetLevels();
+        loaded.cache = std::move(cache);
+        return loaded;
+    }
+
+    sf::Image image;
+    if (!image.loadFromFile(path) || image.getSize().x == 0 || image.getSize().y == 0) {
+        std::cerr << "ERROR: Failed to load texture: " << path << std::endl;
+        return loaded;
+    }
+
+    TextureImage base;
+    base.width = static_cast<int>(image.getSize().x);
+    base.height = static_cast<int>(image.getSize().y);
+    base.pixels.assign(image.getPixelsPtr(), image.getPixelsPtr() + static_cast<std::size_t>(base.width) * base.height * 4);
+
+    loaded.images = TextureCache::BuildMipChain(std::move(base));
+    for (const TextureImage& mip : loaded.images) {
+        loaded.levels.push_back({mip.width, mip.height, mip.pixels.data(), mip.pixels.size()});
+    }
+    return loaded;
+}
+
+// The next finer level is specified in full before BASE_LEVEL moves onto it, so sampling never
+// touches undefined texels. Uncompressed levels go up in row blocks; compressed ones are small
+// enough to go up whole.
+bool ResourceManager::UploadStep(TextureEntry& entry, bool (*outOfTime)()) {
+    const LoadedTexture& texture = entry.texture;
+    const int level = entry.residentLevel - 1;
+    const TextureLevelView& mip = texture.levels[level];
+
+    glBindTexture(GL_TEXTURE_2D, entry.id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (texture.format != TextureFormat::RGBA8) {
+        GLenum internalFormat = texture.format == TextureFormat::BC1 ? GL_COMPRESSED_RGBA_S3TC_DXT1 : GL_COMPRESSED_RGBA_S3TC_DXT5;
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, mip.width, mip.height, 0,
+                               static_cast<GLsizei>(mip.size), mip.data);
+        entry.uploadRow = mip.height;
+        residentBytes += mip.size;
+    } else {
+        if (entry.uploadRow == 0) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, mip.width, mip.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            residentBytes += mip.size;
+        }
+        const std::size_t rowBytes = static_cast<std::size_t>(mip.width) * 4;
+        while (entry.uploadRow < mip.height) {
+            int rows = std::min(mip.height - entry.uploadRow, static_cast<int>(std::max<std::size_t>(1, UPLOAD_CHUNK_BYTES / rowBytes)));
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, entry.uploadRow, mip.width, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+                            mip.data + entry.uploadRow * rowBytes);
+            entry.uploadRow += rows;
+            if (outOfTime()) break;
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    bool completed = entry.uploadRow == mip.height;
+    if (completed) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<int>(texture.levels.size()) - 1);
+        entry.residentLevel = level;
+        entry.uploadRow = 0;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return completed;
+}
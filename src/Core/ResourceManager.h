@@ -1,26 +1,118 @@
 #pragma once
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <future>
+#include <cstddef>
+#include <cstdint>
 #include <SFML/Graphics.hpp>
 #include <glad/glad.h>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include "ResourcePool.h"
+#include "../Graphics/Shader.h"
+#include "../Graphics/TextureCache.h"
 
+// Handle-based texture and shader tables with a texture residency manager on top.
+//
+// LoadTexture can be called from any thread and returns immediately with a counted handle; the
+// image is loaded on the JobSystem (a cooked <path>.mtex is mapped, otherwise the PNG is decoded
+// and mipmapped) and its mips are streamed in by PumpUploads(), which also creates the GL texture.
+// Until then it shows a grey placeholder. GetTextureId is a lock-free lookup meant to be done per
+// draw. Releasing the last handle queues the texture; PumpUploads deletes it on the GL thread.
+//
+// Only the levels from GL_TEXTURE_BASE_LEVEL down are resident. Textures start at a small mip and
+// get finer levels as NoteTextureUse() reports them up close on screen. When the resident total
+// would exceed the budget, the finest levels of the least recently used textures are released.
 class ResourceManager {
 public:
+    // GL thread, once the context exists and before the first load.
+    static void Init();
 
-    static unsigned int LoadTexture(const std::string& name, const std::string& path);
+    // Loading a name that is already loaded adds a reference to the existing texture.
+    static TextureHandle LoadTexture(const std::string& name, const std::string& path);
+    static void ReleaseTexture(TextureHandle handle);
+    // 0 for a dead handle; the shared placeholder until PumpUploads has created the texture.
+    static unsigned int GetTextureId(TextureHandle handle);
 
+    // GL thread. Same-source shaders are shared.
+    static ShaderHandle LoadShader(const std::string& vertPath, const std::string& fragPath, const std::string& defines = "");
+    static void ReleaseShader(ShaderHandle handle);
+    static Shader* GetShader(ShaderHandle handle);
 
-    static unsigned int GetTexture(const std::string& name);
+    static void SetTextureBudget(std::size_t bytes) { textureBudget = bytes; }
 
+    // Render thread: the texture is visible this frame, one texture repeat covering about this many
+    // screen pixels. Decides the finest mip worth keeping.
+    static void NoteTextureUse(TextureHandle handle, float pixelsPerRepeat);
 
+    // GL thread, once per frame: deletes released resources, updates residency and uploads texels
+    // for up to budgetMs.
+    static void PumpUploads(float budgetMs);
+    // Blocks until every texture is fully resident, budget or not (benchmarks, tools).
+    static void FinishLoading();
+
+    // GL thread, shutdown: destroys everything, outstanding handles or not.
     static void Clear();
 
 private:
 
     ResourceManager() {}
 
+    // Levels point either into images (decoded PNG) or into the mapped cache file. Both are kept
+    // so evicted levels can be streamed back in.
+    struct LoadedTexture {
+        TextureFormat format = TextureFormat::RGBA8;
+        std::vector<TextureLevelView> levels;
+        std::vector<TextureImage> images;
+        std::unique_ptr<TextureCache> cache;
+    };
+
+    struct TextureEntry {
+        TextureEntry(std::string name, std::future<LoadedTexture> loading)
+            : name(std::move(name)), loading(std::move(loading)) {}
+
+        std::string name;
+        std::atomic<unsigned int> id{0};
+        std::future<LoadedTexture> loading;
+        LoadedTexture texture;
+        bool ready = false;
+        int residentLevel = 0;      // == BASE_LEVEL; level count while nothing is resident
+        int uploadRow = 0;          // rows of residentLevel - 1 already uploaded
+        int floorLevel = 0;         // coarsest level kept resident no matter what
+        int wantedLevel = 0;
+        float usePixels = 0.0f;     // largest footprint noted since the last pump
+        std::uint64_t lastUsedFrame = 0;
+    };
+
+    struct ShaderEntry {
+        std::string key;
+        Shader shader;
+    };
+
+    // Name lookups happen on load and release only; the mutex also orders a last Release against
+    // a concurrent load of the same name.
+    static std::mutex namesMutex;
+    static std::unordered_map<std::string, TextureHandle> textureNames;
+    static std::unordered_map<std::string, ShaderHandle> shaderNames;
+    static ResourcePool<TextureEntry, TextureTag> textures;
+    static ResourcePool<ShaderEntry, ShaderTag> shaders;
+    static std::size_t textureBudget;
+    static std::size_t residentBytes;
+    static std::uint64_t frameIndex;
+    static std::atomic<bool> compressedSupported;
+    static std::atomic<unsigned int> placeholderTexture;
 
-    static std::unordered_map<std::string, unsigned int> textures;
+    static unsigned int CreatePlaceholder();
+    static void DestroyTexture(TextureEntry& entry);
+    static bool SupportsS3TC();
+    static LoadedTexture LoadOnWorker(const std::string& path, bool allowCompressed);
 
-    static unsigned int LoadTextureFromFile(const std::string& path);
-};
\ No newline at end of file
+    static std::size_t LevelBytes(const TextureEntry& entry, int level);
+    static bool Resolve(TextureEntry& entry);
+    static bool EvictFor(std::size_t bytes, const TextureEntry& requester);
+    static void ReleaseLevel(TextureEntry& entry);
+    // Uploads part of the next finer level; returns true when that level became resident.
+    static bool UploadStep(TextureEntry& entry, bool (*outOfTime)());
+};
@@ -0,0 +1,148 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "ResourceHandle.h"
+
+// Reference-counted slot table behind a ResourceHandle type. Slots live in fixed pages and never
+// move, so Get() is lock-free: two acquire loads and a generation compare. Create() and Release()
+// may be called from any thread. Dropping the last reference kills the handle at once but leaves
+// the value in place until the owning thread calls CollectRetired(), which is where GL objects
+// get deleted.
+//
+// Get() is only safe on a handle the caller holds a reference to; otherwise the value could be
+// collected under it.
+template <typename T, typename Tag>
+class ResourcePool {
+public:
+    using Handle = ResourceHandle<Tag>;
+    static constexpr std::uint32_t PAGE_SIZE = 256;
+    static constexpr std::uint32_t MAX_PAGES = 64;
+
+    ResourcePool() = default;
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    // Returns an invalid handle once every page is in use. The new handle holds one reference.
+    template <typename... Args>
+    Handle Create(Args&&... args) {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::uint32_t index;
+        if (!m_Free.empty()) {
+            index = m_Free.back();
+            m_Free.pop_back();
+        } else {
+            index = m_Count.load(std::memory_order_relaxed);
+            if (index / PAGE_SIZE >= MAX_PAGES) return {};
+            if (index % PAGE_SIZE == 0) {
+                m_Storage.push_back(std::make_unique<Slot[]>(PAGE_SIZE));
+                m_Pages[index / PAGE_SIZE].store(m_Storage.back().get(), std::memory_order_release);
+            }
+            m_Count.store(index + 1, std::memory_order_release);
+        }
+
+        Slot& slot = SlotAt(index);
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.refs.store(1, std::memory_order_relaxed);
+        const std::uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        return {index, generation};
+    }
+
+    T* Get(Handle handle) const {
+        Slot* slot = Find(handle);
+        return slot ? &*slot->value : nullptr;
+    }
+
+    void AddRef(Handle handle) {
+        if (Slot* slot = Find(handle)) slot->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns true when this dropped the last reference.
+    bool Release(Handle handle) {
+        Slot* slot = Find(handle);
+        if (!slot || slot->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return false;
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        slot->generation.fetch_add(1, std::memory_order_release);
+        m_Retired.push_back(handle.index);
+        return true;
+    }
+
+    // Owning thread. Slots created concurrently may or may not be visited.
+    template <typename Visit>
+    void ForEach(Visit&& visit) {
+        const std::uint32_t count = m_Count.load(std::memory_order_acquire);
+        for (std::uint32_t index = 0; index < count; index++) {
+            Slot& slot = SlotAt(index);
+            const std::uint32_t generation = slot.generation.load(std::memory_order_acquire);
+            if (generation & 1u) visit(Handle{index, generation}, *slot.value);
+        }
+    }
+
+    // Owning thread: hands every released value to destroy, then frees its slot for reuse.
+    template <typename Destroy>
+    void CollectRetired(Destroy&& destroy) {
+        std::vector<std::uint32_t> retired;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            retired.swap(m_Retired);
+        }
+        if (retired.empty()) return;
+
+        for (std::uint32_t index : retired) {
+            Slot& slot = SlotAt(index);
+            destroy(*slot.value);
+            slot.value.reset();
+        }
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Free.insert(m_Free.end(), retired.begin(), retired.end());
+    }
+
+    // Owning thread, shutdown: retires everything regardless of outstanding references.
+    template <typename Destroy>
+    void Clear(Destroy&& destroy) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const std::uint32_t count = m_Count.load(std::memory_order_relaxed);
+            for (std::uint32_t index = 0; index < count; index++) {
+                Slot& slot = SlotAt(index);
+                if (!(slot.generation.load(std::memory_order_relaxed) & 1u)) continue;
+                slot.refs.store(0, std::memory_order_relaxed);
+                slot.generation.fetch_add(1, std::memory_order_release);
+                m_Retired.push_back(index);
+            }
+        }
+        CollectRetired(std::forward<Destroy>(destroy));
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::uint32_t> generation{0};
+        std::atomic<int> refs{0};
+        std::optional<T> value;
+    };
+
+    Slot& SlotAt(std::uint32_t index) const {
+        return m_Pages[index / PAGE_SIZE].load(std::memory_order_acquire)[index % PAGE_SIZE];
+    }
+
+    Slot* Find(Handle handle) const {
+        if (!handle.IsValid() || handle.index >= m_Count.load(std::memory_order_acquire)) return nullptr;
+        Slot& slot = SlotAt(handle.index);
+        return slot.generation.load(std::memory_order_acquire) == handle.generation ? &slot : nullptr;
+    }
+
+    std::array<std::atomic<Slot*>, MAX_PAGES> m_Pages{};
+    std::atomic<std::uint32_t> m_Count{0};
+
+    std::mutex m_Mutex;
+    std::vector<std::unique_ptr<Slot[]>> m_Storage;
+    std::vector<std::uint32_t> m_Free;
+    std::vector<std::uint32_t> m_Retired;
+};
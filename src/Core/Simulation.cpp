@@ -0,0 +1,376 @@
+#include "Simulation.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    // Far enough that a typical preload finishes before the player reaches the paper.
+    constexpr float PRELOAD_DISTANCE = 8.0f;
+    // Built by the cook_sounds target; without it effects load from their source files.
+    constexpr const char* SOUND_BANK_PATH = "assets/sounds/effects.msbk";
+}
+
+Simulation::Simulation(std::vector<std::string> levelPaths, std::size_t soundCacheBytes)
+    : m_State(GameState::MENU),
+      m_PauseMenuSelection(0),
+      m_AudioStopped(false),
+      m_CursorGrabbed(false),
+      m_CloseRequested(false),
+      m_PlayerStartPos(0.0f),
+      m_PaperPos(0.0f),
+      m_GeometryRevision(0),
+      m_LevelPaths(std::move(levelPaths)),
+      m_LevelIndex(0),
+      m_LevelSerial(0),
+      m_FirstLevelPending(false),
+      m_StartWhenLoaded(false)
+{
+    std::random_device rd;
+    m_RNG = std::mt19937(rd());
+
+    if (m_LevelPaths.empty()) throw std::runtime_error("FATAL: No levels to play");
+    // A fresh checkout bakes the first lightmap here; the menu shows while it does.
+    PrepareFirstLevel();
+
+    m_Audio = std::make_unique<AudioManager>();
+    m_Player = std::make_unique<Player>(m_PlayerStartPos);
+    m_Audio->SetPcmCacheBudget(soundCacheBytes);
+    m_Audio->LoadBank(SOUND_BANK_PATH);
+
+    m_Sounds.footstep = m_Audio->LoadSound("footstep", "assets/sounds/footstep.wav", {SoundPriority::LOW, 2});
+    m_Sounds.hum = m_Audio->LoadSound("hum", "assets/sounds/fluorescent_hum.wav", {SoundPriority::HIGH, 1});
+    m_Sounds.win = m_Audio->LoadSound("win", "assets/sounds/win.wav", {SoundPriority::CRITICAL, 2});
+    m_Sounds.lose = m_Audio->LoadSound("lose", "assets/sounds/lose.wav", {SoundPriority::CRITICAL, 1});
+    m_Sounds.flicker = m_Audio->LoadSound("flicker", "assets/sounds/flicker.wav", {SoundPriority::NORMAL, 1});
+    m_Sounds.click = m_Audio->LoadSound("click", "assets/sounds/flashlight_click.wav", {SoundPriority::NORMAL, 2});
+    m_Player->SetSounds(m_Sounds.click, m_Sounds.footstep);
+    m_Sounds.ambience = m_Audio->LoadMusic("assets/sounds/ambience.ogg");
+
+    m_Audio->PlayMusic(m_Sounds.ambience, 25.0f);
+}
+
+// Every level shares these sounds, so they go back only with the simulation.
+Simulation::~Simulation() {
+    for (SoundHandle sound : {m_Sounds.footstep, m_Sounds.hum, m_Sounds.win, m_Sounds.lose, m_Sounds.flicker, m_Sounds.click}) {
+        m_Audio->ReleaseSound(sound);
+    }
+}
+
+bool Simulation::FinishLoading() {
+    if (m_FirstLevelPending) TakeFirstLevel();
+    return m_Map != nullptr;
+}
+
+// Level 0 is prepared on the JobSystem both at launch and for a restart after a win, so neither
+// stalls the simulation thread.
+void Simulation::PrepareFirstLevel() {
+    std::string path = m_LevelPaths[0];
+    m_NextLevel = JobSystem::Shared().Submit([path] { return PrepareLevel(path); });
+    m_FirstLevelPending = true;
+}
+
+// Blocks until level 0 is prepared, then swaps it in and starts the run if one was asked for
+// meanwhile. A level that fails to load closes the game at launch; on a restart the current
+// level is replayed instead.
+void Simulation::TakeFirstLevel() {
+    m_FirstLevelPending = false;
+    PreparedLevel first = m_NextLevel.get();
+    if (first.map) {
+        m_LevelIndex = 0;
+        ApplyLevel(std::move(first));
+        m_Player->Reset(m_PlayerStartPos);
+        m_Audio->PlaySpatial(m_Sounds.hum, m_PaperPos, 100.0f, 1.5f);
+    } else if (m_Map) {
+        std::cerr << "ERROR: Failed to load " << first.path << ", replaying the current level" << std::endl;
+    } else {
+        std::cerr << "ERROR: Failed to load " << first.path << std::endl;
+        m_CloseRequested = true;
+    }
+
+    if (m_StartWhenLoaded && m_Map) StartRun();
+    m_StartWhenLoaded = false;
+}
+
+void Simulation::Step(const InputState& input, float dt, FrameSnapshot& out) {
+    MAZE_PROFILE_SCOPE("Simulation::Step");
+    sf::Clock stepClock;
+
+    if (m_FirstLevelPending && m_NextLevel.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        TakeFirstLevel();
+    }
+    HandleKeyPresses(input);
+    if (m_Map) {
+        Update(input, dt);
+        if (m_Map->GetRevision() != m_GeometryRevision) RebuildGeometry();
+    }
+
+    FillSnapshot(out);
+    out.simMs = stepClock.getElapsedTime().asSeconds() * 1000.0f;
+}
+
+void Simulation::HandleKeyPresses(const InputState& input) {
+    for (sf::Keyboard::Scancode key : input.pressedKeys) {
+        if (key == sf::Keyboard::Scan::Escape) {
+            if (m_State == GameState::PLAYING) {
+                m_State = GameState::PAUSED;
+                m_Audio->PlayGlobal(m_Sounds.click, 50.0f);
+                m_CursorGrabbed = false;
+            } else if (m_State == GameState::PAUSED) {
+                m_State = GameState::PLAYING;
+                m_Audio->PlayGlobal(m_Sounds.click, 50.0f);
+                m_CursorGrabbed = true;
+            }
+        }
+
+        if (m_State == GameState::PAUSED) {
+            if (key == sf::Keyboard::Scan::W || key == sf::Keyboard::Scan::Up) {
+                m_PauseMenuSelection--;
+                if (m_PauseMenuSelection < 0) m_PauseMenuSelection = 2;
+                m_Audio->PlayGlobal(m_Sounds.click, 50.0f);
+            }
+            if (key == sf::Keyboard::Scan::S || key == sf::Keyboard::Scan::Down) {
+                m_PauseMenuSelection++;
+                if (m_PauseMenuSelection > 2) m_PauseMenuSelection = 0;
+                m_Audio->PlayGlobal(m_Sounds.click, 50.0f);
+            }
+            if (key == sf::Keyboard::Scan::Enter) {
+                m_Audio->PlayGlobal(m_Sounds.click, 80.0f);
+                if (m_PauseMenuSelection == 0) {
+                    m_State = GameState::PLAYING;
+                    m_CursorGrabbed = true;
+                }
+                else if (m_PauseMenuSelection == 1) {
+                    ResetGame();
+                }
+                else if (m_PauseMenuSelection == 2) {
+                    m_CloseRequested = true;
+                }
+            }
+        }
+
+        if ((m_State == GameState::MENU || m_State == GameState::GAME_OVER || m_State == GameState::WIN) &&
+            key == sf::Keyboard::Scan::Enter) {
+            ResetGame();
+        }
+    }
+
+    if (m_State == GameState::MENU && input.mouseLeft) {
+        ResetGame();
+    }
+}
+
+void Simulation::ResetGame() {
+    // A finished campaign starts over from its first level.
+    if (m_State == GameState::WIN && !m_FirstLevelPending) PrepareFirstLevel();
+    if (m_FirstLevelPending) {
+        m_StartWhenLoaded = true;
+        return;
+    }
+    StartRun();
+}
+
+void Simulation::StartRun() {
+    m_State = GameState::PLAYING;
+    m_Player->Reset(m_PlayerStartPos);
+    m_Explored.Clear();
+    m_CursorGrabbed = true;
+
+    m_Audio->StopAllSounds();
+    m_AudioStopped = false;
+    m_Audio->PlayMusic(m_Sounds.ambience, 25.0f);
+    m_Audio->PlaySpatial(m_Sounds.hum, m_PaperPos, 100.0f, 1.5f);
+}
+
+void Simulation::Update(const InputState& input, float dt) {
+    m_Audio->UpdateListener(m_Player->GetPosition(), m_Player->GetFront(), glm::vec3(0,1,0));
+
+    if (m_State == GameState::GAME_OVER || m_State == GameState::WIN) {
+        if (!m_AudioStopped) {
+            m_Audio->StopAllSounds();
+            m_AudioStopped = true;
+            if (m_State == GameState::WIN) m_Audio->PlayGlobal(m_Sounds.win, 100.0f);
+            if (m_State == GameState::GAME_OVER) m_Audio->PlayGlobal(m_Sounds.lose, 100.0f);
+        }
+    } else {
+        if (m_State == GameState::PLAYING) m_AudioStopped = false;
+    }
+
+    if (m_State == GameState::PLAYING) {
+        m_Player->HandleInput(input, dt, *m_Audio);
+        m_Player->Update(input, dt, *m_Map, *m_Audio);
+
+        if (m_Player->GetBattery() < 20.0f && m_Player->GetBattery() > 0.0f && m_Player->IsFlashlightOn()) {
+            std::uniform_int_distribution<int> chance(0, 40);
+            if (chance(m_RNG) == 0) {
+                m_Audio->PlayGlobal(m_Sounds.flicker, 60.0f);
+            }
+        }
+
+        m_InteractPrompt.clear();
+        auto ray = m_Map->CastRay(m_Player->GetEyePosition(), m_Player->GetFront(), 3.0f);
+
+        if (ray.hit) {
+            if (ray.tileType == 2) {
+                m_InteractPrompt = "[E] Open Door";
+                if (input.interact) {
+                    m_Map->SetTile(ray.tileX, ray.tileZ, 3);
+                    m_Explored.MarkTileChanged(ray.tileX, ray.tileZ);
+                    m_Audio->SetPropagationTile(ray.tileX, ray.tileZ, 3);
+                    m_Audio->PlaySpatial(m_Sounds.footstep, {ray.tileX, 1.5, ray.tileZ});
+                }
+            }
+            else if (ray.tileType == 5) {
+                if (m_Player->HasRedKey()) {
+                    m_InteractPrompt = "[E] UNLOCK Door";
+                    if (input.interact) {
+                        m_Map->SetTile(ray.tileX, ray.tileZ, 3);
+                        m_Explored.MarkTileChanged(ray.tileX, ray.tileZ);
+                        m_Audio->SetPropagationTile(ray.tileX, ray.tileZ, 3);
+                        m_Audio->PlaySpatial(m_Sounds.footstep, {ray.tileX, 1.5, ray.tileZ});
+                    }
+                } else {
+                    m_InteractPrompt = "LOCKED [Requires Access Key]";
+                }
+            }
+        }
+
+        int playerX = static_cast<int>(std::round(m_Player->GetPosition().x - 0.5f));
+        int playerZ = static_cast<int>(std::round(m_Player->GetPosition().z - 0.5f));
+        if (m_Map->GetTile(playerX, playerZ) == 4) {
+            m_Player->PickUpRedKey();
+            m_Map->SetTile(playerX, playerZ, 0);
+            m_Audio->SetPropagationTile(playerX, playerZ, 0);
+            m_Audio->PlayGlobal(m_Sounds.win, 70.0f);
+        }
+
+        m_Explored.Reveal(*m_Map, m_Player->GetPosition());
+
+        float paperDistance = glm::distance(m_Player->GetPosition(), m_PaperPos);
+        if (paperDistance < PRELOAD_DISTANCE) PreloadNextLevel();
+
+        if (paperDistance < 1.0f) {
+            if (AdvanceLevel()) {
+                m_Audio->PlayGlobal(m_Sounds.win, 70.0f);
+            } else {
+                m_State = GameState::WIN;
+                m_Audio->StopAllSounds();
+                m_Audio->PlayGlobal(m_Sounds.win, 100.0f);
+                m_CursorGrabbed = false;
+            }
+        }
+        if (m_Player->IsDead()) {
+            m_State = GameState::GAME_OVER;
+            m_Audio->StopAllSounds();
+            m_Audio->PlayGlobal(m_Sounds.lose, 100.0f);
+            m_CursorGrabbed = false;
+        }
+    }
+}
+
+void Simulation::RebuildGeometry() {
+    m_Geometry = std::make_shared<const MazeGeometry>(MazeGeometry::Build(*m_Map));
+    m_GeometryRevision = m_Map->GetRevision();
+}
+
+void Simulation::PreloadNextLevel() {
+    if (m_NextLevel.valid() || m_LevelIndex + 1 >= m_LevelPaths.size()) return;
+    std::string path = m_LevelPaths[m_LevelIndex + 1];
+    m_NextLevel = JobSystem::Shared().Submit([path] { return PrepareLevel(path); });
+}
+
+// Only blocks if the player outran the preload; a level that fails to load ends this run, and the
+// next run tries it again.
+bool Simulation::AdvanceLevel() {
+    if (m_LevelIndex + 1 >= m_LevelPaths.size()) return false;
+    MAZE_PROFILE_SCOPE("Simulation::AdvanceLevel");
+    PreloadNextLevel();
+    PreparedLevel next = m_NextLevel.get();
+    if (!next.map) {
+        std::cerr << "ERROR: Failed to load " << next.path << ", ending the run here" << std::endl;
+        return false;
+    }
+
+    m_LevelIndex++;
+    ApplyLevel(std::move(next));
+    m_Player->EnterLevel(m_PlayerStartPos);
+
+    m_Audio->StopSounds();
+    m_Audio->PlaySpatial(m_Sounds.hum, m_PaperPos, 100.0f, 1.5f);
+    return true;
+}
+
+// The previous level's map goes away here; snapshots still in flight keep its geometry alive.
+void Simulation::ApplyLevel(PreparedLevel level) {
+    m_Map = std::move(level.map);
+    m_PlayerStartPos = level.playerStart;
+    m_PaperPos = level.paperPos;
+    m_Geometry = std::move(level.geometry);
+    m_Lightmap = std::move(level.lightmap);
+    m_GeometryRevision = m_Map->GetRevision();
+    m_Explored.Resize(m_Map->GetWidth(), m_Map->GetHeight());
+    m_Audio->SetPropagation(std::move(level.propagation));
+    m_LevelSerial++;
+}
+
+PreparedLevel Simulation::PrepareLevel(const std::string& path) {
+    MAZE_PROFILE_SCOPE("Simulation::PrepareLevel");
+    PreparedLevel level;
+    level.path = path;
+    auto map = std::make_unique<Map>();
+    if (!map->LoadLevel(path, level.playerStart, level.paperPos)) return level;
+
+    level.propagation = std::make_unique<SoundPropagation>();
+    level.propagation->Reset(*map);
+    auto geometry = std::make_shared<const MazeGeometry>(MazeGeometry::Build(*map));
+    level.lightmap = std::make_shared<const LightmapData>(LightmapBaker::LoadOrBake(path, *map, geometry->staticLights));
+    level.geometry = std::move(geometry);
+    level.map = std::move(map);
+    return level;
+}
+
+void Simulation::FillSnapshot(FrameSnapshot& out) {
+    out.state = m_State;
+    out.pauseSelection = m_PauseMenuSelection;
+    out.interactPrompt = m_InteractPrompt;
+
+    out.view = m_Player->GetViewMatrix();
+    out.viewPos = m_Player->GetPosition();
+    out.front = m_Player->GetFront();
+    out.flashlightPos = m_Player->GetFlashlightPosition();
+    out.fov = m_Player->GetCurrentFOV();
+
+    float flashInt = (m_Player->IsFlashlightOn() && m_Player->GetBattery() > 0.0f) ? 1.0f : 0.0f;
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    if (m_Player->GetBattery() < 20.0f) flashInt *= (dist(m_RNG) > 0.9f ? 0.2f : 1.0f);
+    out.flashIntensity = flashInt;
+
+    out.battery = m_Player->GetBattery();
+    out.stamina = m_Player->GetStamina();
+    out.hasRedKey = m_Player->HasRedKey();
+
+    out.time = m_GameTime.getElapsedTime().asSeconds();
+    out.paperPos = m_PaperPos;
+    out.levelSerial = m_LevelSerial;
+
+    // Until the first level is ready only the menu is drawn.
+    if (m_Geometry) {
+        out.keyPositions = m_Geometry->keyPositions;
+
+        out.frameLights = m_Geometry->dynamicLights;
+        std::uniform_real_distribution<float> flickerRoll(0.0f, 1.0f);
+        for (auto& light : out.frameLights) {
+            if (flickerRoll(m_RNG) > 0.97f) light.intensity *= 0.3f;
+        }
+
+        out.geometry = m_Geometry;
+        out.mapRevision = m_GeometryRevision;
+        out.lightmap = m_Lightmap;
+        m_Explored.Flush(*m_Map, out.minimap);
+    }
+
+    out.cursorGrabbed = m_CursorGrabbed;
+    out.closeRequested = m_CloseRequested;
+}
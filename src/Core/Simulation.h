@@ -0,0 +1,90 @@
+#pragma once
+#include <SFML/System/Clock.hpp>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AudioManager.h"
+#include "FrameSnapshot.h"
+#include "InputState.h"
+#include "../Entities/Map.h"
+#include "../Entities/ExploredMap.h"
+#include "../Entities/SoundPropagation.h"
+#include "../Entities/Player.h"
+#include "../Graphics/LightmapBaker.h"
+
+// Everything a level needs before it can be played, built off the simulation thread.
+struct PreparedLevel {
+    std::string path;
+    std::unique_ptr<Map> map;
+    glm::vec3 playerStart{0.0f};
+    glm::vec3 paperPos{0.0f};
+    std::shared_ptr<const MazeGeometry> geometry;
+    std::shared_ptr<const LightmapData> lightmap;
+    std::unique_ptr<SoundPropagation> propagation;
+};
+
+// Game logic half of the frame: input handling, player physics, interactions, audio and the
+// game state machine. Runs on the SimulationThread and publishes FrameSnapshots; owns no GL state.
+// Levels play in campaign order, the first one prepared on the JobSystem while the menu shows; nearing the paper starts preparing the next one on the JobSystem,
+// reaching it swaps the prepared level in within a single step. At most one level is held in reserve.
+class Simulation {
+public:
+    Simulation(std::vector<std::string> levelPaths, std::size_t soundCacheBytes);
+    ~Simulation();
+
+    void Step(const InputState& input, float dt, FrameSnapshot& out);
+
+    // Blocks until the first level, prepared on the JobSystem, is in play and returns false if it
+    // failed to load. Step() picks it up on its own; call this only while the simulation thread is idle.
+    bool FinishLoading();
+
+private:
+    void HandleKeyPresses(const InputState& input);
+    void Update(const InputState& input, float dt);
+    void ResetGame();
+    void StartRun();
+    void PrepareFirstLevel();
+    void TakeFirstLevel();
+    void RebuildGeometry();
+    void PreloadNextLevel();
+    bool AdvanceLevel();
+    void ApplyLevel(PreparedLevel level);
+    static PreparedLevel PrepareLevel(const std::string& path);
+    void FillSnapshot(FrameSnapshot& out);
+
+    std::unique_ptr<Map> m_Map;
+    ExploredMap m_Explored;
+    std::unique_ptr<Player> m_Player;
+    std::unique_ptr<AudioManager> m_Audio;
+    struct Sounds {
+        SoundHandle footstep, hum, win, lose, flicker, click;
+        int ambience = -1;
+    } m_Sounds;
+    std::mt19937 m_RNG;
+    sf::Clock m_GameTime;
+
+    GameState m_State;
+    int m_PauseMenuSelection;
+    bool m_AudioStopped;
+    bool m_CursorGrabbed;
+    bool m_CloseRequested;
+    std::string m_InteractPrompt;
+
+    glm::vec3 m_PlayerStartPos;
+    glm::vec3 m_PaperPos;
+
+    std::shared_ptr<const MazeGeometry> m_Geometry;
+    std::shared_ptr<const LightmapData> m_Lightmap;
+    unsigned int m_GeometryRevision;
+
+    std::vector<std::string> m_LevelPaths;
+    std::size_t m_LevelIndex;
+    unsigned int m_LevelSerial;
+    std::future<PreparedLevel> m_NextLevel;
+    // m_NextLevel holds level 0, for the first launch or a restart after a win.
+    bool m_FirstLevelPending;
+    bool m_StartWhenLoaded;
+};
@@ -0,0 +1,61 @@
+#include "SimulationThread.h"
+#include "Profiler.h"
+
+SimulationThread::SimulationThread(Simulation& simulation)
+    : m_Simulation(simulation), m_HasWork(false), m_WorkDone(false), m_Quit(false), m_Dt(0.0f), m_Front(0)
+{
+    m_Thread = std::thread(&SimulationThread::Loop, this);
+}
+
+SimulationThread::~SimulationThread() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Quit = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+}
+
+void SimulationThread::Kick(const InputState& input, float dt) {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Input = input;
+        m_Dt = dt;
+        m_HasWork = true;
+        m_WorkDone = false;
+    }
+    m_Condition.notify_all();
+}
+
+const FrameSnapshot& SimulationThread::Wait() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return m_WorkDone; });
+    m_WorkDone = false;
+    m_Front = 1 - m_Front;
+    return m_Snapshots[m_Front];
+}
+
+void SimulationThread::Loop() {
+    MAZE_PROFILE_THREAD("Simulation");
+    while (true) {
+        InputState input;
+        float dt;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this] { return m_HasWork || m_Quit; });
+            if (m_Quit) return;
+            m_HasWork = false;
+            input = std::move(m_Input);
+            dt = m_Dt;
+        }
+
+        // The back buffer is never read by the main thread until the Wait() that flips it.
+        m_Simulation.Step(input, dt, m_Snapshots[1 - m_Front]);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_WorkDone = true;
+        }
+        m_Condition.notify_all();
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "FrameSnapshot.h"
+#include "InputState.h"
+#include "Simulation.h"
+
+// Runs Simulation::Step for frame N+1 on a worker while the main thread renders frame N.
+// Snapshots are double-buffered: Wait() flips them, so the one it returns stays untouched
+// until the next Wait().
+class SimulationThread {
+public:
+    explicit SimulationThread(Simulation& simulation);
+    ~SimulationThread();
+
+    void Kick(const InputState& input, float dt);
+    const FrameSnapshot& Wait();
+
+private:
+    void Loop();
+
+    Simulation& m_Simulation;
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_HasWork;
+    bool m_WorkDone;
+    bool m_Quit;
+
+    InputState m_Input;
+    float m_Dt;
+    FrameSnapshot m_Snapshots[2];
+    int m_Front;
+};
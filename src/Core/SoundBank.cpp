@@ -0,0 +1,224 @@
+#include "SoundBank.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr std::uint32_t BANK_MAGIC = 0x4B42534D; // "MSBK"
+    constexpr std::uint32_t BANK_VERSION = 1;
+    constexpr std::size_t DATA_ALIGNMENT = 16;
+    constexpr std::size_t NAME_SIZE = 48;
+
+    struct BankHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t count;
+        std::uint32_t reserved;
+    };
+
+    struct BankEntry {
+        char name[NAME_SIZE];
+        std::uint32_t sampleRate;
+        std::uint32_t channels;
+        std::uint64_t frames;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    constexpr int STEP_TABLE[89] = {
+        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+        50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+        337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+        2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+        15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+    };
+    constexpr int INDEX_TABLE[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+    // Per channel: 4 header bytes (first sample, step index, pad), then one nibble per later frame.
+    std::size_t BlockBytes(std::uint64_t frames, unsigned int channels) {
+        return channels * (4 + static_cast<std::size_t>(frames / 2));
+    }
+
+    std::size_t EncodedSize(std::uint64_t frames, unsigned int channels) {
+        const std::uint64_t fullBlocks = frames / SoundBank::BLOCK_FRAMES;
+        const std::uint64_t tail = frames % SoundBank::BLOCK_FRAMES;
+        return static_cast<std::size_t>(fullBlocks) * BlockBytes(SoundBank::BLOCK_FRAMES, channels) + (tail ? BlockBytes(tail, channels) : 0);
+    }
+
+    struct AdpcmState {
+        int predictor = 0;
+        int index = 0;
+
+        // Shared by encoder and decoder, so the encoder predicts exactly what playback will hear.
+        void Apply(int nibble) {
+            int step = STEP_TABLE[index];
+            int delta = step >> 3;
+            if (nibble & 4) delta += step;
+            if (nibble & 2) delta += step >> 1;
+            if (nibble & 1) delta += step >> 2;
+            predictor = std::clamp(predictor + ((nibble & 8) ? -delta : delta), -32768, 32767);
+            index = std::clamp(index + INDEX_TABLE[nibble & 7], 0, 88);
+        }
+
+        int Encode(int sample) {
+            int diff = sample - predictor;
+            int nibble = 0;
+            if (diff < 0) {
+                nibble = 8;
+                diff = -diff;
+            }
+            int step = STEP_TABLE[index];
+            if (diff >= step) { nibble |= 4; diff -= step; }
+            if (diff >= step >> 1) { nibble |= 2; diff -= step >> 1; }
+            if (diff >= step >> 2) nibble |= 1;
+            Apply(nibble);
+            return nibble;
+        }
+    };
+}
+
+std::vector<std::uint8_t> SoundBank::Encode(const std::int16_t* samples, std::uint64_t frames, unsigned int channels) {
+    std::vector<std::uint8_t> out;
+    out.reserve(EncodedSize(frames, channels));
+    std::vector<AdpcmState> states(channels);
+
+    for (std::uint64_t start = 0; start < frames; start += BLOCK_FRAMES) {
+        const std::uint64_t count = std::min<std::uint64_t>(BLOCK_FRAMES, frames - start);
+        const std::int16_t* block = samples + start * channels;
+
+        for (unsigned int c = 0; c < channels; c++) {
+            states[c].predictor = block[c];
+            const auto first = static_cast<std::uint16_t>(block[c]);
+            out.push_back(static_cast<std::uint8_t>(first & 0xFF));
+            out.push_back(static_cast<std::uint8_t>(first >> 8));
+            out.push_back(static_cast<std::uint8_t>(states[c].index));
+            out.push_back(0);
+        }
+        for (unsigned int c = 0; c < channels; c++) {
+            std::uint8_t packed = 0;
+            for (std::uint64_t i = 1; i < count; i++) {
+                int nibble = states[c].Encode(block[i * channels + c]);
+                if (i & 1) packed = static_cast<std::uint8_t>(nibble);
+                else out.push_back(static_cast<std::uint8_t>(packed | (nibble << 4)));
+            }
+            if (count % 2 == 0) out.push_back(packed);
+        }
+    }
+    return out;
+}
+
+std::vector<std::int16_t> SoundBank::Decode(const SoundBankEntry& entry) {
+    const unsigned int channels = entry.channels;
+    std::vector<std::int16_t> samples(static_cast<std::size_t>(entry.frames) * channels);
+    const std::uint8_t* in = entry.data;
+
+    for (std::uint64_t start = 0; start < entry.frames; start += BLOCK_FRAMES) {
+        const std::uint64_t count = std::min<std::uint64_t>(BLOCK_FRAMES, entry.frames - start);
+        std::int16_t* block = samples.data() + start * channels;
+
+        AdpcmState states[2];
+        for (unsigned int c = 0; c < channels; c++) {
+            states[c].predictor = static_cast<std::int16_t>(in[0] | (in[1] << 8));
+            states[c].index = std::min<int>(in[2], 88);
+            block[c] = static_cast<std::int16_t>(states[c].predictor);
+            in += 4;
+        }
+        for (unsigned int c = 0; c < channels; c++) {
+            for (std::uint64_t i = 1; i < count; i++) {
+                int nibble = (i & 1) ? (*in & 0x0F) : (*in++ >> 4);
+                states[c].Apply(nibble);
+                block[i * channels + c] = static_cast<std::int16_t>(states[c].predictor);
+            }
+            if (count % 2 == 0) in++;
+        }
+    }
+    return samples;
+}
+
+bool SoundBank::Write(const std::string& path, const std::vector<Source>& sounds) {
+    std::vector<std::vector<std::uint8_t>> encoded;
+    std::vector<BankEntry> table(sounds.size());
+    std::uint64_t offset = sizeof(BankHeader) + sizeof(BankEntry) * table.size();
+    for (std::size_t i = 0; i < sounds.size(); i++) {
+        const Source& sound = sounds[i];
+        if (sound.channels == 0 || sound.channels > 2 || sound.name.size() >= NAME_SIZE) {
+            std::cerr << "ERROR: Cannot store " << sound.name << " in a sound bank" << std::endl;
+            return false;
+        }
+        const std::uint64_t frames = sound.samples.size() / sound.channels;
+        encoded.push_back(Encode(sound.samples.data(), frames, sound.channels));
+
+        offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        BankEntry& entry = table[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::memcpy(entry.name, sound.name.c_str(), sound.name.size());
+        entry.sampleRate = sound.sampleRate;
+        entry.channels = sound.channels;
+        entry.frames = frames;
+        entry.offset = offset;
+        entry.size = encoded.back().size();
+        offset += entry.size;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "ERROR: Could not write sound bank: " << path << std::endl;
+        return false;
+    }
+    BankHeader header = {BANK_MAGIC, BANK_VERSION, static_cast<std::uint32_t>(table.size()), 0};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(sizeof(BankEntry) * table.size()));
+    for (std::size_t i = 0; i < encoded.size(); i++) {
+        std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+        const char padding[DATA_ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(table[i].offset - position));
+        file.write(reinterpret_cast<const char*>(encoded[i].data()), static_cast<std::streamsize>(encoded[i].size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool SoundBank::Open(const std::string& path) {
+    m_Entries.clear();
+    m_Path = path;
+    if (!m_File.Open(path)) return false;
+
+    const std::uint8_t* data = m_File.GetData();
+    const std::size_t size = m_File.GetSize();
+    BankHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != BANK_MAGIC || header.version != BANK_VERSION || sizeof(header) + sizeof(BankEntry) * header.count > size) {
+        std::cerr << "ERROR: Invalid sound bank: " << path << std::endl;
+        m_File.Close();
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < header.count; i++) {
+        BankEntry entry;
+        std::memcpy(&entry, data + sizeof(header) + sizeof(BankEntry) * i, sizeof(entry));
+        if (entry.channels == 0 || entry.channels > 2 || entry.offset + entry.size > size ||
+            entry.size != EncodedSize(entry.frames, entry.channels)) {
+            std::cerr << "ERROR: Invalid sound bank: " << path << std::endl;
+            m_Entries.clear();
+            m_File.Close();
+            return false;
+        }
+        SoundBankEntry view;
+        view.name.assign(entry.name, strnlen(entry.name, NAME_SIZE));
+        view.sampleRate = entry.sampleRate;
+        view.channels = entry.channels;
+        view.frames = entry.frames;
+        view.data = data + entry.offset;
+        view.size = static_cast<std::size_t>(entry.size);
+        m_Entries.push_back(std::move(view));
+    }
+    return true;
+}
+
+const SoundBankEntry* SoundBank::Find(const std::string& name) const {
+    for (const SoundBankEntry& entry : m_Entries) {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+// One mono or stereo effect as stored in the bank: IMA ADPCM, BLOCK_FRAMES frames per block. Each block starts
+// with an exact sample and step index per channel, so blocks decode independently.
+struct SoundBankEntry {
+    std::string name;
+    unsigned int sampleRate = 0;
+    unsigned int channels = 0;
+    std::uint64_t frames = 0;
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+
+    std::size_t GetPcmBytes() const { return static_cast<std::size_t>(frames) * channels * sizeof(std::int16_t); }
+};
+
+// Sound bank file (.msbk): header, entry table, then every effect ADPCM-compressed at about a
+// quarter of its 16-bit PCM size. Written offline by the sound-bank-builder tool; AudioManager maps
+// it and decodes effects from it instead of reading the source files.
+class SoundBank {
+public:
+    static constexpr int BLOCK_FRAMES = 2048;
+
+    struct Source {
+        std::string name;
+        unsigned int sampleRate = 0;
+        unsigned int channels = 0;
+        std::vector<std::int16_t> samples;  // interleaved
+    };
+
+    static std::vector<std::uint8_t> Encode(const std::int16_t* samples, std::uint64_t frames, unsigned int channels);
+    // Interleaved 16-bit PCM.
+    static std::vector<std::int16_t> Decode(const SoundBankEntry& entry);
+
+    static bool Write(const std::string& path, const std::vector<Source>& sounds);
+
+    // Fails when the file is missing or malformed.
+    bool Open(const std::string& path);
+    const SoundBankEntry* Find(const std::string& name) const;
+    const std::string& GetPath() const { return m_Path; }
+
+private:
+    MappedFile m_File;
+    std::string m_Path;
+    std::vector<SoundBankEntry> m_Entries;
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded ring between exactly one producer thread and one consumer thread. TryPush and TryPop
+// are wait-free: each reads the other side's index, copies one element and publishes its own
+// index. Nothing is allocated after construction.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer. Returns false, leaving the queue untouched, when it is full.
+    bool TryPush(const T& item) {
+        const std::size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_Head.load(std::memory_order_acquire) == Capacity) return false;
+        m_Items[tail & (Capacity - 1)] = item;
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer. Returns false when there is nothing to take.
+    bool TryPop(T& item) {
+        const std::size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_Tail.load(std::memory_order_acquire)) return false;
+        item = m_Items[head & (Capacity - 1)];
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    // Each index on its own cache line so the two threads do not false-share.
+    alignas(64) std::atomic<std::size_t> m_Head{0};
+    alignas(64) std::atomic<std::size_t> m_Tail{0};
+    alignas(64) std::array<T, Capacity> m_Items{};
+};
@@ -0,0 +1,122 @@
+#include "ExploredMap.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr int RAY_COUNT = 96;
+    constexpr float REVEAL_RADIUS = 7.0f;
+
+    bool IsOpaque(int tile) {
+        return tile == 1 || tile == 2 || tile == 5 || tile == 9;
+    }
+
+    MinimapCell Classify(int tile) {
+        switch (tile) {
+            case 1: case 9: return MinimapCell::WALL;
+            case 2: return MinimapCell::DOOR;
+            case 5: return MinimapCell::LOCKED_DOOR;
+            default: return MinimapCell::FLOOR;
+        }
+    }
+}
+
+void ExploredMap::Resize(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+    m_WordsPerRow = (width + 63) / 64;
+    Clear();
+}
+
+void ExploredMap::Clear() {
+    m_Bits.assign(static_cast<std::size_t>(m_WordsPerRow) * m_Height, 0);
+    m_RowDirty.assign(m_Height, 0);
+    m_DirtyRows.clear();
+    m_Reset = true;
+    m_LastCellX = m_LastCellZ = -1;
+}
+
+bool ExploredMap::IsExplored(int x, int z) const {
+    if (x < 0 || x >= m_Width || z < 0 || z >= m_Height) return false;
+    return (m_Bits[z * m_WordsPerRow + x / 64] >> (x % 64)) & 1u;
+}
+
+void ExploredMap::MarkRowDirty(int z) {
+    if (m_RowDirty[z]) return;
+    m_RowDirty[z] = 1;
+    m_DirtyRows.push_back(z);
+}
+
+void ExploredMap::SetExplored(int x, int z) {
+    if (x < 0 || x >= m_Width || z < 0 || z >= m_Height) return;
+    std::uint64_t& word = m_Bits[z * m_WordsPerRow + x / 64];
+    std::uint64_t bit = std::uint64_t(1) << (x % 64);
+    if (word & bit) return;
+    word |= bit;
+    MarkRowDirty(z);
+}
+
+void ExploredMap::MarkTileChanged(int x, int z) {
+    if (IsExplored(x, z)) MarkRowDirty(z);
+}
+
+// Line of sight only changes when the player enters another cell or a door opens.
+void ExploredMap::Reveal(const Map& map, glm::vec3 position) {
+    int cellX = static_cast<int>(std::floor(position.x));
+    int cellZ = static_cast<int>(std::floor(position.z));
+    if (cellX == m_LastCellX && cellZ == m_LastCellZ && map.GetRevision() == m_LastRevision) return;
+    m_LastCellX = cellX;
+    m_LastCellZ = cellZ;
+    m_LastRevision = map.GetRevision();
+
+    SetExplored(cellX, cellZ);
+    for (int i = 0; i < RAY_COUNT; i++) {
+        float angle = 6.2831853f * (i + 0.5f) / RAY_COUNT;
+        glm::vec2 dir(std::cos(angle), std::sin(angle));
+
+        // Amanatides-Woo grid traversal: visit every cell the ray crosses until it hits something opaque.
+        int x = cellX, z = cellZ;
+        int stepX = dir.x < 0.0f ? -1 : 1;
+        int stepZ = dir.y < 0.0f ? -1 : 1;
+        float deltaX = std::abs(1.0f / dir.x);
+        float deltaZ = std::abs(1.0f / dir.y);
+        float sideX = (dir.x < 0.0f ? position.x - x : x + 1.0f - position.x) * deltaX;
+        float sideZ = (dir.y < 0.0f ? position.z - z : z + 1.0f - position.z) * deltaZ;
+
+        while (std::min(sideX, sideZ) < REVEAL_RADIUS) {
+            if (sideX < sideZ) {
+                sideX += deltaX;
+                x += stepX;
+            } else {
+                sideZ += deltaZ;
+                z += stepZ;
+            }
+            if (x < 0 || x >= m_Width || z < 0 || z >= m_Height) break;
+            SetExplored(x, z);
+            if (IsOpaque(map.GetTile(x, z))) break;
+        }
+    }
+}
+
+void ExploredMap::Flush(const Map& map, MinimapUpdate& out) {
+    out.width = m_Width;
+    out.height = m_Height;
+    out.reset = m_Reset;
+    out.rows.clear();
+    out.cells.clear();
+    m_Reset = false;
+    if (m_DirtyRows.empty()) return;
+
+    // Sorted so the renderer can upload runs of adjacent rows as one block.
+    std::sort(m_DirtyRows.begin(), m_DirtyRows.end());
+    out.rows.assign(m_DirtyRows.begin(), m_DirtyRows.end());
+    out.cells.resize(out.rows.size() * m_Width);
+
+    std::uint8_t* cell = out.cells.data();
+    for (int z : m_DirtyRows) {
+        for (int x = 0; x < m_Width; x++) {
+            *cell++ = static_cast<std::uint8_t>(IsExplored(x, z) ? Classify(map.GetTile(x, z)) : MinimapCell::UNKNOWN);
+        }
+        m_RowDirty[z] = 0;
+    }
+    m_DirtyRows.clear();
+}
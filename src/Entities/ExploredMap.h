@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Map.h"
+
+// Minimap cell classes, one byte per cell in MinimapUpdate::cells.
+enum class MinimapCell : std::uint8_t {
+    UNKNOWN = 0,
+    FLOOR,
+    WALL,
+    DOOR,
+    LOCKED_DOOR
+};
+
+// Rows of the minimap that changed since the previous snapshot. reset means the renderer
+// starts over from an all-unknown width x height image before applying the rows.
+struct MinimapUpdate {
+    int width = 0;
+    int height = 0;
+    bool reset = false;
+    std::vector<int> rows;                  // ascending
+    std::vector<std::uint8_t> cells;        // rows.size() * width
+};
+
+// Which cells the player has seen, one bit per cell. Reveal() walks a fan of grid rays from the
+// player and only marks rows dirty when a bit flips, so a frame spent in known corridors costs
+// nothing downstream.
+class ExploredMap {
+public:
+    void Resize(int width, int height);
+    void Clear();
+
+    void Reveal(const Map& map, glm::vec3 position);
+    // A tile changed (door opened, key taken); its row is re-sent if the cell is explored.
+    void MarkTileChanged(int x, int z);
+
+    bool IsExplored(int x, int z) const;
+
+    // Moves the pending changes into out, reusing its storage.
+    void Flush(const Map& map, MinimapUpdate& out);
+
+private:
+    void SetExplored(int x, int z);
+    void MarkRowDirty(int z);
+
+    int m_Width = 0;
+    int m_Height = 0;
+    int m_WordsPerRow = 0;
+    std::vector<std::uint64_t> m_Bits;
+    std::vector<std::uint8_t> m_RowDirty;
+    std::vector<int> m_DirtyRows;
+    bool m_Reset = false;
+
+    int m_LastCellX = -1;
+    int m_LastCellZ = -1;
+    unsigned int m_LastRevision = 0;
+};
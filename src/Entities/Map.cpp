@@ -4,7 +4,7 @@
 #include <algorithm>
 #include <cmath>
 
-Map::Map() : m_Width(0), m_Height(0) {}
+Map::Map() : m_Width(0), m_Height(0), m_Revision(0) {}
 
 bool Map::LoadLevel(const std::string& path, glm::vec3& outPlayerStart, glm::vec3& outPaperPos) {
     std::ifstream file(path);
@@ -60,6 +60,7 @@ bool Map::LoadLevel(const std::string& path, glm::vec3& outPlayerStart, glm::vec
         }
     }
 
+    m_Revision++;
     std::cout << "Level Loaded: " << m_Width << "x" << m_Height << std::endl;
     return true;
 }
@@ -72,6 +73,7 @@ int Map::GetTile(int x, int z) const {
 void Map::SetTile(int x, int z, int type) {
     if (x >= 0 && x < m_Width && z >= 0 && z < m_Height) {
         m_Grid[z * m_Width + x] = type;
+        m_Revision++;
     }
 }
 
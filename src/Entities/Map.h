@@ -28,8 +28,12 @@ public:
     int GetWidth() const { return m_Width; }
     int GetHeight() const { return m_Height; }
 
+    // Bumped on every tile change so derived render data knows when to rebuild.
+    unsigned int GetRevision() const { return m_Revision; }
+
 private:
     int m_Width;
     int m_Height;
+    unsigned int m_Revision;
     std::vector<int> m_Grid;
 };
\ No newline at end of file
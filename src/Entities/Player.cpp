@@ -1,6 +1,7 @@
 #include "Player.h"
 #include "../Core/AudioManager.h"
 #include "../Physics/AABB.h"
+#include "../Core/Profiler.h"
 #include <cmath>
 #include <algorithm>
 #include <iostream>
@@ -32,19 +33,29 @@ void Player::Reset(glm::vec3 startPos) {
     UpdateCameraVectors();
 }
 
-void Player::HandleInput(const sf::Window& window, float dt, AudioManager& audio) {
-    ProcessMouseLook(window);
+void Player::EnterLevel(glm::vec3 startPos) {
+    m_Position = startPos;
+    m_Velocity = glm::vec3(0.0f);
+    m_Yaw = -90.0f;
+    m_Pitch = 0.0f;
+    m_IsGrounded = false;
+    m_HasRedKey = false;
+    UpdateCameraVectors();
+}
+
+void Player::HandleInput(const InputState& input, float dt, AudioManager& audio) {
+    ProcessMouseLook(input.mouseDelta);
 
     if (m_FlashlightToggleTimer > 0.0f) m_FlashlightToggleTimer -= dt;
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::F) && m_FlashlightToggleTimer <= 0.0f) {
+    if (input.flashlight && m_FlashlightToggleTimer <= 0.0f) {
         m_IsFlashlightOn = !m_IsFlashlightOn;
         m_FlashlightToggleTimer = 0.3f;
-        audio.PlayGlobal("click", 80.0f);
+        audio.PlayGlobal(m_ClickSound, 80.0f);
     }
 
 
-    bool shiftPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::LShift);
+    bool shiftPressed = input.sprint;
 
 
     if (m_Stamina <= 0.0f) m_IsFatigued = true;
@@ -58,13 +69,14 @@ void Player::HandleInput(const sf::Window& window, float dt, AudioManager& audio
     }
 
 
-    if (m_IsGrounded && sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::Space)) {
+    if (m_IsGrounded && input.jump) {
         m_Velocity.y = JUMP_FORCE;
         m_IsGrounded = false;
     }
 }
 
-void Player::Update(float dt, const Map& map, AudioManager& audio) {
+void Player::Update(const InputState& input, float dt, const Map& map, AudioManager& audio) {
+    MAZE_PROFILE_SCOPE("Player::Update");
 
     if (m_IsSprinting && glm::length(glm::vec2(m_Velocity.x, m_Velocity.z)) > 0.1f) {
         m_Stamina -= dt * 35.0f;
@@ -85,10 +97,10 @@ void Player::Update(float dt, const Map& map, AudioManager& audio) {
     glm::vec3 flatFront = glm::normalize(glm::vec3(m_Front.x, 0.0f, m_Front.z));
     glm::vec3 flatRight = glm::normalize(glm::vec3(m_Right.x, 0.0f, m_Right.z));
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::W)) inputDir += flatFront;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::S)) inputDir -= flatFront;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::A)) inputDir -= flatRight;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scan::D)) inputDir += flatRight;
+    if (input.forward) inputDir += flatFront;
+    if (input.back) inputDir -= flatFront;
+    if (input.left) inputDir -= flatRight;
+    if (input.right) inputDir += flatRight;
 
     if (glm::length(inputDir) > 0.01f) {
         inputDir = glm::normalize(inputDir);
@@ -180,7 +192,7 @@ void Player::Update(float dt, const Map& map, AudioManager& audio) {
 
         if (m_FootstepTimer <= 0.0f) {
             float vol = 30.0f + (horizontalSpeed * 5.0f);
-            audio.PlayGlobal("footstep", vol);
+            audio.PlayGlobal(m_FootstepSound, vol);
             m_FootstepTimer = stepInterval;
         }
     } else {
@@ -203,19 +215,10 @@ void Player::Update(float dt, const Map& map, AudioManager& audio) {
     }
 }
 
-void Player::ProcessMouseLook(const sf::Window& window) {
-    if (!window.hasFocus()) return;
-
-    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-    sf::Vector2u size = window.getSize();
-    sf::Vector2i center(size.x / 2, size.y / 2);
-
-
+void Player::ProcessMouseLook(glm::vec2 mouseDelta) {
     float sensitivity = 0.02f;
-    float xOffset = static_cast<float>(mousePos.x - center.x) * sensitivity;
-    float yOffset = static_cast<float>(center.y - mousePos.y) * sensitivity;
-
-    sf::Mouse::setPosition(center, window);
+    float xOffset = mouseDelta.x * sensitivity;
+    float yOffset = mouseDelta.y * sensitivity;
 
     m_Yaw += xOffset;
     m_Pitch += yOffset;
@@ -1,17 +1,20 @@
 #pragma once
-#include <SFML/Window.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Map.h"
 #include "../Core/AudioManager.h"
+#include "../Core/InputState.h"
 
 class Player {
 public:
     Player(glm::vec3 startPos);
 
-    void HandleInput(const sf::Window& window, float dt, AudioManager& audio);
-    void Update(float dt, const Map& map, AudioManager& audio);
+    void HandleInput(const InputState& input, float dt, AudioManager& audio);
+    void Update(const InputState& input, float dt, const Map& map, AudioManager& audio);
     void Reset(glm::vec3 startPos);
+    // Moves to the next level's start; battery and stamina carry over.
+    void EnterLevel(glm::vec3 startPos);
+    void SetSounds(SoundHandle click, SoundHandle footstep) { m_ClickSound = click; m_FootstepSound = footstep; }
 
 
     glm::vec3 GetPosition() const { return m_Position; }
@@ -30,7 +33,7 @@ public:
     void PickUpRedKey() { m_HasRedKey = true; }
 
 private:
-    void ProcessMouseLook(const sf::Window& window);
+    void ProcessMouseLook(glm::vec2 mouseDelta);
     void UpdateCameraVectors();
 
 
@@ -69,4 +72,6 @@ private:
     const float MAX_STAMINA = 100.0f;
     const float CEILING_HEIGHT = 4.0f;
     const float BASE_FOV = 60.0f;
-};
\ No newline at end of file
+
+    SoundHandle m_ClickSound, m_FootstepSound;
+};
@@ -0,0 +1,202 @@
+#include "SoundPropagation.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace {
+    constexpr std::uint16_t OPEN_COST = 1;
+    // A closed door costs as much as this many open cells on top of its own.
+    constexpr std::uint16_t DOOR_COST = 6;
+    constexpr float DOOR_TRANSMISSION = 0.35f;
+    constexpr float MAX_CUTOFF_HZ = 20000.0f;
+    constexpr float DOOR_CUTOFF_SCALE = 0.15f;
+    constexpr float MIN_CUTOFF_HZ = 250.0f;
+    // Air absorption: the cutoff halves every this many cells of path.
+    constexpr float CUTOFF_HALF_DISTANCE = 40.0f;
+
+    bool IsDoor(int tile) { return tile == 2 || tile == 5; }
+    bool IsOpen(int tile) { return tile == 0 || tile == 3 || tile == 4; }
+
+    std::uint16_t StepCost(int tile) {
+        if (IsOpen(tile)) return OPEN_COST;
+        if (IsDoor(tile)) return OPEN_COST + DOOR_COST;
+        return 0xFFFF;
+    }
+
+    const int NEIGHBOUR_X[4] = {1, -1, 0, 0};
+    const int NEIGHBOUR_Z[4] = {0, 0, 1, -1};
+}
+
+void SoundPropagation::Reset(const Map& map) {
+    m_Width = map.GetWidth();
+    m_Height = map.GetHeight();
+    m_StepCost.resize(static_cast<std::size_t>(m_Width) * m_Height);
+    for (int z = 0; z < m_Height; z++) {
+        for (int x = 0; x < m_Width; x++) m_StepCost[z * m_Width + x] = StepCost(map.GetTile(x, z));
+    }
+    m_Fields.clear();
+    m_FieldByCell.clear();
+    m_IdleFields = 0;
+}
+
+void SoundPropagation::SetTile(int x, int z, int tile) {
+    if (x < 0 || z < 0 || x >= m_Width || z >= m_Height) return;
+    const int cell = z * m_Width + x;
+    const std::uint16_t before = m_StepCost[cell];
+    m_StepCost[cell] = StepCost(tile);
+    if (m_StepCost[cell] == before) return;
+
+    for (Field& field : m_Fields) {
+        if (field.cell < 0) continue;
+        if (m_StepCost[cell] < before && field.cell != cell) Relax(field, {cell});
+        else Build(field);
+    }
+}
+
+int SoundPropagation::CellAt(glm::vec3 position) const {
+    int x = static_cast<int>(std::floor(position.x));
+    int z = static_cast<int>(std::floor(position.z));
+    if (x < 0 || z < 0 || x >= m_Width || z >= m_Height) return -1;
+    return z * m_Width + x;
+}
+
+int SoundPropagation::AcquireField(glm::vec3 position) {
+    const int cell = CellAt(position);
+    if (cell < 0 || m_StepCost[cell] == BLOCKED) return -1;
+
+    auto found = m_FieldByCell.find(cell);
+    if (found != m_FieldByCell.end()) {
+        Field& field = m_Fields[found->second];
+        if (field.refs++ == 0) m_IdleFields--;
+        return found->second;
+    }
+
+    // Reuse the first idle field once enough have piled up, otherwise grow.
+    int index = -1;
+    if (m_IdleFields >= MAX_IDLE_FIELDS) {
+        for (int i = 0; i < static_cast<int>(m_Fields.size()); i++) {
+            if (m_Fields[i].refs == 0) {
+                index = i;
+                break;
+            }
+        }
+    }
+    if (index >= 0) {
+        if (m_Fields[index].cell >= 0) m_FieldByCell.erase(m_Fields[index].cell);
+        m_IdleFields--;
+    } else {
+        index = static_cast<int>(m_Fields.size());
+        m_Fields.emplace_back();
+    }
+
+    Field& field = m_Fields[index];
+    field.cell = cell;
+    field.refs = 1;
+    Build(field);
+    m_FieldByCell[cell] = index;
+    return index;
+}
+
+void SoundPropagation::ReleaseField(int field) {
+    if (field < 0 || field >= static_cast<int>(m_Fields.size()) || m_Fields[field].refs == 0) return;
+    if (--m_Fields[field].refs == 0) m_IdleFields++;
+}
+
+void SoundPropagation::Build(Field& field) {
+    const std::size_t cells = m_StepCost.size();
+    field.cost.assign(cells, BLOCKED);
+    field.steps.assign(cells, BLOCKED);
+    field.doors.assign(cells, 0);
+    field.cost[field.cell] = 0;
+    field.steps[field.cell] = 0;
+    Relax(field, {field.cell});
+}
+
+// Dijkstra from the seeds, which must already hold their final cost. Only cells that get cheaper
+// are visited, so opening a door touches just the part of the maze it shortens.
+void SoundPropagation::Relax(Field& field, std::vector<int> seeds) {
+    using Item = std::pair<int, int>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+
+    for (int seed : seeds) {
+        if (m_StepCost[seed] == BLOCKED) continue;
+        // A seed that changed under an existing field takes the best of its neighbours.
+        const int sx = seed % m_Width, sz = seed / m_Width;
+        for (int n = 0; n < 4 && seed != field.cell; n++) {
+            int nx = sx + NEIGHBOUR_X[n], nz = sz + NEIGHBOUR_Z[n];
+            if (nx < 0 || nz < 0 || nx >= m_Width || nz >= m_Height) continue;
+            int neighbour = nz * m_Width + nx;
+            if (field.cost[neighbour] == BLOCKED) continue;
+            int cost = field.cost[neighbour] + m_StepCost[seed];
+            if (cost < field.cost[seed]) {
+                field.cost[seed] = static_cast<std::uint16_t>(cost);
+                field.steps[seed] = static_cast<std::uint16_t>(field.steps[neighbour] + 1);
+                field.doors[seed] = static_cast<std::uint8_t>(std::min(255, field.doors[neighbour] + (m_StepCost[seed] > OPEN_COST)));
+            }
+        }
+        if (field.cost[seed] != BLOCKED) open.push({field.cost[seed], seed});
+    }
+
+    while (!open.empty()) {
+        auto [cost, cell] = open.top();
+        open.pop();
+        if (cost > field.cost[cell]) continue;
+
+        const int x = cell % m_Width, z = cell / m_Width;
+        for (int n = 0; n < 4; n++) {
+            int nx = x + NEIGHBOUR_X[n], nz = z + NEIGHBOUR_Z[n];
+            if (nx < 0 || nz < 0 || nx >= m_Width || nz >= m_Height) continue;
+            int neighbour = nz * m_Width + nx;
+            if (m_StepCost[neighbour] == BLOCKED) continue;
+            int next = cost + m_StepCost[neighbour];
+            if (next >= field.cost[neighbour] || next >= BLOCKED) continue;
+            field.cost[neighbour] = static_cast<std::uint16_t>(next);
+            field.steps[neighbour] = static_cast<std::uint16_t>(field.steps[cell] + 1);
+            field.doors[neighbour] = static_cast<std::uint8_t>(std::min(255, field.doors[cell] + (m_StepCost[neighbour] > OPEN_COST)));
+            open.push({next, neighbour});
+        }
+    }
+}
+
+SoundPath SoundPropagation::Query(int fieldIndex, glm::vec3 emitter, glm::vec3 listener) const {
+    SoundPath path;
+    const int cell = CellAt(listener);
+    if (fieldIndex < 0 || cell < 0) return path;
+    const Field& field = m_Fields[fieldIndex];
+    if (field.cost[cell] == BLOCKED) return path;
+
+    path.audible = true;
+    float distance = glm::distance(emitter, listener);
+    path.position = emitter;
+    if (cell != field.cell) {
+        // The sound arrives from the neighbour the path comes through, from as far away as the
+        // path is long.
+        const int x = cell % m_Width, z = cell / m_Width;
+        int from = -1;
+        for (int n = 0; n < 4; n++) {
+            int nx = x + NEIGHBOUR_X[n], nz = z + NEIGHBOUR_Z[n];
+            if (nx < 0 || nz < 0 || nx >= m_Width || nz >= m_Height) continue;
+            int neighbour = nz * m_Width + nx;
+            if (field.cost[neighbour] == BLOCKED) continue;
+            if (from < 0 || field.cost[neighbour] < field.cost[from]) from = neighbour;
+        }
+        if (from >= 0 && field.steps[cell] > 1) {
+            glm::vec3 entry(from % m_Width + 0.5f, emitter.y, from / m_Width + 0.5f);
+            glm::vec3 toEntry = entry - listener;
+            toEntry.y = 0.0f;
+            float legLength = glm::length(toEntry);
+            distance = std::max(distance, legLength + static_cast<float>(field.steps[from]));
+            if (legLength > 1e-4f) {
+                path.position = listener + toEntry / legLength * distance;
+                path.position.y = emitter.y;
+            }
+        }
+    }
+
+    const int doors = field.doors[cell];
+    path.transmission = std::pow(DOOR_TRANSMISSION, static_cast<float>(doors));
+    path.cutoffHz = std::max(MIN_CUTOFF_HZ, MAX_CUTOFF_HZ * std::pow(DOOR_CUTOFF_SCALE, static_cast<float>(doors)) *
+                                            std::exp2(-distance / CUTOFF_HALF_DISTANCE));
+    return path;
+}
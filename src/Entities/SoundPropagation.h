@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Map.h"
+
+// How an emitter reaches the listener through the maze: from where it seems to come, how much of
+// it gets through closed doors and how muffled it is.
+struct SoundPath {
+    bool audible = false;
+    glm::vec3 position{0.0f};   // along the first leg of the path, at the path's length
+    float transmission = 1.0f;
+    float cutoffHz = 20000.0f;
+};
+
+// Sound propagation over the map grid. Each emitter cell gets a field of acoustic path costs to
+// every cell (a Dijkstra over open cells; a closed door counts as several cells and is remembered
+// for occlusion; walls block). Fields are shared by every sound from the same cell and kept up to
+// date as doors open, so a query is a handful of table lookups.
+class SoundPropagation {
+public:
+    void Reset(const Map& map);
+    // Doors opening relax the existing fields from that cell; anything else rebuilds them.
+    void SetTile(int x, int z, int tile);
+
+    // -1 when the position is outside the map or inside a wall.
+    int AcquireField(glm::vec3 position);
+    void ReleaseField(int field);
+
+    SoundPath Query(int field, glm::vec3 emitter, glm::vec3 listener) const;
+
+private:
+    static constexpr std::uint16_t BLOCKED = 0xFFFF;
+    // Idle fields kept around for reuse beyond the ones in use.
+    static constexpr int MAX_IDLE_FIELDS = 32;
+
+    struct Field {
+        int cell = -1;
+        int refs = 0;
+        std::vector<std::uint16_t> cost;
+        std::vector<std::uint16_t> steps;
+        std::vector<std::uint8_t> doors;
+    };
+
+    int CellAt(glm::vec3 position) const;
+    void Build(Field& field);
+    void Relax(Field& field, std::vector<int> seeds);
+
+    int m_Width = 0;
+    int m_Height = 0;
+    std::vector<std::uint16_t> m_StepCost;      // cost of entering each cell
+    std::vector<Field> m_Fields;
+    std::unordered_map<int, int> m_FieldByCell;
+    int m_IdleFields = 0;
+};
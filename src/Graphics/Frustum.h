@@ -0,0 +1,44 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+
+// View frustum planes (left, right, bottom, top, near, far) extracted from a view-projection matrix.
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    static Frustum FromMatrix(const glm::mat4& viewProjection) {
+        Frustum frustum;
+        glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        frustum.planes[0] = row3 + row0;
+        frustum.planes[1] = row3 - row0;
+        frustum.planes[2] = row3 + row1;
+        frustum.planes[3] = row3 - row1;
+        frustum.planes[4] = row3 + row2;
+        frustum.planes[5] = row3 - row2;
+
+        for (auto& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+
+    bool IntersectsAABB(glm::vec3 center, glm::vec3 halfExtent) const {
+        for (const auto& plane : planes) {
+            glm::vec3 normal(plane);
+            float radius = glm::dot(halfExtent, glm::abs(normal));
+            if (glm::dot(normal, center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
+
+// Distance past which the exponential-squared fog in shader.frag leaves less than one 8-bit step.
+inline float FogCullDistance(float fogDensity) {
+    return std::sqrt(std::log(255.0f)) / fogDensity;
+}
@@ -0,0 +1,332 @@
+#include "GLStats.h"
+#include <glad/glad.h>
+#include <sstream>
+
+namespace {
+    GLFrameStats g_Current;
+    GLFrameStats g_Last;
+}
+
+#ifdef MAZE_GL_STATS
+
+namespace {
+    // Last binding seen through the shims, for redundant-bind counting.
+    GLuint g_Program = 0;
+    GLuint g_VertexArray = 0;
+    GLuint g_DrawFramebuffer = 0;
+    GLuint g_ReadFramebuffer = 0;
+    GLenum g_ActiveUnit = 0;
+    GLuint g_Texture2D[32] = {};
+
+    PFNGLDRAWARRAYSPROC real_glDrawArrays;
+    PFNGLDRAWELEMENTSPROC real_glDrawElements;
+    PFNGLDRAWARRAYSINSTANCEDPROC real_glDrawArraysInstanced;
+    PFNGLDRAWELEMENTSINSTANCEDPROC real_glDrawElementsInstanced;
+    PFNGLMULTIDRAWARRAYSINDIRECTPROC real_glMultiDrawArraysIndirect;
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC real_glMultiDrawElementsIndirect;
+    PFNGLDISPATCHCOMPUTEPROC real_glDispatchCompute;
+
+    PFNGLUSEPROGRAMPROC real_glUseProgram;
+    PFNGLBINDVERTEXARRAYPROC real_glBindVertexArray;
+    PFNGLBINDBUFFERPROC real_glBindBuffer;
+    PFNGLBINDBUFFERBASEPROC real_glBindBufferBase;
+    PFNGLACTIVETEXTUREPROC real_glActiveTexture;
+    PFNGLBINDTEXTUREPROC real_glBindTexture;
+    PFNGLBINDFRAMEBUFFERPROC real_glBindFramebuffer;
+
+    PFNGLENABLEPROC real_glEnable;
+    PFNGLDISABLEPROC real_glDisable;
+    PFNGLBLENDFUNCPROC real_glBlendFunc;
+    PFNGLDEPTHFUNCPROC real_glDepthFunc;
+    PFNGLDEPTHMASKPROC real_glDepthMask;
+    PFNGLCOLORMASKPROC real_glColorMask;
+    PFNGLVIEWPORTPROC real_glViewport;
+
+    PFNGLUNIFORM1IPROC real_glUniform1i;
+    PFNGLUNIFORM1UIPROC real_glUniform1ui;
+    PFNGLUNIFORM1FPROC real_glUniform1f;
+    PFNGLUNIFORM2FVPROC real_glUniform2fv;
+    PFNGLUNIFORM3FVPROC real_glUniform3fv;
+    PFNGLUNIFORM4FVPROC real_glUniform4fv;
+    PFNGLUNIFORMMATRIX3FVPROC real_glUniformMatrix3fv;
+    PFNGLUNIFORMMATRIX4FVPROC real_glUniformMatrix4fv;
+
+    PFNGLBUFFERDATAPROC real_glBufferData;
+    PFNGLBUFFERSUBDATAPROC real_glBufferSubData;
+    PFNGLMAPBUFFERRANGEPROC real_glMapBufferRange;
+    PFNGLFLUSHMAPPEDBUFFERRANGEPROC real_glFlushMappedBufferRange;
+    PFNGLTEXIMAGE2DPROC real_glTexImage2D;
+    PFNGLTEXSUBIMAGE2DPROC real_glTexSubImage2D;
+    PFNGLCOMPRESSEDTEXIMAGE2DPROC real_glCompressedTexImage2D;
+
+    std::uint64_t Triangles(GLenum mode, GLsizei count) {
+        switch (mode) {
+            case GL_TRIANGLES: return count / 3;
+            case GL_TRIANGLE_STRIP:
+            case GL_TRIANGLE_FAN: return count > 2 ? count - 2 : 0;
+            default: return 0;
+        }
+    }
+
+    std::uint64_t PixelBytes(GLenum format, GLenum type) {
+        int components = 4;
+        switch (format) {
+            case GL_RED: case GL_RED_INTEGER: case GL_DEPTH_COMPONENT: components = 1; break;
+            case GL_RG: case GL_RG_INTEGER: components = 2; break;
+            case GL_RGB: case GL_BGR: components = 3; break;
+            default: break;
+        }
+        switch (type) {
+            case GL_UNSIGNED_BYTE: case GL_BYTE: return components;
+            case GL_HALF_FLOAT: case GL_UNSIGNED_SHORT: case GL_SHORT: return 2 * components;
+            case GL_FLOAT: case GL_UNSIGNED_INT: case GL_INT: return 4 * components;
+            default: return 4; // packed formats
+        }
+    }
+
+    void CountBind(GLuint& current, GLuint object, std::uint32_t& counter) {
+        counter++;
+        if (current == object) g_Current.redundantBinds++;
+        current = object;
+    }
+
+    void APIENTRY Count_glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+        g_Current.drawCalls++;
+        g_Current.triangles += Triangles(mode, count);
+        real_glDrawArrays(mode, first, count);
+    }
+
+    void APIENTRY Count_glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+        g_Current.drawCalls++;
+        g_Current.triangles += Triangles(mode, count);
+        real_glDrawElements(mode, count, type, indices);
+    }
+
+    void APIENTRY Count_glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instances) {
+        g_Current.drawCalls++;
+        g_Current.triangles += Triangles(mode, count) * instances;
+        real_glDrawArraysInstanced(mode, first, count, instances);
+    }
+
+    void APIENTRY Count_glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instances) {
+        g_Current.drawCalls++;
+        g_Current.triangles += Triangles(mode, count) * instances;
+        real_glDrawElementsInstanced(mode, count, type, indices, instances);
+    }
+
+    void APIENTRY Count_glMultiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawCount, GLsizei stride) {
+        g_Current.drawCalls++;
+        g_Current.indirectDraws += drawCount;
+        real_glMultiDrawArraysIndirect(mode, indirect, drawCount, stride);
+    }
+
+    void APIENTRY Count_glMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride) {
+        g_Current.drawCalls++;
+        g_Current.indirectDraws += drawCount;
+        real_glMultiDrawElementsIndirect(mode, type, indirect, drawCount, stride);
+    }
+
+    void APIENTRY Count_glDispatchCompute(GLuint x, GLuint y, GLuint z) {
+        g_Current.dispatches++;
+        real_glDispatchCompute(x, y, z);
+    }
+
+    void APIENTRY Count_glUseProgram(GLuint program) {
+        CountBind(g_Program, program, g_Current.programBinds);
+        real_glUseProgram(program);
+    }
+
+    void APIENTRY Count_glBindVertexArray(GLuint array) {
+        CountBind(g_VertexArray, array, g_Current.vertexArrayBinds);
+        real_glBindVertexArray(array);
+    }
+
+    void APIENTRY Count_glBindBuffer(GLenum target, GLuint buffer) {
+        g_Current.bufferBinds++;
+        real_glBindBuffer(target, buffer);
+    }
+
+    void APIENTRY Count_glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+        g_Current.bufferBinds++;
+        real_glBindBufferBase(target, index, buffer);
+    }
+
+    void APIENTRY Count_glActiveTexture(GLenum unit) {
+        g_ActiveUnit = unit - GL_TEXTURE0;
+        g_Current.stateChanges++;
+        real_glActiveTexture(unit);
+    }
+
+    void APIENTRY Count_glBindTexture(GLenum target, GLuint texture) {
+        if (target == GL_TEXTURE_2D && g_ActiveUnit < 32) CountBind(g_Texture2D[g_ActiveUnit], texture, g_Current.textureBinds);
+        else g_Current.textureBinds++;
+        real_glBindTexture(target, texture);
+    }
+
+    void APIENTRY Count_glBindFramebuffer(GLenum target, GLuint framebuffer) {
+        g_Current.framebufferBinds++;
+        bool redundant = (target == GL_READ_FRAMEBUFFER || g_DrawFramebuffer == framebuffer)
+                      && (target == GL_DRAW_FRAMEBUFFER || g_ReadFramebuffer == framebuffer);
+        if (redundant) g_Current.redundantBinds++;
+        if (target != GL_READ_FRAMEBUFFER) g_DrawFramebuffer = framebuffer;
+        if (target != GL_DRAW_FRAMEBUFFER) g_ReadFramebuffer = framebuffer;
+        real_glBindFramebuffer(target, framebuffer);
+    }
+
+    void APIENTRY Count_glEnable(GLenum cap) { g_Current.stateChanges++; real_glEnable(cap); }
+    void APIENTRY Count_glDisable(GLenum cap) { g_Current.stateChanges++; real_glDisable(cap); }
+    void APIENTRY Count_glBlendFunc(GLenum src, GLenum dst) { g_Current.stateChanges++; real_glBlendFunc(src, dst); }
+    void APIENTRY Count_glDepthFunc(GLenum func) { g_Current.stateChanges++; real_glDepthFunc(func); }
+    void APIENTRY Count_glDepthMask(GLboolean flag) { g_Current.stateChanges++; real_glDepthMask(flag); }
+    void APIENTRY Count_glColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a) { g_Current.stateChanges++; real_glColorMask(r, g, b, a); }
+    void APIENTRY Count_glViewport(GLint x, GLint y, GLsizei w, GLsizei h) { g_Current.stateChanges++; real_glViewport(x, y, w, h); }
+
+    void APIENTRY Count_glUniform1i(GLint location, GLint v) { g_Current.uniformCalls++; real_glUniform1i(location, v); }
+    void APIENTRY Count_glUniform1ui(GLint location, GLuint v) { g_Current.uniformCalls++; real_glUniform1ui(location, v); }
+    void APIENTRY Count_glUniform1f(GLint location, GLfloat v) { g_Current.uniformCalls++; real_glUniform1f(location, v); }
+    void APIENTRY Count_glUniform2fv(GLint location, GLsizei count, const GLfloat* v) { g_Current.uniformCalls++; real_glUniform2fv(location, count, v); }
+    void APIENTRY Count_glUniform3fv(GLint location, GLsizei count, const GLfloat* v) { g_Current.uniformCalls++; real_glUniform3fv(location, count, v); }
+    void APIENTRY Count_glUniform4fv(GLint location, GLsizei count, const GLfloat* v) { g_Current.uniformCalls++; real_glUniform4fv(location, count, v); }
+    void APIENTRY Count_glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* v) {
+        g_Current.uniformCalls++;
+        real_glUniformMatrix3fv(location, count, transpose, v);
+    }
+    void APIENTRY Count_glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* v) {
+        g_Current.uniformCalls++;
+        real_glUniformMatrix4fv(location, count, transpose, v);
+    }
+
+    void APIENTRY Count_glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+        g_Current.bufferUploads++;
+        if (data) g_Current.bytesUploaded += size;
+        real_glBufferData(target, size, data, usage);
+    }
+
+    void APIENTRY Count_glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+        g_Current.bufferUploads++;
+        g_Current.bytesUploaded += size;
+        real_glBufferSubData(target, offset, size, data);
+    }
+
+    // A written mapping counts its whole range at map time, since the writes themselves can't be
+    // seen; with explicit flushing only the flushed ranges count.
+    void* APIENTRY Count_glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+        if ((access & GL_MAP_WRITE_BIT) && !(access & GL_MAP_FLUSH_EXPLICIT_BIT)) {
+            g_Current.bufferUploads++;
+            g_Current.bytesUploaded += length;
+        }
+        return real_glMapBufferRange(target, offset, length, access);
+    }
+
+    void APIENTRY Count_glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length) {
+        g_Current.bufferUploads++;
+        g_Current.bytesUploaded += length;
+        real_glFlushMappedBufferRange(target, offset, length);
+    }
+
+    void APIENTRY Count_glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+                                     GLint border, GLenum format, GLenum type, const void* pixels) {
+        g_Current.textureUploads++;
+        if (pixels) g_Current.bytesUploaded += static_cast<std::uint64_t>(width) * height * PixelBytes(format, type);
+        real_glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+    }
+
+    void APIENTRY Count_glTexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+                                        GLenum format, GLenum type, const void* pixels) {
+        g_Current.textureUploads++;
+        g_Current.bytesUploaded += static_cast<std::uint64_t>(width) * height * PixelBytes(format, type);
+        real_glTexSubImage2D(target, level, x, y, width, height, format, type, pixels);
+    }
+
+    void APIENTRY Count_glCompressedTexImage2D(GLenum target, GLint level, GLenum internalFormat, GLsizei width, GLsizei height,
+                                               GLint border, GLsizei imageSize, const void* data) {
+        g_Current.textureUploads++;
+        if (data) g_Current.bytesUploaded += imageSize;
+        real_glCompressedTexImage2D(target, level, internalFormat, width, height, border, imageSize, data);
+    }
+}
+
+// Functions the context doesn't expose stay null so callers' IsSupported checks keep working.
+#define MAZE_WRAP_GL(name) \
+    if (glad_##name && glad_##name != Count_##name) { real_##name = glad_##name; glad_##name = Count_##name; }
+
+bool GLStats::IsAvailable() {
+    return true;
+}
+
+void GLStats::Install() {
+    MAZE_WRAP_GL(glDrawArrays)
+    MAZE_WRAP_GL(glDrawElements)
+    MAZE_WRAP_GL(glDrawArraysInstanced)
+    MAZE_WRAP_GL(glDrawElementsInstanced)
+    MAZE_WRAP_GL(glMultiDrawArraysIndirect)
+    MAZE_WRAP_GL(glMultiDrawElementsIndirect)
+    MAZE_WRAP_GL(glDispatchCompute)
+
+    MAZE_WRAP_GL(glUseProgram)
+    MAZE_WRAP_GL(glBindVertexArray)
+    MAZE_WRAP_GL(glBindBuffer)
+    MAZE_WRAP_GL(glBindBufferBase)
+    MAZE_WRAP_GL(glActiveTexture)
+    MAZE_WRAP_GL(glBindTexture)
+    MAZE_WRAP_GL(glBindFramebuffer)
+
+    MAZE_WRAP_GL(glEnable)
+    MAZE_WRAP_GL(glDisable)
+    MAZE_WRAP_GL(glBlendFunc)
+    MAZE_WRAP_GL(glDepthFunc)
+    MAZE_WRAP_GL(glDepthMask)
+    MAZE_WRAP_GL(glColorMask)
+    MAZE_WRAP_GL(glViewport)
+
+    MAZE_WRAP_GL(glUniform1i)
+    MAZE_WRAP_GL(glUniform1ui)
+    MAZE_WRAP_GL(glUniform1f)
+    MAZE_WRAP_GL(glUniform2fv)
+    MAZE_WRAP_GL(glUniform3fv)
+    MAZE_WRAP_GL(glUniform4fv)
+    MAZE_WRAP_GL(glUniformMatrix3fv)
+    MAZE_WRAP_GL(glUniformMatrix4fv)
+
+    MAZE_WRAP_GL(glBufferData)
+    MAZE_WRAP_GL(glBufferSubData)
+    MAZE_WRAP_GL(glMapBufferRange)
+    MAZE_WRAP_GL(glFlushMappedBufferRange)
+    MAZE_WRAP_GL(glTexImage2D)
+    MAZE_WRAP_GL(glTexSubImage2D)
+    MAZE_WRAP_GL(glCompressedTexImage2D)
+}
+
+#undef MAZE_WRAP_GL
+
+#else
+
+bool GLStats::IsAvailable() {
+    return false;
+}
+
+void GLStats::Install() {}
+
+#endif
+
+void GLStats::EndFrame() {
+    g_Last = g_Current;
+    g_Current = GLFrameStats();
+}
+
+const GLFrameStats& GLStats::GetLastFrame() {
+    return g_Last;
+}
+
+std::string GLStats::FormatLastFrame() {
+    const GLFrameStats& s = g_Last;
+    std::ostringstream out;
+    out << "draws " << s.drawCalls << " (indirect " << s.indirectDraws << ", dispatch " << s.dispatches << ")\n"
+        << "triangles " << s.triangles << "\n"
+        << "binds prog " << s.programBinds << " vao " << s.vertexArrayBinds << " buf " << s.bufferBinds
+        << " tex " << s.textureBinds << " fbo " << s.framebufferBinds << " (redundant " << s.redundantBinds << ")\n"
+        << "state " << s.stateChanges << "  uniforms " << s.uniformCalls << "\n"
+        << "uploads buf " << s.bufferUploads << " tex " << s.textureUploads << "  "
+        << s.bytesUploaded / 1024 << " KiB";
+    return out.str();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// GL work issued in one frame. Indirect draws only count commands: their triangle counts live in
+// GPU buffers.
+struct GLFrameStats {
+    std::uint32_t drawCalls = 0;
+    std::uint32_t indirectDraws = 0;
+    std::uint32_t dispatches = 0;
+    std::uint64_t triangles = 0;
+
+    std::uint32_t programBinds = 0;
+    std::uint32_t vertexArrayBinds = 0;
+    std::uint32_t bufferBinds = 0;
+    std::uint32_t textureBinds = 0;
+    std::uint32_t framebufferBinds = 0;
+    // Fixed-function state: enable/disable, blend, depth, color mask, viewport.
+    std::uint32_t stateChanges = 0;
+    // Binds of the object that was already bound.
+    std::uint32_t redundantBinds = 0;
+
+    std::uint32_t uniformCalls = 0;
+    std::uint32_t bufferUploads = 0;
+    std::uint32_t textureUploads = 0;
+    std::uint64_t bytesUploaded = 0;
+};
+
+// Counting shims over the glad function pointers, built with -DMAZE_GL_STATS=ON. Install() swaps
+// the glad pointers for wrappers that count and forward, so every caller going through glad is
+// measured without changes. SFML's internal GL calls use its own loader and are not counted.
+// Without the option everything here is a no-op and IsAvailable() returns false.
+// Counters are not atomic: GL is only driven from the render thread.
+class GLStats {
+public:
+    static bool IsAvailable();
+
+    // Call once after gladLoadGLLoader.
+    static void Install();
+
+    // Publishes the counters of the frame that just ended and starts a new one.
+    static void EndFrame();
+
+    static const GLFrameStats& GetLastFrame();
+
+    // Multi-line summary for the debug overlay.
+    static std::string FormatLastFrame();
+
+private:
+    GLStats() {}
+};
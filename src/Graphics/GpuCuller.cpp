@@ -0,0 +1,113 @@
+#include "GpuCuller.h"
+#include "Frustum.h"
+#include <string>
+
+namespace {
+    constexpr unsigned int CULL_GROUP_SIZE = 64;
+}
+
+GpuCuller::GpuCuller(Renderer& renderer) : m_InstanceCount(0) {
+    cullShader.LoadCompute("assets/shaders/cull.comp");
+
+    glGenBuffers(1, &inputSSBO);
+    glGenBuffers(1, &outputSSBO);
+    glGenBuffers(1, &indirectBuffer);
+
+    m_ResetCommands.fill({36, 0, 0, 0});
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(m_ResetCommands), m_ResetCommands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+
+    drawVAO = renderer.CreateMeshVAO();
+    glBindVertexArray(drawVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, outputSSBO);
+    Renderer::SetPackedInstanceAttributes();
+    glBindVertexArray(0);
+}
+
+GpuCuller::~GpuCuller() {
+    glDeleteVertexArrays(1, &drawVAO);
+    glDeleteBuffers(1, &inputSSBO);
+    glDeleteBuffers(1, &outputSSBO);
+    glDeleteBuffers(1, &indirectBuffer);
+    glDeleteProgram(cullShader.GetID());
+}
+
+bool GpuCuller::IsSupported() {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void GpuCuller::Upload(const std::vector<PackedInstance>& instances) {
+    m_InstanceCount = static_cast<unsigned int>(instances.size());
+
+
+    std::array<unsigned int, MATERIAL_COUNT> bucketSizes{};
+    for (const auto& instance : instances) {
+        bucketSizes[static_cast<int>(UnpackMaterial(instance))]++;
+    }
+
+    unsigned int baseInstance = 0;
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        m_ResetCommands[m] = {36, 0, 0, baseInstance};
+        baseInstance += bucketSizes[m];
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, inputSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(PackedInstance), instances.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, outputSSBO);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(PackedInstance), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void GpuCuller::Cull(const glm::mat4& viewProjection, glm::vec3 viewPos, float maxDistance) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(m_ResetCommands), m_ResetCommands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    if (m_InstanceCount == 0) return;
+
+    Frustum frustum = Frustum::FromMatrix(viewProjection);
+
+    cullShader.Use();
+    for (int i = 0; i < 6; i++) {
+        cullShader.SetVec4("frustumPlanes[" + std::to_string(i) + "]", frustum.planes[i]);
+    }
+    cullShader.SetVec3("viewPos", viewPos);
+    cullShader.SetFloat("maxDistance", maxDistance);
+    cullShader.SetUInt("instanceCount", m_InstanceCount);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, inputSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, outputSSBO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, indirectBuffer);
+
+    glDispatchCompute((m_InstanceCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+}
+
+void GpuCuller::Draw(Shader& materialShader, const std::array<unsigned int, MATERIAL_COUNT>& textures) {
+    materialShader.Use();
+    for (int m = 0; m < MATERIAL_COUNT; m++) {
+        glActiveTexture(GL_TEXTURE0 + m);
+        glBindTexture(GL_TEXTURE_2D, textures[m]);
+        materialShader.SetInt("materialTextures[" + std::to_string(m) + "]", m);
+    }
+
+    glBindVertexArray(drawVAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, MATERIAL_COUNT, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void GpuCuller::DrawDepth(Shader& depthShader) {
+    depthShader.Use();
+    glBindVertexArray(drawVAO);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, MATERIAL_COUNT, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
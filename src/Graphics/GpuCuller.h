@@ -0,0 +1,41 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+#include "Shader.h"
+#include "Renderer.h"
+#include "InstanceData.h"
+
+// GL 4.3+ render path: all maze instances live on the GPU, a compute shader culls them
+// against the frustum and fog distance and writes one indirect draw per material.
+class GpuCuller {
+public:
+    explicit GpuCuller(Renderer& renderer);
+    ~GpuCuller();
+
+    static bool IsSupported();
+
+    void Upload(const std::vector<PackedInstance>& instances);
+    void Cull(const glm::mat4& viewProjection, glm::vec3 viewPos, float maxDistance);
+    void Draw(Shader& materialShader, const std::array<unsigned int, MATERIAL_COUNT>& textures);
+    void DrawDepth(Shader& depthShader);
+
+private:
+    struct DrawArraysIndirectCommand {
+        unsigned int count;
+        unsigned int instanceCount;
+        unsigned int first;
+        unsigned int baseInstance;
+    };
+
+    Shader cullShader;
+
+    unsigned int inputSSBO;
+    unsigned int outputSSBO;
+    unsigned int indirectBuffer;
+    unsigned int drawVAO;
+
+    std::array<DrawArraysIndirectCommand, MATERIAL_COUNT> m_ResetCommands;
+    unsigned int m_InstanceCount;
+};
@@ -0,0 +1,44 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer() : m_Pending{}, m_Current(0), m_Active(false), m_LastMs(-1.0f) {
+    glGenQueries(QUERY_COUNT, queries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(QUERY_COUNT, queries);
+}
+
+void GpuTimer::Begin() {
+    Collect();
+
+    // Every slot still in flight: skip this frame rather than stall.
+    if (m_Pending[m_Current]) return;
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[m_Current]);
+    m_Active = true;
+}
+
+void GpuTimer::End() {
+    if (!m_Active) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_Pending[m_Current] = true;
+    m_Active = false;
+    m_Current = (m_Current + 1) % QUERY_COUNT;
+}
+
+void GpuTimer::Collect() {
+    for (int i = 1; i <= QUERY_COUNT; i++) {
+        int slot = (m_Current + i) % QUERY_COUNT;
+        if (!m_Pending[slot]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &elapsedNs);
+        m_LastMs = static_cast<float>(elapsedNs) / 1.0e6f;
+        m_Pending[slot] = false;
+    }
+}
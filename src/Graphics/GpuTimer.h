@@ -0,0 +1,26 @@
+#pragma once
+#include <glad/glad.h>
+
+// GL_TIME_ELAPSED query ring: results are read a few frames later so the CPU never waits on the GPU.
+class GpuTimer {
+public:
+    GpuTimer();
+    ~GpuTimer();
+
+    void Begin();
+    void End();
+
+    // Latest completed measurement in milliseconds, negative until the first one arrives.
+    float GetLastMs() const { return m_LastMs; }
+
+private:
+    static constexpr int QUERY_COUNT = 3;
+
+    unsigned int queries[QUERY_COUNT];
+    bool m_Pending[QUERY_COUNT];
+    int m_Current;
+    bool m_Active;
+    float m_LastMs;
+
+    void Collect();
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include <glm/glm.hpp>
+
+// Point or spot light with a finite radius. cosOuterCutOff <= -1 makes it omnidirectional.
+struct GridLight {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    float intensity;
+    glm::vec3 direction;
+    float cosOuterCutOff;
+};
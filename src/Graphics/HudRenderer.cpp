@@ -0,0 +1,257 @@
+#include "HudRenderer.h"
+#include "../Core/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/String.hpp>
+
+HudRenderer::HudRenderer(const sf::Font& font)
+    : m_Font(font), m_BufferCapacity(0), m_Dirty(true)
+{
+    hudShader.Load("assets/shaders/hud.vert", "assets/shaders/hud.frag");
+
+    glGenVertexArrays(1, &hudVAO);
+    glGenBuffers(1, &hudVBO);
+    glBindVertexArray(hudVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, texCoord));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HudVertex), (void*)offsetof(HudVertex, color));
+    glBindVertexArray(0);
+}
+
+HudRenderer::~HudRenderer() {
+    glDeleteVertexArrays(1, &hudVAO);
+    glDeleteBuffers(1, &hudVBO);
+    glDeleteProgram(hudShader.GetID());
+}
+
+void HudRenderer::AppendQuad(std::vector<HudVertex>& vertices, glm::vec2 min, glm::vec2 max, glm::vec2 uvMin, glm::vec2 uvMax) {
+    HudVertex corners[4] = {
+        {{min.x, min.y}, {uvMin.x, uvMin.y}, {255, 255, 255, 255}},
+        {{max.x, min.y}, {uvMax.x, uvMin.y}, {255, 255, 255, 255}},
+        {{max.x, max.y}, {uvMax.x, uvMax.y}, {255, 255, 255, 255}},
+        {{min.x, max.y}, {uvMin.x, uvMax.y}, {255, 255, 255, 255}},
+    };
+    for (int index : {0, 1, 2, 0, 2, 3}) vertices.push_back(corners[index]);
+}
+
+HudRenderer::ElementId HudRenderer::AddElement(unsigned int characterSize, sf::Color color) {
+    Element element;
+    element.characterSize = characterSize;
+    element.boundsMin = glm::vec2(0.0f);
+    element.boundsSize = glm::vec2(0.0f);
+    element.position = glm::vec2(0.0f);
+    element.scale = glm::vec2(1.0f);
+    element.color = color;
+    element.outline = 0.0f;
+    element.visible = true;
+    m_Elements.push_back(std::move(element));
+    m_Dirty = true;
+    return static_cast<ElementId>(m_Elements.size()) - 1;
+}
+
+HudRenderer::ElementId HudRenderer::AddText(unsigned int characterSize, sf::Color color) {
+    return AddElement(characterSize, color);
+}
+
+HudRenderer::ElementId HudRenderer::AddRect(sf::Color color, float outlineThickness) {
+    ElementId id = AddElement(0, color);
+    m_Elements[id].outline = outlineThickness;
+    if (outlineThickness > 0.0f) return id;
+    AppendQuad(m_Elements[id].local, glm::vec2(0.0f), glm::vec2(1.0f), glm::vec2(-1.0f), glm::vec2(-1.0f));
+    return id;
+}
+
+HudRenderer::ElementId HudRenderer::AddCircle(sf::Color color, int segments) {
+    ElementId id = AddElement(0, color);
+    std::vector<HudVertex>& local = m_Elements[id].local;
+    for (int i = 0; i < segments; i++) {
+        float a0 = 6.2831853f * i / segments;
+        float a1 = 6.2831853f * (i + 1) / segments;
+        local.push_back({{0.0f, 0.0f}, {-1.0f, -1.0f}, {255, 255, 255, 255}});
+        local.push_back({{std::cos(a0), std::sin(a0)}, {-1.0f, -1.0f}, {255, 255, 255, 255}});
+        local.push_back({{std::cos(a1), std::sin(a1)}, {-1.0f, -1.0f}, {255, 255, 255, 255}});
+    }
+    return id;
+}
+
+void HudRenderer::SetText(ElementId id, const std::string& text) {
+    Element& element = m_Elements[id];
+    if (element.text == text) return;
+    element.text = text;
+    LayoutText(element);
+    m_Dirty = true;
+}
+
+void HudRenderer::SetPosition(ElementId id, glm::vec2 position) {
+    Element& element = m_Elements[id];
+    if (element.position == position) return;
+    element.position = position;
+    m_Dirty = true;
+}
+
+void HudRenderer::SetScale(ElementId id, glm::vec2 scale) {
+    Element& element = m_Elements[id];
+    if (element.scale == scale) return;
+    element.scale = scale;
+    m_Dirty = true;
+}
+
+void HudRenderer::SetColor(ElementId id, sf::Color color) {
+    Element& element = m_Elements[id];
+    if (element.color == color) return;
+    element.color = color;
+    m_Dirty = true;
+}
+
+void HudRenderer::SetVisible(ElementId id, bool visible) {
+    Element& element = m_Elements[id];
+    if (element.visible == visible) return;
+    element.visible = visible;
+    m_Dirty = true;
+}
+
+// Same pen model as sf::Text: baseline starts one character size down, glyph quads from
+// Glyph::bounds, texture coordinates kept in atlas pixels so atlas growth doesn't invalidate them.
+void HudRenderer::LayoutText(Element& element) {
+    element.local.clear();
+
+    const unsigned int size = element.characterSize;
+    const float lineSpacing = m_Font.getLineSpacing(size);
+    glm::vec2 pen(0.0f, static_cast<float>(size));
+    glm::vec2 boundsMin(1e9f), boundsMax(-1e9f);
+    std::uint32_t previous = 0;
+
+    const sf::String text = sf::String::fromUtf8(element.text.begin(), element.text.end());
+    for (std::uint32_t codePoint : text) {
+        pen.x += m_Font.getKerning(previous, codePoint, size);
+        previous = codePoint;
+
+        if (codePoint == '\n') {
+            pen.x = 0.0f;
+            pen.y += lineSpacing;
+            continue;
+        }
+
+        const sf::Glyph& glyph = m_Font.getGlyph(codePoint, size, false);
+        if (codePoint != ' ' && glyph.textureRect.size.x > 0) {
+            glm::vec2 min = pen + glm::vec2(glyph.bounds.position.x, glyph.bounds.position.y);
+            glm::vec2 max = min + glm::vec2(glyph.bounds.size.x, glyph.bounds.size.y);
+            glm::vec2 uvMin(glyph.textureRect.position.x, glyph.textureRect.position.y);
+            glm::vec2 uvMax = uvMin + glm::vec2(glyph.textureRect.size.x, glyph.textureRect.size.y);
+            AppendQuad(element.local, min, max, uvMin, uvMax);
+
+            boundsMin = glm::min(boundsMin, min);
+            boundsMax = glm::max(boundsMax, max);
+        }
+        pen.x += glyph.advance;
+    }
+
+    if (element.local.empty()) {
+        element.boundsMin = glm::vec2(0.0f);
+        element.boundsSize = glm::vec2(0.0f);
+    } else {
+        element.boundsMin = boundsMin;
+        element.boundsSize = boundsMax - boundsMin;
+    }
+}
+
+void HudRenderer::Rebuild() {
+    m_Batches.clear();
+
+    std::vector<HudVertex> vertices;
+    std::vector<HudVertex> ring;
+    for (const Element& element : m_Elements) {
+        if (!element.visible) continue;
+
+        // Outlines keep a constant pixel thickness, so they're built in screen space.
+        const std::vector<HudVertex>* geometry = &element.local;
+        glm::vec2 offset = element.position;
+        glm::vec2 scale = element.scale;
+        if (element.outline > 0.0f) {
+            glm::vec2 p0 = element.position;
+            glm::vec2 p1 = element.position + element.scale;
+            float t = element.outline;
+            glm::vec2 none(-1.0f);
+            ring.clear();
+            AppendQuad(ring, p0, glm::vec2(p1.x, p0.y + t), none, none);
+            AppendQuad(ring, glm::vec2(p0.x, p1.y - t), p1, none, none);
+            AppendQuad(ring, glm::vec2(p0.x, p0.y + t), glm::vec2(p0.x + t, p1.y - t), none, none);
+            AppendQuad(ring, glm::vec2(p1.x - t, p0.y + t), glm::vec2(p1.x, p1.y - t), none, none);
+            geometry = &ring;
+            offset = glm::vec2(0.0f);
+            scale = glm::vec2(1.0f);
+        }
+        if (geometry->empty()) continue;
+
+        // Batches follow submission order so later elements stay on top. Shapes don't sample the
+        // atlas and join the current batch; text opens a new one only when its glyph page differs.
+        if (m_Batches.empty() || (element.characterSize != 0 && m_Batches.back().characterSize != 0 &&
+                                  m_Batches.back().characterSize != element.characterSize)) {
+            m_Batches.push_back({element.characterSize, static_cast<int>(vertices.size()), 0});
+        }
+        Batch& batch = m_Batches.back();
+        if (batch.characterSize == 0) batch.characterSize = element.characterSize;
+
+        for (HudVertex vertex : *geometry) {
+            vertex.position = offset + vertex.position * scale;
+            vertex.color[0] = element.color.r;
+            vertex.color[1] = element.color.g;
+            vertex.color[2] = element.color.b;
+            vertex.color[3] = element.color.a;
+            vertices.push_back(vertex);
+        }
+        batch.count = static_cast<int>(vertices.size()) - batch.first;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+    std::size_t bytes = vertices.size() * sizeof(HudVertex);
+    if (bytes > m_BufferCapacity) {
+        m_BufferCapacity = std::max(bytes, m_BufferCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, m_BufferCapacity, NULL, GL_DYNAMIC_DRAW);
+    }
+    if (bytes > 0) glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_Dirty = false;
+}
+
+void HudRenderer::Draw(int screenWidth, int screenHeight) {
+    MAZE_PROFILE_SCOPE("HudRenderer::Draw");
+    MAZE_PROFILE_GPU_SCOPE("HUD");
+    if (m_Dirty) Rebuild();
+    if (m_Batches.empty()) return;
+
+    glViewport(0, 0, screenWidth, screenHeight);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    hudShader.Use();
+    hudShader.SetVec2("screenSize", glm::vec2(screenWidth, screenHeight));
+    hudShader.SetInt("atlas", 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(hudVAO);
+
+    for (const Batch& batch : m_Batches) {
+        glm::vec2 atlasSize(1.0f);
+        if (batch.characterSize != 0) {
+            // Fetched per draw: the page texture is reallocated when new glyphs overflow it.
+            const sf::Texture& page = m_Font.getTexture(batch.characterSize);
+            atlasSize = glm::vec2(page.getSize().x, page.getSize().y);
+            glBindTexture(GL_TEXTURE_2D, page.getNativeHandle());
+        }
+        hudShader.SetVec2("atlasSize", atlasSize);
+        glDrawArrays(GL_TRIANGLES, batch.first, batch.count);
+    }
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <glad/glad.h>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Shader.h"
+
+// Retained 2D overlay. Elements are created once and updated through setters that only mark the
+// vertex buffer dirty when something actually changed; text geometry is laid out once per string
+// against the SFML glyph atlas from its UTF-8 text. Elements draw in the order they were added, one
+// draw call per run of consecutive elements sharing a glyph page.
+class HudRenderer {
+public:
+    using ElementId = int;
+
+    explicit HudRenderer(const sf::Font& font);
+    ~HudRenderer();
+
+    ElementId AddText(unsigned int characterSize, sf::Color color);
+    // outlineThickness > 0 draws only the border, inset from the rect's edge.
+    ElementId AddRect(sf::Color color, float outlineThickness = 0.0f);
+    ElementId AddCircle(sf::Color color, int segments = 12);
+
+    // text is UTF-8.
+    void SetText(ElementId id, const std::string& text);
+    void SetPosition(ElementId id, glm::vec2 position);
+    // Text: uniform glyph scale. Rect: size in pixels. Circle: radius in pixels.
+    void SetScale(ElementId id, glm::vec2 scale);
+    void SetColor(ElementId id, sf::Color color);
+    void SetVisible(ElementId id, bool visible);
+
+    // Unscaled glyph bounds of a text element, relative to its position.
+    glm::vec2 GetTextMin(ElementId id) const { return m_Elements[id].boundsMin; }
+    glm::vec2 GetTextSize(ElementId id) const { return m_Elements[id].boundsSize; }
+
+    void Draw(int screenWidth, int screenHeight);
+
+private:
+    struct HudVertex {
+        glm::vec2 position;
+        glm::vec2 texCoord;     // atlas pixels, negative for untextured shapes
+        std::uint8_t color[4];
+    };
+
+    struct Element {
+        unsigned int characterSize;     // 0 for shapes
+        std::string text;
+        std::vector<HudVertex> local;
+        glm::vec2 boundsMin, boundsSize;
+        glm::vec2 position;
+        glm::vec2 scale;
+        sf::Color color;
+        float outline;
+        bool visible;
+    };
+
+    // A run of consecutive elements drawn with one glyph page; 0 while it holds only shapes.
+    struct Batch {
+        unsigned int characterSize;
+        int first, count;
+    };
+
+    static void AppendQuad(std::vector<HudVertex>& vertices, glm::vec2 min, glm::vec2 max, glm::vec2 uvMin, glm::vec2 uvMax);
+
+    ElementId AddElement(unsigned int characterSize, sf::Color color);
+    void LayoutText(Element& element);
+    void Rebuild();
+
+    const sf::Font& m_Font;
+    Shader hudShader;
+    unsigned int hudVAO, hudVBO;
+    std::size_t m_BufferCapacity;
+
+    std::vector<Element> m_Elements;
+    std::vector<Batch> m_Batches;
+    bool m_Dirty;
+};
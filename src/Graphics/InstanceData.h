@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+enum class MaterialID : std::uint8_t {
+    WALL = 0,
+    FLOOR,
+    CEILING,
+    DOOR,
+    LOCKED_DOOR,
+    COUNT
+};
+
+constexpr int MATERIAL_COUNT = static_cast<int>(MaterialID::COUNT);
+
+// Compact per-instance record for translated + axis-scaled maze geometry.
+// scaleMaterial = scaleX | scaleY << 8 | scaleZ << 16 | material << 24, scales in 1/32 steps.
+struct PackedInstance {
+    glm::vec3 position;
+    std::uint32_t scaleMaterial;
+};
+
+static_assert(sizeof(PackedInstance) == 16, "PackedInstance must stay 16 bytes");
+
+constexpr float INSTANCE_SCALE_STEP = 1.0f / 32.0f;
+
+inline PackedInstance PackInstance(glm::vec3 position, glm::vec3 scale, MaterialID material) {
+    auto quantize = [](float s) {
+        long q = std::lround(s / INSTANCE_SCALE_STEP);
+        return static_cast<std::uint32_t>(std::clamp(q, 1L, 255L));
+    };
+
+    PackedInstance instance;
+    instance.position = position;
+    instance.scaleMaterial = quantize(scale.x)
+                           | (quantize(scale.y) << 8)
+                           | (quantize(scale.z) << 16)
+                           | (static_cast<std::uint32_t>(material) << 24);
+    return instance;
+}
+
+inline glm::vec3 UnpackScale(const PackedInstance& instance) {
+    return glm::vec3(
+        static_cast<float>(instance.scaleMaterial & 0xFFu),
+        static_cast<float>((instance.scaleMaterial >> 8) & 0xFFu),
+        static_cast<float>((instance.scaleMaterial >> 16) & 0xFFu)
+    ) * INSTANCE_SCALE_STEP;
+}
+
+inline MaterialID UnpackMaterial(const PackedInstance& instance) {
+    return static_cast<MaterialID>(instance.scaleMaterial >> 24);
+}
@@ -0,0 +1,133 @@
+#include "LightGrid.h"
+#include <algorithm>
+
+LightGrid::LightGrid() : m_LightCount(0), m_Merged(false) {
+    glGenTextures(1, &cellTexture);
+    glBindTexture(GL_TEXTURE_2D, cellTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenBuffers(1, &indexTBO);
+    glGenTextures(1, &indexTexture);
+    glGenBuffers(1, &lightTBO);
+    glGenTextures(1, &lightTexture);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, indexTBO);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(unsigned int), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, indexTBO);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, lightTBO);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lightTBO);
+
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+LightGrid::~LightGrid() {
+    glDeleteTextures(1, &cellTexture);
+    glDeleteTextures(1, &indexTexture);
+    glDeleteTextures(1, &lightTexture);
+    glDeleteBuffers(1, &indexTBO);
+    glDeleteBuffers(1, &lightTBO);
+}
+
+void LightGrid::SetBins(std::shared_ptr<const MazeGeometry> geometry) {
+    m_Geometry = std::move(geometry);
+    m_Merged = false;
+    UploadBins(m_Geometry->lightCellRanges, m_Geometry->lightIndices);
+}
+
+void LightGrid::UploadBins(const std::vector<unsigned int>& cellRanges, const std::vector<unsigned int>& indices) {
+    glBindTexture(GL_TEXTURE_2D, cellTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, m_Geometry->width, m_Geometry->height, 0, GL_RG_INTEGER, GL_UNSIGNED_INT,
+                 cellRanges.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const unsigned int empty = 0;
+    const std::size_t indexBytes = indices.size() * sizeof(unsigned int);
+    glBindBuffer(GL_TEXTURE_BUFFER, indexTBO);
+    glBufferData(GL_TEXTURE_BUFFER, std::max(indexBytes, sizeof(unsigned int)),
+                 indexBytes ? indices.data() : &empty, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightGrid::SetLights(const std::vector<GridLight>& lights) {
+    if (!m_Geometry) return;
+    m_LightCount = static_cast<int>(lights.size());
+
+    // Fixtures still where they were binned keep their baked bins; everything else is binned now.
+    const std::vector<GridLight>& fixtures = m_Geometry->dynamicLights;
+    m_Stale.assign(fixtures.size(), 1);
+    m_RuntimeCells.clear();
+    for (unsigned int i = 0; i < lights.size(); i++) {
+        if (i < fixtures.size() && lights[i].position == fixtures[i].position && lights[i].radius <= fixtures[i].radius) {
+            m_Stale[i] = 0;
+            continue;
+        }
+        m_Geometry->ForEachLitCell(lights[i], [this, i](std::size_t cell) { m_RuntimeCells.emplace_back(cell, i); });
+    }
+
+    const bool merge = !m_RuntimeCells.empty() || std::find(m_Stale.begin(), m_Stale.end(), 1) != m_Stale.end();
+    if (merge) {
+        std::sort(m_RuntimeCells.begin(), m_RuntimeCells.end());
+        const std::vector<unsigned int>& ranges = m_Geometry->lightCellRanges;
+        const std::vector<unsigned int>& indices = m_Geometry->lightIndices;
+        m_CellRanges.resize(ranges.size());
+        m_Indices.clear();
+        std::size_t runtime = 0;
+        for (std::size_t cell = 0; cell * 2 < ranges.size(); cell++) {
+            const unsigned int offset = static_cast<unsigned int>(m_Indices.size());
+            for (unsigned int j = ranges[cell * 2]; j < ranges[cell * 2] + ranges[cell * 2 + 1]; j++) {
+                if (!m_Stale[indices[j]]) m_Indices.push_back(indices[j]);
+            }
+            for (; runtime < m_RuntimeCells.size() && m_RuntimeCells[runtime].first == cell; runtime++) {
+                m_Indices.push_back(m_RuntimeCells[runtime].second);
+            }
+            m_CellRanges[cell * 2] = offset;
+            m_CellRanges[cell * 2 + 1] = static_cast<unsigned int>(m_Indices.size()) - offset;
+        }
+        UploadBins(m_CellRanges, m_Indices);
+        m_Merged = true;
+    } else if (m_Merged) {
+        UploadBins(m_Geometry->lightCellRanges, m_Geometry->lightIndices);
+        m_Merged = false;
+    }
+
+    m_LightData.resize(std::max<std::size_t>(lights.size() * 3, 1));
+    for (std::size_t i = 0; i < lights.size(); i++) {
+        m_LightData[i * 3]     = glm::vec4(lights[i].position, lights[i].radius);
+        m_LightData[i * 3 + 1] = glm::vec4(lights[i].color, lights[i].intensity);
+        m_LightData[i * 3 + 2] = glm::vec4(lights[i].direction, lights[i].cosOuterCutOff);
+    }
+
+    // Orphan then refill so the driver never waits on last frame's reads.
+    glBindBuffer(GL_TEXTURE_BUFFER, lightTBO);
+    glBufferData(GL_TEXTURE_BUFFER, m_LightData.size() * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, m_LightData.size() * sizeof(glm::vec4), m_LightData.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightGrid::Bind(Shader& shader, int firstUnit) const {
+    shader.Use();
+
+    glActiveTexture(GL_TEXTURE0 + firstUnit);
+    glBindTexture(GL_TEXTURE_2D, cellTexture);
+    shader.SetInt("lightCells", firstUnit);
+
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+    glBindTexture(GL_TEXTURE_BUFFER, indexTexture);
+    shader.SetInt("lightIndices", firstUnit + 1);
+
+    glActiveTexture(GL_TEXTURE0 + firstUnit + 2);
+    glBindTexture(GL_TEXTURE_BUFFER, lightTexture);
+    shader.SetInt("lightData", firstUnit + 2);
+
+    shader.SetBool("useLightGrid", m_LightCount > 0);
+    glActiveTexture(GL_TEXTURE0);
+}
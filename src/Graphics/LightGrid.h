@@ -0,0 +1,49 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Shader.h"
+#include "GridLight.h"
+#include "MazeGeometry.h"
+
+// Uploads the maze's per-cell light lists, an (offset, count) pair per tile into a compact
+// light-index list, so each fragment only evaluates the lights that can reach its cell.
+// The level's fixtures are binned by line of sight with its MazeGeometry and uploaded only when
+// that changes. Each frame, lights that are not one of those fixtures in its binned place (moving
+// or spawned lights) are binned the same way and merged in; frames without any only upload the
+// light data, which flickers.
+class LightGrid {
+public:
+    LightGrid();
+    ~LightGrid();
+
+    void SetBins(std::shared_ptr<const MazeGeometry> geometry);
+    // The first lights usually are the geometry's dynamicLights, in order; any other light, or one
+    // that moved, is binned this frame.
+    void SetLights(const std::vector<GridLight>& lights);
+
+    // Binds the cell, index and light-data textures to three consecutive units starting at firstUnit.
+    void Bind(Shader& shader, int firstUnit) const;
+
+    int GetLightCount() const { return m_LightCount; }
+
+private:
+    unsigned int cellTexture;
+    unsigned int indexTBO, indexTexture;
+    unsigned int lightTBO, lightTexture;
+
+    int m_LightCount;
+    // Whether the uploaded lists hold this frame's runtime lights rather than the geometry's bins.
+    bool m_Merged;
+
+    void UploadBins(const std::vector<unsigned int>& cellRanges, const std::vector<unsigned int>& indices);
+
+    std::shared_ptr<const MazeGeometry> m_Geometry;
+    std::vector<unsigned char> m_Stale;
+    std::vector<std::pair<std::size_t, unsigned int>> m_RuntimeCells;
+    std::vector<unsigned int> m_CellRanges;
+    std::vector<unsigned int> m_Indices;
+    std::vector<glm::vec4> m_LightData;
+};
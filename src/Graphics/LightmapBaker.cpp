@@ -0,0 +1,315 @@
+#include "LightmapBaker.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Profiler.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr float FLOOR_Y = 0.0f;
+    constexpr float CEILING_Y = 3.5f;
+    // Wall boxes start below the floor; wall blocks span WALL_BOTTOM..CEILING_Y like shader.frag reads them.
+    constexpr float WALL_BOTTOM = -0.5f;
+    constexpr float AO_RADIUS = 1.5f;
+    constexpr int AO_RAYS = 32;
+    constexpr std::uint32_t CACHE_MAGIC = 0x50414D4C; // "LMAP"
+    constexpr std::uint32_t CACHE_VERSION = 3;
+
+    struct CacheHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t blockSize;
+        std::uint64_t hash;
+    };
+
+    bool IsWall(const Map& map, int x, int z) {
+        int tile = map.GetTile(x, z);
+        return tile == 1 || tile == 9;
+    }
+
+    bool IsSolid(const Map& map, int x, int z) {
+        int tile = map.GetTile(x, z);
+        return IsWall(map, x, z) || tile == 2 || tile == 5;
+    }
+
+    // Distance to the first wall cell, floor or ceiling along the ray, or maxDistance if nothing is hit.
+    // Doors are traced as open: an opened door leaves no geometry behind and the map never rebakes,
+    // so a closed door lets some static light through rather than an opened one leaving a shadow.
+    float TraceGrid(const Map& map, glm::vec3 origin, glm::vec3 dir, float maxDistance) {
+        float limit = maxDistance;
+        if (dir.y < 0.0f) limit = std::min(limit, (FLOOR_Y - origin.y) / dir.y);
+        if (dir.y > 0.0f) limit = std::min(limit, (CEILING_Y - origin.y) / dir.y);
+
+        int cellX = static_cast<int>(std::floor(origin.x));
+        int cellZ = static_cast<int>(std::floor(origin.z));
+        int stepX = dir.x > 0.0f ? 1 : -1;
+        int stepZ = dir.z > 0.0f ? 1 : -1;
+
+        float deltaX = dir.x != 0.0f ? std::abs(1.0f / dir.x) : 1e30f;
+        float deltaZ = dir.z != 0.0f ? std::abs(1.0f / dir.z) : 1e30f;
+        float nextX = dir.x != 0.0f ? ((stepX > 0 ? cellX + 1 - origin.x : origin.x - cellX) * deltaX) : 1e30f;
+        float nextZ = dir.z != 0.0f ? ((stepZ > 0 ? cellZ + 1 - origin.z : origin.z - cellZ) * deltaZ) : 1e30f;
+
+        float t = 0.0f;
+        while (t < limit) {
+            if (nextX < nextZ) {
+                t = nextX;
+                nextX += deltaX;
+                cellX += stepX;
+            } else {
+                t = nextZ;
+                nextZ += deltaZ;
+                cellZ += stepZ;
+            }
+            if (t < limit && IsWall(map, cellX, cellZ)) return t;
+        }
+        return limit;
+    }
+
+    // Face position and normal for texel (u, v) in [0, 1] of cell (x, z).
+    // Wall texels below the floor are lit as if at floor height.
+    void FaceSample(int x, int z, int face, float u, float v, glm::vec3& pos, glm::vec3& normal) {
+        float y = std::max(FLOOR_Y, WALL_BOTTOM + v * (CEILING_Y - WALL_BOTTOM));
+        switch (face) {
+            case 0: pos = {x + 1.0f, y, z + u}; normal = {1, 0, 0}; break;
+            case 1: pos = {x + 0.0f, y, z + u}; normal = {-1, 0, 0}; break;
+            case 2: pos = {x + u, FLOOR_Y, z + v}; normal = {0, 1, 0}; break;
+            case 3: pos = {x + u, CEILING_Y, z + v}; normal = {0, -1, 0}; break;
+            case 4: pos = {x + u, y, z + 1.0f}; normal = {0, 0, 1}; break;
+            default: pos = {x + u, y, z + 0.0f}; normal = {0, 0, -1}; break;
+        }
+    }
+
+    // Faces a door hides are baked too, for when it opens: the door cell's floor and ceiling and
+    // the wall faces beside it.
+    bool FaceIsVisible(const Map& map, int x, int z, int face) {
+        bool solid = IsSolid(map, x, z);
+        switch (face) {
+            case 0: return solid && !IsWall(map, x + 1, z);
+            case 1: return solid && !IsWall(map, x - 1, z);
+            case 4: return solid && !IsWall(map, x, z + 1);
+            case 5: return solid && !IsWall(map, x, z - 1);
+            default: return !IsWall(map, x, z);
+        }
+    }
+
+    // Cosine-weighted hemisphere directions around +Z from a Hammersley set.
+    std::vector<glm::vec3> BuildHemisphereKernel() {
+        std::vector<glm::vec3> kernel;
+        for (int i = 0; i < AO_RAYS; i++) {
+            std::uint32_t bits = static_cast<std::uint32_t>(i);
+            bits = (bits << 16u) | (bits >> 16u);
+            bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+            bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+            bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+            bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+            float u = (i + 0.5f) / AO_RAYS;
+            float v = static_cast<float>(bits) * 2.3283064365386963e-10f;
+
+            float r = std::sqrt(u);
+            float phi = 6.28318530718f * v;
+            kernel.emplace_back(r * std::cos(phi), r * std::sin(phi), std::sqrt(std::max(0.0f, 1.0f - u)));
+        }
+        return kernel;
+    }
+
+    std::uint8_t ToByte(float value) {
+        return static_cast<std::uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+}
+
+std::atomic<int> LightmapBaker::maxTextureSize{16384};
+
+unsigned int LightmapData::CreateTexture() const {
+    if (texels.empty()) return 0;
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (width > maxSize || height > maxSize) {
+        std::cerr << "ERROR: Lightmap " << width << "x" << height << " exceeds GL_MAX_TEXTURE_SIZE " << maxSize
+                  << ", rendering without baked lighting" << std::endl;
+        return 0;
+    }
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return textureID;
+}
+
+LightmapData LightmapBaker::Bake(const Map& map, const std::vector<GridLight>& staticLights, int blockSize) {
+    auto start = std::chrono::steady_clock::now();
+
+    LightmapData data;
+    data.blockSize = blockSize;
+    data.width = map.GetWidth() * 3 * blockSize;
+    data.height = map.GetHeight() * 2 * blockSize;
+    data.texels.assign(static_cast<std::size_t>(data.width) * data.height * 4, 0);
+    for (std::size_t i = 3; i < data.texels.size(); i += 4) data.texels[i] = 255;
+
+    const std::vector<glm::vec3> kernel = BuildHemisphereKernel();
+
+    auto bakeCell = [&](int x, int z) {
+        for (int face = 0; face < 6; face++) {
+            if (!FaceIsVisible(map, x, z, face)) continue;
+
+            int originX = (x * 3 + face % 3) * blockSize;
+            int originY = (z * 2 + face / 3) * blockSize;
+
+            for (int ty = 0; ty < blockSize; ty++) {
+                for (int tx = 0; tx < blockSize; tx++) {
+                    float u = static_cast<float>(tx) / (blockSize - 1);
+                    float v = static_cast<float>(ty) / (blockSize - 1);
+
+                    glm::vec3 pos, normal;
+                    FaceSample(x, z, face, u, v, pos, normal);
+                    glm::vec3 origin = pos + normal * 0.01f;
+
+                    glm::vec3 helper = std::abs(normal.y) > 0.5f ? glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+                    glm::vec3 tangent = glm::normalize(glm::cross(helper, normal));
+                    glm::vec3 bitangent = glm::cross(normal, tangent);
+
+                    float occlusion = 0.0f;
+                    for (const auto& k : kernel) {
+                        glm::vec3 dir = tangent * k.x + bitangent * k.y + normal * k.z;
+                        float hit = TraceGrid(map, origin, dir, AO_RADIUS);
+                        occlusion += 1.0f - hit / AO_RADIUS;
+                    }
+                    float ao = 1.0f - occlusion / AO_RAYS;
+
+                    glm::vec3 irradiance(0.0f);
+                    for (const auto& light : staticLights) {
+                        glm::vec3 toLight = light.position - origin;
+                        float dist = glm::length(toLight);
+                        if (dist >= light.radius) continue;
+                        glm::vec3 L = toLight / dist;
+                        float ndotl = glm::dot(normal, L);
+                        if (ndotl <= 0.0f) continue;
+                        if (TraceGrid(map, origin, L, dist) < dist - 0.01f) continue;
+
+                        // Same windowed falloff as EvaluateGridLights in shader.frag.
+                        float window = 1.0f - (dist * dist) / (light.radius * light.radius);
+                        float falloff = window * window / (1.0f + dist * dist);
+                        irradiance += light.color * light.intensity * falloff * ndotl;
+                    }
+
+                    std::size_t texel = (static_cast<std::size_t>(originY + ty) * data.width + originX + tx) * 4;
+                    data.texels[texel]     = ToByte(irradiance.r / LIGHTMAP_RANGE);
+                    data.texels[texel + 1] = ToByte(irradiance.g / LIGHTMAP_RANGE);
+                    data.texels[texel + 2] = ToByte(irradiance.b / LIGHTMAP_RANGE);
+                    data.texels[texel + 3] = ToByte(ao);
+                }
+            }
+        }
+    };
+
+
+    JobSystem& jobs = JobSystem::Shared();
+    const unsigned int threadCount = jobs.GetThreadCount();
+    jobs.ParallelFor(0, map.GetHeight(), 1, [&](int firstRow, int lastRow) {
+        MAZE_PROFILE_SCOPE("LightmapBaker::BakeRows");
+        for (int z = firstRow; z < lastRow; z++) {
+            for (int x = 0; x < map.GetWidth(); x++) bakeCell(x, z);
+        }
+    });
+
+    auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Lightmap baked: " << data.width << "x" << data.height << " on " << threadCount
+              << " threads in " << elapsed << " ms" << std::endl;
+    return data;
+}
+
+LightmapData LightmapBaker::LoadOrBake(const std::string& levelPath, const Map& map, const std::vector<GridLight>& staticLights) {
+    MAZE_PROFILE_SCOPE("LightmapBaker::LoadOrBake");
+    std::string cachePath = levelPath + ".lightmap";
+    LightmapData data;
+    const int blockSize = ChooseBlockSize(map);
+    if (blockSize == 0) return data;
+    std::uint64_t hash = ComputeHash(map, blockSize, staticLights);
+    if (LoadCache(cachePath, hash, data)) return data;
+
+    data = Bake(map, staticLights, blockSize);
+    SaveCache(cachePath, hash, data);
+    return data;
+}
+
+int LightmapBaker::ChooseBlockSize(const Map& map) {
+    const int maxSize = maxTextureSize.load(std::memory_order_relaxed);
+    for (int blockSize = BLOCK_SIZE; blockSize >= MIN_BLOCK_SIZE; blockSize--) {
+        if (map.GetWidth() * 3 * blockSize > maxSize || map.GetHeight() * 2 * blockSize > maxSize) continue;
+        if (blockSize < BLOCK_SIZE) {
+            std::cerr << "WARNING: Lightmap blocks reduced to " << blockSize << "x" << blockSize << " for a "
+                      << map.GetWidth() << "x" << map.GetHeight() << " map to fit GL_MAX_TEXTURE_SIZE " << maxSize << std::endl;
+        }
+        return blockSize;
+    }
+    std::cerr << "ERROR: " << map.GetWidth() << "x" << map.GetHeight() << " map is too large for a lightmap under GL_MAX_TEXTURE_SIZE "
+              << maxSize << ", rendering without baked lighting" << std::endl;
+    return 0;
+}
+
+std::uint64_t LightmapBaker::ComputeHash(const Map& map, int blockSize, const std::vector<GridLight>& staticLights) {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* bytes, std::size_t size) {
+        const auto* p = static_cast<const std::uint8_t*>(bytes);
+        for (std::size_t i = 0; i < size; i++) {
+            hash ^= p[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    int header[4] = {map.GetWidth(), map.GetHeight(), blockSize, AO_RAYS};
+    mix(header, sizeof(header));
+    for (int z = 0; z < map.GetHeight(); z++) {
+        for (int x = 0; x < map.GetWidth(); x++) {
+            int tile = map.GetTile(x, z);
+            mix(&tile, sizeof(tile));
+        }
+    }
+    for (const auto& light : staticLights) mix(&light, sizeof(GridLight));
+    return hash;
+}
+
+bool LightmapBaker::LoadCache(const std::string& path, std::uint64_t hash, LightmapData& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!file || header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.hash != hash) {
+        std::cout << "Lightmap cache stale, rebaking: " << path << std::endl;
+        return false;
+    }
+
+    out.width = static_cast<int>(header.width);
+    out.height = static_cast<int>(header.height);
+    out.blockSize = static_cast<int>(header.blockSize);
+    out.texels.resize(static_cast<std::size_t>(out.width) * out.height * 4);
+    file.read(reinterpret_cast<char*>(out.texels.data()), static_cast<std::streamsize>(out.texels.size()));
+    return static_cast<bool>(file);
+}
+
+void LightmapBaker::SaveCache(const std::string& path, std::uint64_t hash, const LightmapData& data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "WARNING: Could not write lightmap cache: " << path << std::endl;
+        return;
+    }
+
+    CacheHeader header = {CACHE_MAGIC, CACHE_VERSION, static_cast<std::uint32_t>(data.width),
+                          static_cast<std::uint32_t>(data.height), static_cast<std::uint32_t>(data.blockSize), hash};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(data.texels.data()), static_cast<std::streamsize>(data.texels.size()));
+}
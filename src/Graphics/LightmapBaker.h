@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "GridLight.h"
+#include "../Entities/Map.h"
+
+// RGBA8 atlas: rgb = static irradiance / LIGHTMAP_RANGE, a = ambient occlusion.
+// Each map cell owns a 3x2 grid of blockSize^2 blocks, one per face (+X, -X, +Y, -Y, +Z, -Z).
+// Empty when the map is too large for any block size to fit the GL texture limit.
+struct LightmapData {
+    int width = 0;
+    int height = 0;
+    int blockSize = 0;
+    std::vector<std::uint8_t> texels;
+
+    // 0 when there is nothing to upload or the atlas exceeds GL_MAX_TEXTURE_SIZE.
+    unsigned int CreateTexture() const;
+};
+
+class LightmapBaker {
+public:
+    // Blocks shrink from BLOCK_SIZE down to MIN_BLOCK_SIZE when a large map's atlas would not fit.
+    static constexpr int BLOCK_SIZE = 8;
+    static constexpr int MIN_BLOCK_SIZE = 2;
+    static constexpr float LIGHTMAP_RANGE = 4.0f;
+
+    // GL thread, before the first bake: GL_MAX_TEXTURE_SIZE. Offline bakes without a context assume
+    // the 16384 most desktop drivers report.
+    static void SetMaxTextureSize(int size) { maxTextureSize.store(size, std::memory_order_relaxed); }
+
+    // Ray-traces the grid on all cores.
+    static LightmapData Bake(const Map& map, const std::vector<GridLight>& staticLights, int blockSize = BLOCK_SIZE);
+
+    // Reuses <levelPath>.lightmap when it matches the map and lights, otherwise bakes and rewrites it.
+    // Picks the largest block size whose atlas fits the GL texture limit, or returns empty data.
+    static LightmapData LoadOrBake(const std::string& levelPath, const Map& map, const std::vector<GridLight>& staticLights);
+
+private:
+    static int ChooseBlockSize(const Map& map);
+    static std::uint64_t ComputeHash(const Map& map, int blockSize, const std::vector<GridLight>& staticLights);
+    static bool LoadCache(const std::string& path, std::uint64_t hash, LightmapData& out);
+    static void SaveCache(const std::string& path, std::uint64_t hash, const LightmapData& data);
+
+    static std::atomic<int> maxTextureSize;
+};
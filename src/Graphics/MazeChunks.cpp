@@ -0,0 +1,102 @@
+#include "MazeChunks.h"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+MazeChunks::MazeChunks(Renderer& renderer) {
+    glGenBuffers(1, &instanceVBO);
+    vao = renderer.CreateMeshVAO();
+}
+
+MazeChunks::~MazeChunks() {
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &instanceVBO);
+}
+
+void MazeChunks::Upload(const std::vector<PackedInstance>& instances) {
+    std::unordered_map<long long, int> chunkLookup;
+    std::vector<std::array<std::vector<PackedInstance>, MATERIAL_COUNT>> buckets;
+
+    m_Chunks.clear();
+    for (const auto& instance : instances) {
+        long long cx = static_cast<long long>(std::floor(instance.position.x / CHUNK_SIZE));
+        long long cz = static_cast<long long>(std::floor(instance.position.z / CHUNK_SIZE));
+        long long key = (cx << 32) ^ (cz & 0xFFFFFFFFll);
+
+        auto [it, inserted] = chunkLookup.try_emplace(key, static_cast<int>(m_Chunks.size()));
+        if (inserted) {
+            m_Chunks.push_back({glm::vec3(1e30f), glm::vec3(-1e30f), {}});
+            buckets.emplace_back();
+        }
+
+        Chunk& chunk = m_Chunks[it->second];
+        glm::vec3 halfExtent = UnpackScale(instance) * 0.5f;
+        chunk.boundsMin = glm::min(chunk.boundsMin, instance.position - halfExtent);
+        chunk.boundsMax = glm::max(chunk.boundsMax, instance.position + halfExtent);
+        buckets[it->second][static_cast<int>(UnpackMaterial(instance))].push_back(instance);
+    }
+
+
+    std::vector<PackedInstance> sorted;
+    sorted.reserve(instances.size());
+    for (std::size_t c = 0; c < m_Chunks.size(); c++) {
+        for (int m = 0; m < MATERIAL_COUNT; m++) {
+            m_Chunks[c].ranges[m] = {static_cast<int>(sorted.size()), static_cast<int>(buckets[c][m].size())};
+            sorted.insert(sorted.end(), buckets[c][m].begin(), buckets[c][m].end());
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, sorted.size() * sizeof(PackedInstance), sorted.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_ChunkDistances.resize(m_Chunks.size());
+}
+
+const std::vector<int>& MazeChunks::GatherVisible(const Frustum& frustum, glm::vec3 viewPos, bool sortFrontToBack) {
+    m_VisibleChunks.clear();
+    for (int c = 0; c < static_cast<int>(m_Chunks.size()); c++) {
+        const Chunk& chunk = m_Chunks[c];
+        glm::vec3 center = (chunk.boundsMin + chunk.boundsMax) * 0.5f;
+        glm::vec3 halfExtent = (chunk.boundsMax - chunk.boundsMin) * 0.5f;
+        if (!frustum.IntersectsAABB(center, halfExtent)) continue;
+
+        glm::vec3 closest = glm::clamp(viewPos, chunk.boundsMin, chunk.boundsMax);
+        m_ChunkDistances[c] = glm::dot(closest - viewPos, closest - viewPos);
+        m_VisibleChunks.push_back(c);
+    }
+
+    if (sortFrontToBack) {
+        std::sort(m_VisibleChunks.begin(), m_VisibleChunks.end(), [this](int a, int b) {
+            return m_ChunkDistances[a] < m_ChunkDistances[b];
+        });
+    }
+    return m_VisibleChunks;
+}
+
+void MazeChunks::Draw(Shader& shader, const std::vector<int>& chunkOrder,
+                      const std::array<unsigned int, MATERIAL_COUNT>* textures) {
+    shader.Use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+
+    unsigned int boundTexture = 0;
+    for (int c : chunkOrder) {
+        for (int m = 0; m < MATERIAL_COUNT; m++) {
+            const Range& range = m_Chunks[c].ranges[m];
+            if (range.count == 0) continue;
+
+            if (textures && (*textures)[m] != boundTexture) {
+                boundTexture = (*textures)[m];
+                glBindTexture(GL_TEXTURE_2D, boundTexture);
+            }
+
+            // GL 3.3 has no base instance, so re-point the instance stream at this range.
+            Renderer::SetPackedInstanceAttributes(range.first);
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 36, range.count);
+        }
+    }
+
+    glBindVertexArray(0);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <vector>
+#include "Shader.h"
+#include "Renderer.h"
+#include "Frustum.h"
+#include "InstanceData.h"
+
+// GL 3.3 path for static maze geometry: instances are grouped into CHUNK_SIZE x CHUNK_SIZE tile
+// chunks so whole chunks can be frustum-culled and drawn front-to-back.
+class MazeChunks {
+public:
+    static constexpr int CHUNK_SIZE = 8;
+
+    explicit MazeChunks(Renderer& renderer);
+    ~MazeChunks();
+
+    void Upload(const std::vector<PackedInstance>& instances);
+
+    // Visible chunk indices, optionally sorted nearest-first.
+    const std::vector<int>& GatherVisible(const Frustum& frustum, glm::vec3 viewPos, bool sortFrontToBack);
+
+    // textures == nullptr draws without binding any material texture (depth prepass).
+    void Draw(Shader& shader, const std::vector<int>& chunkOrder,
+              const std::array<unsigned int, MATERIAL_COUNT>* textures);
+
+private:
+    struct Range {
+        int first;
+        int count;
+    };
+
+    struct Chunk {
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+        std::array<Range, MATERIAL_COUNT> ranges;
+    };
+
+    unsigned int vao, instanceVBO;
+
+    std::vector<Chunk> m_Chunks;
+    std::vector<int> m_VisibleChunks;
+    std::vector<float> m_ChunkDistances;
+};
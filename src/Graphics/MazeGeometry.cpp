@@ -0,0 +1,160 @@
+#include "MazeGeometry.h"
+#include "../Core/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float DUST_RATE = 60.0f;
+    constexpr float DEBRIS_RATE = 25.0f;
+    constexpr float DEBRIS_DEPTH = 0.2f;
+    constexpr float LINTEL_Y = 2.0f;
+    constexpr float CEILING_Y = 3.5f;
+
+    constexpr float LIGHT_SAMPLE_INSET = 0.1f;
+
+    bool IsOpen(int tile) {
+        return tile == 0 || tile == 3 || tile == 4;
+    }
+
+    bool IsOpaque(int tile) {
+        return tile == 1 || tile == 2 || tile == 5 || tile == 9;
+    }
+
+    void BinLights(MazeGeometry& geometry) {
+        const std::size_t cellCount = static_cast<std::size_t>(geometry.width) * geometry.height;
+        std::vector<std::vector<unsigned int>> cellLights(cellCount);
+        for (unsigned int i = 0; i < geometry.dynamicLights.size(); i++) {
+            geometry.ForEachLitCell(geometry.dynamicLights[i], [&](std::size_t cell) { cellLights[cell].push_back(i); });
+        }
+
+        geometry.lightCellRanges.assign(cellCount * 2, 0);
+        geometry.lightIndices.clear();
+        for (std::size_t cell = 0; cell < cellCount; cell++) {
+            geometry.lightCellRanges[cell * 2] = static_cast<unsigned int>(geometry.lightIndices.size());
+            geometry.lightCellRanges[cell * 2 + 1] = static_cast<unsigned int>(cellLights[cell].size());
+            geometry.lightIndices.insert(geometry.lightIndices.end(), cellLights[cell].begin(), cellLights[cell].end());
+        }
+    }
+}
+
+bool MazeGeometry::IsOpaqueCell(int x, int z) const {
+    if (x < 0 || x >= width || z < 0 || z >= height) return true;
+    return opaqueCells[static_cast<std::size_t>(z) * width + x] != 0;
+}
+
+// Walks the cells between from and to; neither end cell blocks, so lamps hung inside a lintel
+// still light both sides of their door.
+bool MazeGeometry::HasLineOfSight(glm::vec2 from, glm::vec2 to) const {
+    int cellX = static_cast<int>(std::floor(from.x));
+    int cellZ = static_cast<int>(std::floor(from.y));
+    const int endX = static_cast<int>(std::floor(to.x));
+    const int endZ = static_cast<int>(std::floor(to.y));
+    const glm::vec2 dir = to - from;
+    const int stepX = dir.x > 0.0f ? 1 : -1;
+    const int stepZ = dir.y > 0.0f ? 1 : -1;
+
+    const float deltaX = dir.x != 0.0f ? std::abs(1.0f / dir.x) : 1e30f;
+    const float deltaZ = dir.y != 0.0f ? std::abs(1.0f / dir.y) : 1e30f;
+    float nextX = dir.x != 0.0f ? (stepX > 0 ? cellX + 1 - from.x : from.x - cellX) * deltaX : 1e30f;
+    float nextZ = dir.y != 0.0f ? (stepZ > 0 ? cellZ + 1 - from.y : from.y - cellZ) * deltaZ : 1e30f;
+
+    if (cellX == endX && cellZ == endZ) return true;
+    while (true) {
+        // Once one axis is done only the other may step, so rounding cannot walk past the end cell.
+        if (cellZ == endZ || (cellX != endX && nextX < nextZ)) {
+            nextX += deltaX;
+            cellX += stepX;
+        } else {
+            nextZ += deltaZ;
+            cellZ += stepZ;
+        }
+        if (cellX == endX && cellZ == endZ) return true;
+        if (IsOpaqueCell(cellX, cellZ)) return false;
+    }
+}
+
+// A cell gets a light if its centre or one of its inset corners can see it.
+bool MazeGeometry::LightReachesCell(const GridLight& light, int x, int z) const {
+    const glm::vec2 origin(light.position.x, light.position.z);
+    const glm::vec2 nearest(std::clamp(origin.x, static_cast<float>(x), x + 1.0f),
+                            std::clamp(origin.y, static_cast<float>(z), z + 1.0f));
+    if (glm::distance(origin, nearest) >= light.radius) return false;
+
+    const float lo = LIGHT_SAMPLE_INSET, hi = 1.0f - LIGHT_SAMPLE_INSET;
+    const glm::vec2 samples[5] = {{0.5f, 0.5f}, {lo, lo}, {hi, lo}, {lo, hi}, {hi, hi}};
+    for (const glm::vec2& sample : samples) {
+        if (HasLineOfSight(origin, glm::vec2(x, z) + sample)) return true;
+    }
+    return false;
+}
+
+MazeGeometry MazeGeometry::Build(const Map& map) {
+    MAZE_PROFILE_SCOPE("MazeGeometry::Build");
+    MazeGeometry geometry;
+    geometry.width = map.GetWidth();
+    geometry.height = map.GetHeight();
+    geometry.opaqueCells.resize(static_cast<std::size_t>(geometry.width) * geometry.height);
+
+    for (int x = 0; x < map.GetWidth(); x++) {
+        for (int z = 0; z < map.GetHeight(); z++) {
+            int tile = map.GetTile(x, z);
+            geometry.opaqueCells[static_cast<std::size_t>(z) * geometry.width + x] = IsOpaque(tile) ? 1 : 0;
+            float cx = x + 0.5f;
+            float cz = z + 0.5f;
+
+            if (tile == 1 || tile == 9) {
+                geometry.instances.push_back(PackInstance({cx, 1.5f, cz}, {1.0f, 4.0f, 1.0f}, MaterialID::WALL));
+            }
+
+            if (tile == 0 || tile == 3 || tile == 4 || tile == 9) {
+                geometry.instances.push_back(PackInstance({cx, -0.5f, cz}, glm::vec3(1.0f), MaterialID::FLOOR));
+                geometry.instances.push_back(PackInstance({cx, 4.0f, cz}, glm::vec3(1.0f), MaterialID::CEILING));
+            }
+
+            if (tile == 2 || tile == 5) {
+                MaterialID door = (tile == 2) ? MaterialID::DOOR : MaterialID::LOCKED_DOOR;
+                geometry.instances.push_back(PackInstance({cx, 0.75f, cz}, {1.0f, 2.5f, 1.0f}, door));
+                geometry.instances.push_back(PackInstance({cx, 2.75f, cz}, {1.0f, 1.5f, 1.0f}, MaterialID::WALL));
+            }
+
+            if (tile == 4) {
+                geometry.keyPositions.emplace_back(cx, 0.5f, cz);
+            }
+
+            if (IsOpen(tile)) {
+                geometry.emitters.push_back({glm::vec3(x, 0.0f, z), glm::vec3(x + 1.0f, CEILING_Y, z + 1.0f),
+                                             ParticleKind::DUST, DUST_RATE});
+            }
+            if (tile == 2 || tile == 5) {
+                const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+                for (const auto& offset : offsets) {
+                    if (!IsOpen(map.GetTile(x + offset[0], z + offset[1]))) continue;
+                    // Thin strip just in front of the door face, under the lintel.
+                    glm::vec3 min(x, LINTEL_Y - 0.05f, z);
+                    glm::vec3 max(x + 1.0f, LINTEL_Y, z + 1.0f);
+                    if (offset[0] > 0) { min.x = x + 1.0f; max.x = x + 1.0f + DEBRIS_DEPTH; }
+                    if (offset[0] < 0) { min.x = x - DEBRIS_DEPTH; max.x = static_cast<float>(x); }
+                    if (offset[1] > 0) { min.z = z + 1.0f; max.z = z + 1.0f + DEBRIS_DEPTH; }
+                    if (offset[1] < 0) { min.z = z - DEBRIS_DEPTH; max.z = static_cast<float>(z); }
+                    geometry.emitters.push_back({min, max, ParticleKind::DEBRIS, DEBRIS_RATE});
+                }
+            }
+
+
+            if (tile == 0 && (x + 2 * z) % 7 == 0) {
+                GridLight fixture = {glm::vec3(cx, 3.3f, cz), 4.5f, glm::vec3(1.0f, 0.95f, 0.8f), 0.8f,
+                                     glm::vec3(0.0f, -1.0f, 0.0f), -2.0f};
+                // Every third fixture is a faulty tube that flickers, so it cannot be baked.
+                if ((x + z) % 3 == 0) geometry.dynamicLights.push_back(fixture);
+                else geometry.staticLights.push_back(fixture);
+            }
+            if (tile == 5) {
+                geometry.dynamicLights.push_back({glm::vec3(cx, 3.0f, cz), 3.0f, glm::vec3(1.0f, 0.1f, 0.05f), 0.6f,
+                                                  glm::vec3(0.0f, -1.0f, 0.0f), -2.0f});
+            }
+        }
+    }
+
+    BinLights(geometry);
+    return geometry;
+}
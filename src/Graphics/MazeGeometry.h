@@ -0,0 +1,52 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "InstanceData.h"
+#include "GridLight.h"
+#include "ParticleEmitter.h"
+#include "../Entities/Map.h"
+
+// Render data derived from a Map: static box instances for every wall, floor, ceiling and door
+// tile, pickup positions, light fixtures (static ones are baked, dynamic ones go through LightGrid)
+// and particle emitters: dust in every open cell, grit falling from door lintels into open neighbours.
+struct MazeGeometry {
+    int width = 0;
+    int height = 0;
+    std::vector<PackedInstance> instances;
+    std::vector<glm::vec3> keyPositions;
+    std::vector<GridLight> staticLights;
+    std::vector<GridLight> dynamicLights;
+    // LightGrid bins for dynamicLights: per cell an (offset, count) pair into lightIndices, holding
+    // only the lights with a line of sight to the cell, so walls and closed doors stop them.
+    std::vector<unsigned int> lightCellRanges;
+    std::vector<unsigned int> lightIndices;
+    // 1 for the walls and closed doors that stop light, row-major.
+    std::vector<std::uint8_t> opaqueCells;
+    std::vector<ParticleEmitter> emitters;
+
+    static MazeGeometry Build(const Map& map);
+
+    bool IsOpaqueCell(int x, int z) const;
+    bool LightReachesCell(const GridLight& light, int x, int z) const;
+
+    // Calls visit(cell index) for every open cell the light reaches. Opaque cells are never lit:
+    // fragments on wall and door faces look up the cell in front of them.
+    template <typename Visit>
+    void ForEachLitCell(const GridLight& light, Visit&& visit) const {
+        const int x0 = std::max(0, static_cast<int>(std::floor(light.position.x - light.radius)));
+        const int z0 = std::max(0, static_cast<int>(std::floor(light.position.z - light.radius)));
+        const int x1 = std::min(width - 1, static_cast<int>(std::floor(light.position.x + light.radius)));
+        const int z1 = std::min(height - 1, static_cast<int>(std::floor(light.position.z + light.radius)));
+        for (int z = z0; z <= z1; z++) {
+            for (int x = x0; x <= x1; x++) {
+                if (!IsOpaqueCell(x, z) && LightReachesCell(light, x, z)) visit(static_cast<std::size_t>(z) * width + x);
+            }
+        }
+    }
+
+private:
+    bool HasLineOfSight(glm::vec2 from, glm::vec2 to) const;
+};
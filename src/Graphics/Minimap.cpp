@@ -0,0 +1,90 @@
+#include "Minimap.h"
+#include "../Core/Profiler.h"
+#include <vector>
+
+namespace {
+    // Cells visible across the minimap.
+    constexpr float VIEW_CELLS = 24.0f;
+}
+
+Minimap::Minimap()
+    : m_Texture(0), m_Width(0), m_Height(0)
+{
+    m_Shader.Load("assets/shaders/minimap.vert", "assets/shaders/minimap.frag");
+    // The quad's corners come from gl_VertexID; core profiles still want a VAO bound.
+    glGenVertexArrays(1, &VAO);
+}
+
+Minimap::~Minimap() {
+    glDeleteVertexArrays(1, &VAO);
+    if (m_Texture) glDeleteTextures(1, &m_Texture);
+}
+
+void Minimap::Allocate(int width, int height) {
+    if (!m_Texture) glGenTextures(1, &m_Texture);
+    m_Width = width;
+    m_Height = height;
+
+    std::vector<std::uint8_t> unknown(static_cast<std::size_t>(width) * height, 0);
+    glBindTexture(GL_TEXTURE_2D, m_Texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, unknown.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Minimap::Apply(const MinimapUpdate& update) {
+    if (update.width <= 0 || update.height <= 0) return;
+    if (update.reset || update.width != m_Width || update.height != m_Height) Allocate(update.width, update.height);
+    if (update.rows.empty()) return;
+
+    glBindTexture(GL_TEXTURE_2D, m_Texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    const std::size_t count = update.rows.size();
+    std::size_t first = 0;
+    while (first < count) {
+        std::size_t last = first;
+        while (last + 1 < count && update.rows[last + 1] == update.rows[last] + 1) last++;
+
+        int rows = static_cast<int>(last - first + 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, update.rows[first], m_Width, rows, GL_RED, GL_UNSIGNED_BYTE,
+                        update.cells.data() + first * m_Width);
+        first = last + 1;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Minimap::Draw(glm::vec2 position, float size, int screenWidth, int screenHeight, glm::vec3 viewPos, glm::vec3 front) {
+    MAZE_PROFILE_SCOPE("Minimap::Draw");
+    if (!m_Texture) return;
+
+    glViewport(0, 0, screenWidth, screenHeight);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glm::vec2 heading(front.x, front.z);
+    float length = glm::length(heading);
+    heading = length > 1e-4f ? heading * (1.0f / length) : glm::vec2(1.0f, 0.0f);
+
+    m_Shader.Use();
+    m_Shader.SetVec2("screenSize", glm::vec2(screenWidth, screenHeight));
+    m_Shader.SetVec4("rect", glm::vec4(position.x, position.y, size, size));
+    m_Shader.SetVec2("center", glm::vec2(viewPos.x, viewPos.z));
+    m_Shader.SetVec2("heading", heading);
+    m_Shader.SetFloat("viewCells", VIEW_CELLS);
+    m_Shader.SetInt("cells", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_Texture);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+}
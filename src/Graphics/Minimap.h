@@ -0,0 +1,27 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "Shader.h"
+#include "../Entities/ExploredMap.h"
+
+// HUD minimap backed by one R8 texel per maze cell. Snapshots carry only the rows that changed,
+// which are uploaded with glTexSubImage2D (adjacent rows as one block). Drawing is a single quad
+// showing a fixed window of cells around the player, so its cost doesn't depend on the maze size.
+class Minimap {
+public:
+    Minimap();
+    ~Minimap();
+
+    void Apply(const MinimapUpdate& update);
+
+    // position/size in pixels (top-left origin, like HudRenderer); viewPos/front from the snapshot.
+    void Draw(glm::vec2 position, float size, int screenWidth, int screenHeight, glm::vec3 viewPos, glm::vec3 front);
+
+private:
+    void Allocate(int width, int height);
+
+    Shader m_Shader;
+    unsigned int VAO;
+    unsigned int m_Texture;
+    int m_Width, m_Height;
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+
+enum class ParticleKind : std::uint8_t {
+    DUST = 0,
+    DEBRIS
+};
+
+// Spawns particles uniformly inside an axis-aligned box tied to a map cell, at rate per second.
+struct ParticleEmitter {
+    glm::vec3 min;
+    glm::vec3 max;
+    ParticleKind kind;
+    float rate;
+};
@@ -0,0 +1,288 @@
+#include "ParticleSystem.h"
+#include "Frustum.h"
+#include "../Core/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MAZE_PARTICLES_SSE2 1
+#endif
+
+namespace {
+    constexpr float EMIT_RADIUS = 9.0f;
+    constexpr float FLOOR_Y = 0.0f;
+    constexpr float MAX_LIGHT_RANGE = 18.0f;
+    constexpr float BRIGHTNESS = 0.8f;
+    constexpr std::uint64_t SYNC_TIMEOUT_NS = 100000000;
+}
+
+ParticleSystem::ParticleSystem(int capacity)
+    : m_Capacity((capacity + 3) & ~3), m_Count(0), m_Drawn(0), m_RandomState(0x9E3779B9u), m_Segment(0)
+{
+    // Padded to a multiple of four so the SIMD loops never need a scalar tail.
+    for (auto* array : {&m_PosX, &m_PosY, &m_PosZ, &m_VelX, &m_VelY, &m_VelZ, &m_Life, &m_InvMaxLife, &m_Size, &m_Gravity}) {
+        array->assign(m_Capacity, 0.0f);
+    }
+    for (auto& fence : m_Fences) fence = nullptr;
+
+    m_Shader.Load("assets/shaders/particle.vert", "assets/shaders/particle.frag");
+
+    const float corners[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &quadVBO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(Instance)) * m_Capacity * SEGMENT_COUNT, nullptr, GL_STREAM_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+}
+
+ParticleSystem::~ParticleSystem() {
+    for (GLsync fence : m_Fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &quadVBO);
+    glDeleteBuffers(1, &instanceVBO);
+}
+
+void ParticleSystem::SetEmitters(const std::vector<ParticleEmitter>& emitters) {
+    m_Emitters = emitters;
+    m_EmitAccumulators.assign(m_Emitters.size(), 0.0f);
+}
+
+// xorshift32: spawning needs lots of cheap, not particularly good, random numbers.
+float ParticleSystem::Random01() {
+    m_RandomState ^= m_RandomState << 13;
+    m_RandomState ^= m_RandomState >> 17;
+    m_RandomState ^= m_RandomState << 5;
+    return (m_RandomState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::Update(float dt, glm::vec3 viewPos) {
+    MAZE_PROFILE_SCOPE("ParticleSystem::Update");
+    if (dt <= 0.0f) return;
+
+    Integrate(dt);
+    Compact();
+
+    for (std::size_t i = 0; i < m_Emitters.size(); i++) {
+        const ParticleEmitter& emitter = m_Emitters[i];
+        glm::vec3 center = (emitter.min + emitter.max) * 0.5f;
+        float dx = center.x - viewPos.x;
+        float dz = center.z - viewPos.z;
+        if (dx * dx + dz * dz > EMIT_RADIUS * EMIT_RADIUS) continue;
+
+        m_EmitAccumulators[i] += emitter.rate * dt;
+        int count = static_cast<int>(m_EmitAccumulators[i]);
+        m_EmitAccumulators[i] -= count;
+        Emit(emitter, std::min(count, m_Capacity - m_Count));
+    }
+}
+
+void ParticleSystem::Emit(const ParticleEmitter& emitter, int count) {
+    glm::vec3 extent = emitter.max - emitter.min;
+    for (int n = 0; n < count; n++) {
+        int i = m_Count++;
+        m_PosX[i] = emitter.min.x + extent.x * Random01();
+        m_PosY[i] = emitter.min.y + extent.y * Random01();
+        m_PosZ[i] = emitter.min.z + extent.z * Random01();
+
+        float life;
+        if (emitter.kind == ParticleKind::DUST) {
+            m_VelX[i] = (Random01() - 0.5f) * 0.1f;
+            m_VelY[i] = (Random01() - 0.6f) * 0.04f;
+            m_VelZ[i] = (Random01() - 0.5f) * 0.1f;
+            m_Size[i] = 0.006f + 0.009f * Random01();
+            m_Gravity[i] = 0.0f;
+            life = 6.0f + 6.0f * Random01();
+        } else {
+            m_VelX[i] = (Random01() - 0.5f) * 0.1f;
+            m_VelY[i] = -0.2f * Random01();
+            m_VelZ[i] = (Random01() - 0.5f) * 0.1f;
+            m_Size[i] = 0.01f + 0.01f * Random01();
+            m_Gravity[i] = 3.0f;
+            life = 1.5f + Random01();
+        }
+        m_Life[i] = life;
+        m_InvMaxLife[i] = 1.0f / life;
+    }
+}
+
+void ParticleSystem::Integrate(float dt) {
+    const int count = (m_Count + 3) & ~3;
+#ifdef MAZE_PARTICLES_SSE2
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 floorY = _mm_set1_ps(FLOOR_Y);
+    for (int i = 0; i < count; i += 4) {
+        __m128 vx = _mm_loadu_ps(&m_VelX[i]);
+        __m128 vy = _mm_loadu_ps(&m_VelY[i]);
+        __m128 vz = _mm_loadu_ps(&m_VelZ[i]);
+        vy = _mm_sub_ps(vy, _mm_mul_ps(_mm_loadu_ps(&m_Gravity[i]), vdt));
+
+        __m128 px = _mm_add_ps(_mm_loadu_ps(&m_PosX[i]), _mm_mul_ps(vx, vdt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(&m_PosY[i]), _mm_mul_ps(vy, vdt));
+        __m128 pz = _mm_add_ps(_mm_loadu_ps(&m_PosZ[i]), _mm_mul_ps(vz, vdt));
+
+        // Anything reaching the floor comes to rest on it.
+        __m128 airborne = _mm_cmpgt_ps(py, floorY);
+        py = _mm_max_ps(py, floorY);
+        vx = _mm_and_ps(vx, airborne);
+        vy = _mm_and_ps(vy, airborne);
+        vz = _mm_and_ps(vz, airborne);
+
+        _mm_storeu_ps(&m_PosX[i], px);
+        _mm_storeu_ps(&m_PosY[i], py);
+        _mm_storeu_ps(&m_PosZ[i], pz);
+        _mm_storeu_ps(&m_VelX[i], vx);
+        _mm_storeu_ps(&m_VelY[i], vy);
+        _mm_storeu_ps(&m_VelZ[i], vz);
+        _mm_storeu_ps(&m_Life[i], _mm_sub_ps(_mm_loadu_ps(&m_Life[i]), vdt));
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        m_VelY[i] -= m_Gravity[i] * dt;
+        m_PosX[i] += m_VelX[i] * dt;
+        m_PosY[i] += m_VelY[i] * dt;
+        m_PosZ[i] += m_VelZ[i] * dt;
+        if (m_PosY[i] <= FLOOR_Y) {
+            m_PosY[i] = FLOOR_Y;
+            m_VelX[i] = m_VelY[i] = m_VelZ[i] = 0.0f;
+        }
+        m_Life[i] -= dt;
+    }
+#endif
+}
+
+// Swap-with-last removal keeps [0, m_Count) dense without shifting.
+void ParticleSystem::Compact() {
+    int i = 0;
+    while (i < m_Count) {
+        if (m_Life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --m_Count;
+        for (auto* array : {&m_PosX, &m_PosY, &m_PosZ, &m_VelX, &m_VelY, &m_VelZ, &m_Life, &m_InvMaxLife, &m_Size, &m_Gravity}) {
+            (*array)[i] = (*array)[last];
+        }
+        m_Life[last] = 0.0f;
+    }
+}
+
+int ParticleSystem::Cull(Instance* out, glm::vec3 lightPos, glm::vec3 lightDir, float maxDistance) const {
+    const float cosOuter = std::cos(glm::radians(25.0f));
+    int written = 0;
+
+    auto emit = [&](int i) {
+        // Fade in over the first half second and out over the last second of life.
+        float age = 1.0f / m_InvMaxLife[i] - m_Life[i];
+        float alpha = std::min(std::min(age * 2.0f, m_Life[i]), 1.0f);
+        out[written++] = {glm::vec3(m_PosX[i], m_PosY[i], m_PosZ[i]), m_Size[i], alpha};
+    };
+
+#ifdef MAZE_PARTICLES_SSE2
+    const __m128 lx = _mm_set1_ps(lightPos.x), ly = _mm_set1_ps(lightPos.y), lz = _mm_set1_ps(lightPos.z);
+    const __m128 dx = _mm_set1_ps(lightDir.x), dy = _mm_set1_ps(lightDir.y), dz = _mm_set1_ps(lightDir.z);
+    const __m128 cos2 = _mm_set1_ps(cosOuter * cosOuter);
+    const __m128 range2 = _mm_set1_ps(maxDistance * maxDistance);
+    const __m128 zero = _mm_setzero_ps();
+    const int count = (m_Count + 3) & ~3;
+    for (int i = 0; i < count; i += 4) {
+        __m128 ox = _mm_sub_ps(_mm_loadu_ps(&m_PosX[i]), lx);
+        __m128 oy = _mm_sub_ps(_mm_loadu_ps(&m_PosY[i]), ly);
+        __m128 oz = _mm_sub_ps(_mm_loadu_ps(&m_PosZ[i]), lz);
+        __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), _mm_mul_ps(oz, oz));
+        __m128 along = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, dx), _mm_mul_ps(oy, dy)), _mm_mul_ps(oz, dz));
+
+        // Inside the cone: along > 0 and along^2 > cos^2 * dist^2, within range.
+        __m128 inside = _mm_and_ps(_mm_cmpgt_ps(along, zero), _mm_cmpgt_ps(_mm_mul_ps(along, along), _mm_mul_ps(cos2, dist2)));
+        inside = _mm_and_ps(inside, _mm_cmplt_ps(dist2, range2));
+        inside = _mm_and_ps(inside, _mm_cmpgt_ps(_mm_loadu_ps(&m_Life[i]), zero));
+
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; mask; lane++, mask >>= 1) {
+            if (mask & 1) emit(i + lane);
+        }
+    }
+#else
+    for (int i = 0; i < m_Count; i++) {
+        glm::vec3 offset(m_PosX[i] - lightPos.x, m_PosY[i] - lightPos.y, m_PosZ[i] - lightPos.z);
+        float dist2 = glm::dot(offset, offset);
+        float along = glm::dot(offset, lightDir);
+        if (along > 0.0f && along * along > cosOuter * cosOuter * dist2 && dist2 < maxDistance * maxDistance) emit(i);
+    }
+#endif
+    return written;
+}
+
+void ParticleSystem::Draw(const glm::mat4& projection, const glm::mat4& view, glm::vec3 viewPos,
+                          glm::vec3 lightPos, glm::vec3 lightDir, float lightIntensity, float fogDensity) {
+    MAZE_PROFILE_SCOPE("ParticleSystem::Draw");
+    m_Drawn = 0;
+    if (m_Count == 0 || lightIntensity <= 0.0f) return;
+
+    // The segment written three frames ago must be finished on the GPU before it is overwritten.
+    GLsync& fence = m_Fences[m_Segment];
+    if (fence) {
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, SYNC_TIMEOUT_NS);
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+
+    const GLsizeiptr segmentBytes = static_cast<GLsizeiptr>(sizeof(Instance)) * m_Capacity;
+    const GLintptr offset = segmentBytes * m_Segment;
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, offset, segmentBytes,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!mapped) return;
+    m_Drawn = Cull(static_cast<Instance*>(mapped), lightPos, lightDir, std::min(MAX_LIGHT_RANGE, FogCullDistance(fogDensity)));
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+
+    if (m_Drawn > 0) {
+        // Rows of the view rotation are the camera axes in world space.
+        glm::vec3 cameraRight(view[0][0], view[1][0], view[2][0]);
+        glm::vec3 cameraUp(view[0][1], view[1][1], view[2][1]);
+
+        m_Shader.Use();
+        m_Shader.SetMat4("projection", projection);
+        m_Shader.SetMat4("view", view);
+        m_Shader.SetVec3("cameraRight", cameraRight);
+        m_Shader.SetVec3("cameraUp", cameraUp);
+        m_Shader.SetVec3("viewPos", viewPos);
+        m_Shader.SetVec3("lightPos", lightPos);
+        m_Shader.SetVec3("lightDir", lightDir);
+        m_Shader.SetFloat("cutOff", std::cos(glm::radians(12.5f)));
+        m_Shader.SetFloat("outerCutOff", std::cos(glm::radians(25.0f)));
+        m_Shader.SetFloat("lightIntensity", lightIntensity * BRIGHTNESS);
+        m_Shader.SetFloat("fogDensity", fogDensity);
+
+        glBindVertexArray(VAO);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, position)));
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)(offset + offsetof(Instance, alpha)));
+
+        glBlendFunc(GL_ONE, GL_ONE);
+        glDepthMask(GL_FALSE);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, m_Drawn);
+        glDepthMask(GL_TRUE);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBindVertexArray(0);
+    }
+
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_Segment = (m_Segment + 1) % SEGMENT_COUNT;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Shader.h"
+#include "ParticleEmitter.h"
+
+// Dust motes and door debris. Particles live in structure-of-arrays storage and are integrated
+// four at a time (SSE2 when available); dead ones are swapped out so the live range stays packed.
+// Emitters only spawn near the camera. Each frame the survivors are culled against the flashlight
+// cone (nothing else lights them) and written straight into one persistently reused, triple-
+// segmented streaming buffer, then drawn as additive instanced billboards in a single call.
+class ParticleSystem {
+public:
+    explicit ParticleSystem(int capacity = 100000);
+    ~ParticleSystem();
+
+    // Replaces the emitters (e.g. after a door opens); live particles are kept.
+    void SetEmitters(const std::vector<ParticleEmitter>& emitters);
+
+    void Update(float dt, glm::vec3 viewPos);
+
+    // lightPos/lightDir/lightIntensity describe the flashlight; viewPos is the shaders' viewPos.
+    void Draw(const glm::mat4& projection, const glm::mat4& view, glm::vec3 viewPos,
+              glm::vec3 lightPos, glm::vec3 lightDir, float lightIntensity, float fogDensity);
+
+    int GetAliveCount() const { return m_Count; }
+    int GetDrawnCount() const { return m_Drawn; }
+
+private:
+    struct Instance {
+        glm::vec3 position;
+        float size;
+        float alpha;
+    };
+
+    static constexpr int SEGMENT_COUNT = 3;
+
+    void Emit(const ParticleEmitter& emitter, int count);
+    void Integrate(float dt);
+    void Compact();
+    int Cull(Instance* out, glm::vec3 lightPos, glm::vec3 lightDir, float maxDistance) const;
+    float Random01();
+
+    int m_Capacity;
+    int m_Count;
+    int m_Drawn;
+
+    std::vector<float> m_PosX, m_PosY, m_PosZ;
+    std::vector<float> m_VelX, m_VelY, m_VelZ;
+    std::vector<float> m_Life, m_InvMaxLife;
+    std::vector<float> m_Size, m_Gravity;
+
+    std::vector<ParticleEmitter> m_Emitters;
+    std::vector<float> m_EmitAccumulators;
+    std::uint32_t m_RandomState;
+
+    Shader m_Shader;
+    unsigned int VAO, quadVBO, instanceVBO;
+    GLsync m_Fences[SEGMENT_COUNT];
+    int m_Segment;
+};
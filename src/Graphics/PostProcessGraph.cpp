@@ -0,0 +1,233 @@
+#include "PostProcessGraph.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+    constexpr const char* SCENE_INPUT = "scene";
+    constexpr const char* SCREEN_VERT = "assets/shaders/screen.vert";
+
+    std::string ReadFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "ERROR::POSTPROCESS: Could not read " << path << std::endl;
+            return "";
+        }
+        std::stringstream stream;
+        stream << file.rdbuf();
+        return stream.str();
+    }
+}
+
+RenderTargetPool::~RenderTargetPool() {
+    Clear();
+}
+
+int RenderTargetPool::Acquire(int width, int height) {
+    for (std::size_t i = 0; i < m_Targets.size(); i++) {
+        Target& target = m_Targets[i];
+        if (!target.inUse && target.width == width && target.height == height) {
+            target.inUse = true;
+            return static_cast<int>(i);
+        }
+    }
+
+    // Half-float HDR without alpha keeps every pooled target at 4 bytes per pixel.
+    Target target{0, 0, width, height, true};
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height, 0, GL_RGB, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenFramebuffers(1, &target.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::POSTPROCESS: Pooled target " << width << "x" << height << " is not complete!" << std::endl;
+
+    m_Targets.push_back(target);
+    return static_cast<int>(m_Targets.size()) - 1;
+}
+
+void RenderTargetPool::Release(int index) {
+    m_Targets[index].inUse = false;
+}
+
+void RenderTargetPool::Clear() {
+    for (Target& target : m_Targets) {
+        glDeleteFramebuffers(1, &target.fbo);
+        glDeleteTextures(1, &target.texture);
+    }
+    m_Targets.clear();
+}
+
+PostProcessGraph::PostProcessGraph() : m_Dirty(true) {}
+
+PostProcessGraph::~PostProcessGraph() {
+    for (auto& shader : m_AreaShaders) glDeleteProgram(shader->GetID());
+    if (m_FusedShader) glDeleteProgram(m_FusedShader->GetID());
+}
+
+void PostProcessGraph::AddAreaPass(const AreaPass& pass) {
+    m_AreaPasses.push_back(pass);
+    auto shader = std::make_unique<Shader>();
+    shader->Load(SCREEN_VERT, pass.fragPath.c_str());
+    m_AreaShaders.push_back(std::move(shader));
+    m_Dirty = true;
+}
+
+void PostProcessGraph::AddPixelEffect(const PixelEffect& effect) {
+    m_PixelEffects.push_back(effect);
+    m_Dirty = true;
+}
+
+void PostProcessGraph::SetEffectEnabled(const std::string& name, bool enabled) {
+    for (auto& effect : m_PixelEffects) {
+        if (effect.name == name && effect.enabled != enabled) {
+            effect.enabled = enabled;
+            m_Dirty = true;
+        }
+    }
+}
+
+bool PostProcessGraph::IsEffectEnabled(const std::string& name) const {
+    for (const auto& effect : m_PixelEffects) {
+        if (effect.name == name) return effect.enabled;
+    }
+    return false;
+}
+
+void PostProcessGraph::InvalidateTargets() {
+    m_Pool.Clear();
+}
+
+void PostProcessGraph::Compile() {
+    m_FusedInputs.clear();
+    m_Schedule.clear();
+    m_ReadCounts.clear();
+
+    std::string declarations;
+    std::string functions;
+    std::string calls;
+    std::unordered_set<std::string> needed;
+
+    for (const auto& effect : m_PixelEffects) {
+        if (!effect.enabled) continue;
+
+        for (const auto& input : effect.inputs) {
+            if (input == SCENE_INPUT || !needed.insert(input).second) continue;
+            m_FusedInputs.push_back(input);
+            declarations += "uniform sampler2D " + input + ";\n";
+        }
+        functions += ReadFile(effect.snippetPath) + "\n";
+        calls += "    color = " + effect.function + "(color, uv);\n";
+    }
+
+    // Walk the area passes backwards so only producers of something an enabled effect reads get scheduled.
+    for (int i = static_cast<int>(m_AreaPasses.size()) - 1; i >= 0; i--) {
+        const AreaPass& pass = m_AreaPasses[i];
+        if (!needed.count(pass.output)) continue;
+        m_Schedule.push_back(i);
+        needed.insert(pass.input);
+    }
+    std::reverse(m_Schedule.begin(), m_Schedule.end());
+
+    for (int passIndex : m_Schedule) m_ReadCounts[m_AreaPasses[passIndex].input]++;
+    for (const auto& input : m_FusedInputs) m_ReadCounts[input]++;
+
+    std::string fragment =
+        "#version 330 core\n"
+        "out vec4 FragColor;\n"
+        "in vec2 TexCoords;\n"
+        "uniform sampler2D scene;\n"
+        "uniform float time;\n" +
+        declarations + "\n" + functions +
+        "void main() {\n"
+        "    vec2 uv = TexCoords;\n"
+        "    vec3 color = texture(scene, uv).rgb;\n" +
+        calls +
+        "    FragColor = vec4(color, 1.0);\n"
+        "}\n";
+
+    if (m_FusedShader) glDeleteProgram(m_FusedShader->GetID());
+    m_FusedShader = std::make_unique<Shader>();
+    m_FusedShader->LoadFromSource(ReadFile(SCREEN_VERT), fragment);
+
+    m_Dirty = false;
+}
+
+void PostProcessGraph::ReleaseRead(const std::string& name, std::unordered_map<std::string, int>& reads,
+                                   const std::unordered_map<std::string, int>& outputs) {
+    if (name == SCENE_INPUT) return;
+    if (--reads[name] == 0) m_Pool.Release(outputs.at(name));
+}
+
+void PostProcessGraph::Execute(unsigned int sceneTexture, int renderWidth, int renderHeight,
+                               int outputWidth, int outputHeight, float time, unsigned int quadVAO,
+                               unsigned int outputFramebuffer) {
+    if (m_Dirty) Compile();
+
+    std::unordered_map<std::string, int> outputs;
+    std::unordered_map<std::string, int> reads = m_ReadCounts;
+
+    glBindVertexArray(quadVAO);
+    glActiveTexture(GL_TEXTURE0);
+
+    for (int passIndex : m_Schedule) {
+        const AreaPass& pass = m_AreaPasses[passIndex];
+        Shader& shader = *m_AreaShaders[passIndex];
+
+        unsigned int inputTexture = sceneTexture;
+        int inputWidth = renderWidth, inputHeight = renderHeight;
+        if (pass.input != SCENE_INPUT) {
+            const auto& source = m_Pool.Get(outputs.at(pass.input));
+            inputTexture = source.texture;
+            inputWidth = source.width;
+            inputHeight = source.height;
+        }
+
+        int width = std::max(1, renderWidth / pass.divisor);
+        int height = std::max(1, renderHeight / pass.divisor);
+        int target = m_Pool.Acquire(width, height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_Pool.Get(target).fbo);
+        glViewport(0, 0, width, height);
+
+        shader.Use();
+        shader.SetInt("inputTexture", 0);
+        shader.SetVec2("texelSize", glm::vec2(1.0f / inputWidth, 1.0f / inputHeight));
+        if (pass.configure) pass.configure(shader);
+
+        glBindTexture(GL_TEXTURE_2D, inputTexture);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+
+        outputs[pass.output] = target;
+        ReleaseRead(pass.input, reads, outputs);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+    glViewport(0, 0, outputWidth, outputHeight);
+
+    m_FusedShader->Use();
+    m_FusedShader->SetInt("scene", 0);
+    m_FusedShader->SetFloat("time", time);
+    glBindTexture(GL_TEXTURE_2D, sceneTexture);
+
+    for (std::size_t i = 0; i < m_FusedInputs.size(); i++) {
+        int unit = static_cast<int>(i) + 1;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D, m_Pool.Get(outputs.at(m_FusedInputs[i])).texture);
+        m_FusedShader->SetInt(m_FusedInputs[i], unit);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    for (const auto& input : m_FusedInputs) ReleaseRead(input, reads, outputs);
+    glBindVertexArray(0);
+}
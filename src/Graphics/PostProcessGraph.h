@@ -0,0 +1,88 @@
+#pragma once
+#include <glad/glad.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Shader.h"
+
+// Offscreen colour targets recycled by size. A pass acquires one for its output and the graph
+// hands it back once the last reader has run, so the chain only owns as many as are live at once.
+class RenderTargetPool {
+public:
+    struct Target {
+        unsigned int fbo;
+        unsigned int texture;
+        int width, height;
+        bool inUse;
+    };
+
+    ~RenderTargetPool();
+
+    int Acquire(int width, int height);
+    void Release(int index);
+    const Target& Get(int index) const { return m_Targets[index]; }
+    void Clear();
+
+private:
+    std::vector<Target> m_Targets;
+};
+
+// Neighbourhood pass (downsample, blur) that gets its own draw at 1/divisor of the render resolution.
+// input/output name textures in the graph; "scene" is the resolved frame.
+struct AreaPass {
+    std::string name;
+    std::string input;
+    std::string output;
+    int divisor;
+    std::string fragPath;
+    std::function<void(Shader&)> configure;
+};
+
+// Per-pixel effect: snippetPath defines `vec3 <function>(vec3 color, vec2 uv)` and may sample the
+// textures listed in inputs. All enabled effects are fused, in order, into one full-screen shader.
+struct PixelEffect {
+    std::string name;
+    std::string function;
+    std::string snippetPath;
+    std::vector<std::string> inputs;
+    bool enabled = true;
+};
+
+class PostProcessGraph {
+public:
+    PostProcessGraph();
+    ~PostProcessGraph();
+
+    // Passes must be added after the passes producing their input.
+    void AddAreaPass(const AreaPass& pass);
+    void AddPixelEffect(const PixelEffect& effect);
+    void SetEffectEnabled(const std::string& name, bool enabled);
+    bool IsEffectEnabled(const std::string& name) const;
+
+    // Frees pooled targets; call when the render resolution changes.
+    void InvalidateTargets();
+
+    // Runs the chain on sceneTexture and draws the result into outputFramebuffer.
+    void Execute(unsigned int sceneTexture, int renderWidth, int renderHeight,
+                 int outputWidth, int outputHeight, float time, unsigned int quadVAO,
+                 unsigned int outputFramebuffer = 0);
+
+private:
+    void Compile();
+    void ReleaseRead(const std::string& name, std::unordered_map<std::string, int>& reads,
+                     const std::unordered_map<std::string, int>& outputs);
+
+    std::vector<AreaPass> m_AreaPasses;
+    std::vector<std::unique_ptr<Shader>> m_AreaShaders;
+    std::vector<PixelEffect> m_PixelEffects;
+
+    std::unique_ptr<Shader> m_FusedShader;
+    std::vector<std::string> m_FusedInputs;
+    std::vector<int> m_Schedule;
+    std::unordered_map<std::string, int> m_ReadCounts;
+    bool m_Dirty;
+
+    RenderTargetPool m_Pool;
+};
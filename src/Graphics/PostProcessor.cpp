@@ -1,55 +1,27 @@
 #include "PostProcessor.h"
+#include "../Core/Profiler.h"
+#include <algorithm>
 
 PostProcessor::PostProcessor(int width, int height)
-    : m_Time(0.0f), m_Width(width), m_Height(height)
+    : m_OutputFBO(0), m_Time(0.0f), m_Width(width), m_Height(height),
+      m_RenderScale(1.0f), m_Samples(4), m_RenderWidth(width), m_RenderHeight(height)
 {
-    screenShader.Load("assets/shaders/screen.vert", "assets/shaders/postprocess.frag");
-
-
-
-
-
     glGenFramebuffers(1, &MSFBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
-
-
     glGenRenderbuffers(1, &RBO);
-    glBindRenderbuffer(GL_RENDERBUFFER, RBO);
-
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, RBO);
-
-
     glGenRenderbuffers(1, &DB);
-    glBindRenderbuffer(GL_RENDERBUFFER, DB);
-
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH24_STENCIL8, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, DB);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cerr << "ERROR::POSTPROCESSOR: MSFBO is not complete!" << std::endl;
-
-
-
-
 
     glGenFramebuffers(1, &FBO);
-    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
-
-
     glGenTextures(1, &TCB);
     glBindTexture(GL_TEXTURE_2D, TCB);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, TCB, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-        std::cerr << "ERROR::POSTPROCESSOR: Intermediate FBO is not complete!" << std::endl;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    AllocateStorage();
 
     InitRenderData();
+    BuildDefaultChain();
 }
 
 PostProcessor::~PostProcessor() {
@@ -65,17 +37,46 @@ PostProcessor::~PostProcessor() {
 void PostProcessor::Resize(int width, int height) {
     m_Width = width;
     m_Height = height;
+    AllocateStorage();
+}
+
+void PostProcessor::SetQuality(float renderScale, int samples) {
+    if (renderScale == m_RenderScale && samples == m_Samples) return;
+    m_RenderScale = renderScale;
+    m_Samples = samples;
+    AllocateStorage();
+}
+
+void PostProcessor::AllocateStorage() {
+    m_Graph.InvalidateTargets();
+    m_RenderWidth = std::max(1, static_cast<int>(m_Width * m_RenderScale));
+    m_RenderHeight = std::max(1, static_cast<int>(m_Height * m_RenderScale));
 
 
+    glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
+
     glBindRenderbuffer(GL_RENDERBUFFER, RBO);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_RGB, width, height);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_R11F_G11F_B10F, m_RenderWidth, m_RenderHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, RBO);
 
     glBindRenderbuffer(GL_RENDERBUFFER, DB);
-    glRenderbufferStorageMultisample(GL_RENDERBUFFER, 4, GL_DEPTH24_STENCIL8, width, height);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_Samples, GL_DEPTH24_STENCIL8, m_RenderWidth, m_RenderHeight);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, DB);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::POSTPROCESSOR: MSFBO is not complete!" << std::endl;
 
 
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
     glBindTexture(GL_TEXTURE_2D, TCB);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, m_RenderWidth, m_RenderHeight, 0, GL_RGB, GL_FLOAT, NULL);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, TCB, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::POSTPROCESSOR: Intermediate FBO is not complete!" << std::endl;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void PostProcessor::Update(float dt) {
@@ -85,6 +86,7 @@ void PostProcessor::Update(float dt) {
 void PostProcessor::BeginRender() {
 
     glBindFramebuffer(GL_FRAMEBUFFER, MSFBO);
+    glViewport(0, 0, m_RenderWidth, m_RenderHeight);
     glEnable(GL_DEPTH_TEST);
 
 
@@ -95,32 +97,41 @@ void PostProcessor::BeginRender() {
 }
 
 void PostProcessor::EndRender() {
+    MAZE_PROFILE_SCOPE("PostProcessor::EndRender");
+    MAZE_PROFILE_GPU_SCOPE("PostProcess");
 
 
 
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, MSFBO);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, FBO);
-    glBlitFramebuffer(0, 0, m_Width, m_Height, 0, 0, m_Width, m_Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBlitFramebuffer(0, 0, m_RenderWidth, m_RenderHeight, 0, 0, m_RenderWidth, m_RenderHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
 
 
 
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_OutputFBO);
+    glViewport(0, 0, m_Width, m_Height);
     glDisable(GL_DEPTH_TEST);
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    screenShader.Use();
-    screenShader.SetInt("screenTexture", 0);
-    screenShader.SetFloat("time", m_Time);
-
-    glBindVertexArray(rectVAO);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, TCB);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    m_Graph.Execute(TCB, m_RenderWidth, m_RenderHeight, m_Width, m_Height, m_Time, rectVAO, m_OutputFBO);
+}
 
-    glBindVertexArray(0);
+void PostProcessor::BuildDefaultChain() {
+    // Bloom: bright-pass downsample at half resolution, separable blur at quarter resolution.
+    m_Graph.AddAreaPass({"bloom_bright", "scene", "bloom_half", 2, "assets/shaders/post/bright.frag",
+        [](Shader& shader) { shader.SetFloat("threshold", 1.0f); }});
+    m_Graph.AddAreaPass({"bloom_blur_h", "bloom_half", "bloom_blur", 4, "assets/shaders/post/blur.frag",
+        [](Shader& shader) { shader.SetVec2("direction", glm::vec2(1.0f, 0.0f)); }});
+    m_Graph.AddAreaPass({"bloom_blur_v", "bloom_blur", "bloom", 4, "assets/shaders/post/blur.frag",
+        [](Shader& shader) { shader.SetVec2("direction", glm::vec2(0.0f, 1.0f)); }});
+
+    m_Graph.AddPixelEffect({"bloom", "Bloom", "assets/shaders/post/bloom.glsl", {"bloom"}});
+    m_Graph.AddPixelEffect({"vignette", "Vignette", "assets/shaders/post/vignette.glsl", {}});
+    m_Graph.AddPixelEffect({"chroma_noise", "ChromaNoise", "assets/shaders/post/chroma_noise.glsl", {}});
+    m_Graph.AddPixelEffect({"tonemap", "Tonemap", "assets/shaders/post/tonemap.glsl", {}});
 }
 
 void PostProcessor::InitRenderData() {
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <vector>
 #include "Shader.h"
+#include "PostProcessGraph.h"
 
 class PostProcessor {
 public:
@@ -12,13 +13,27 @@ public:
     void Resize(int width, int height);
     void Update(float dt);
 
+    // Internal resolution as a fraction of the window plus MSAA sample count (0 = no MSAA).
+    // The screen pass upscales the resolved image back to the window with bilinear filtering.
+    void SetQuality(float renderScale, int samples);
+    int GetRenderWidth() const { return m_RenderWidth; }
+    int GetRenderHeight() const { return m_RenderHeight; }
+
     void BeginRender();
     void EndRender();
 
+    // Framebuffer the final pass draws into; 0 is the window, headless runs pass their own target.
+    void SetOutputFramebuffer(unsigned int fbo) { m_OutputFBO = fbo; }
+
+    // Effect chain run by EndRender; effects can be toggled by name at runtime.
+    PostProcessGraph& GetGraph() { return m_Graph; }
+
 private:
     void InitRenderData();
+    void AllocateStorage();
+    void BuildDefaultChain();
 
-    Shader screenShader;
+    PostProcessGraph m_Graph;
 
 
     unsigned int MSFBO;
@@ -30,6 +45,10 @@ private:
     unsigned int TCB;
 
     unsigned int rectVAO, rectVBO;
+    unsigned int m_OutputFBO;
     float m_Time;
     int m_Width, m_Height;
+    float m_RenderScale;
+    int m_Samples;
+    int m_RenderWidth, m_RenderHeight;
 };
\ No newline at end of file
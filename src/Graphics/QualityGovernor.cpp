@@ -0,0 +1,73 @@
+#include "QualityGovernor.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    constexpr float SMOOTHING = 0.1f;
+    constexpr float OVER_BUDGET = 1.1f;
+    constexpr float UNDER_BUDGET = 0.7f;
+    constexpr int SETTLE_FRAMES = 30;
+    constexpr int HEADROOM_FRAMES = 120;
+}
+
+QualityGovernor::QualityGovernor()
+    : m_Level(0), m_SmoothedCpuMs(0.0f), m_SmoothedGpuMs(0.0f), m_Cooldown(0), m_HeadroomFrames(0)
+{
+    // Cheapest-to-lose first: MSAA, then resolution, then how far the fog lets you see.
+    m_Ladder = {
+        {1.0f,  4, 0.09f},
+        {1.0f,  2, 0.09f},
+        {0.85f, 2, 0.09f},
+        {0.85f, 0, 0.09f},
+        {0.75f, 0, 0.10f},
+        {0.66f, 0, 0.11f},
+        {0.5f,  0, 0.12f},
+    };
+}
+
+void QualityGovernor::Update(float cpuMs, float gpuMs, RenderSettings& settings) {
+    if (!settings.adaptiveQuality) return;
+
+    auto smooth = [](float& smoothed, float ms) {
+        smoothed = (smoothed == 0.0f) ? ms : smoothed + (ms - smoothed) * SMOOTHING;
+    };
+    smooth(m_SmoothedCpuMs, cpuMs);
+    smooth(m_SmoothedGpuMs, gpuMs);
+    const float frameMs = GetSmoothedMs();
+
+    if (m_Cooldown > 0) {
+        m_Cooldown--;
+        return;
+    }
+
+    int newLevel = m_Level;
+    if (frameMs > settings.targetFrameMs * OVER_BUDGET) {
+        // A CPU-bound frame would lose quality without getting any faster.
+        if (m_SmoothedGpuMs >= m_SmoothedCpuMs) newLevel = std::min(m_Level + 1, static_cast<int>(m_Ladder.size()) - 1);
+        m_HeadroomFrames = 0;
+    } else if (frameMs < settings.targetFrameMs * UNDER_BUDGET) {
+        if (++m_HeadroomFrames >= HEADROOM_FRAMES) {
+            newLevel = std::max(m_Level - 1, 0);
+            m_HeadroomFrames = 0;
+        }
+    } else {
+        m_HeadroomFrames = 0;
+    }
+
+    if (newLevel != m_Level) {
+        m_Level = newLevel;
+        m_Cooldown = SETTLE_FRAMES;
+        Apply(settings);
+        std::cout << "Quality level " << m_Level << ": scale " << settings.renderScale
+                  << ", MSAA " << settings.msaaSamples << "x, fog " << settings.fogDensity
+                  << " (CPU " << m_SmoothedCpuMs << " ms, GPU " << m_SmoothedGpuMs << " ms / "
+                  << settings.targetFrameMs << " ms)" << std::endl;
+    }
+}
+
+void QualityGovernor::Apply(RenderSettings& settings) const {
+    const QualityLevel& level = m_Ladder[m_Level];
+    settings.renderScale = level.renderScale;
+    settings.msaaSamples = level.msaaSamples;
+    settings.fogDensity = level.fogDensity;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "RenderSettings.h"
+
+// Walks a quality ladder (render scale, MSAA samples, fog distance) to keep the slower of
+// CPU and GPU frame time inside RenderSettings::targetFrameMs. Every rung only makes the GPU's
+// work cheaper, so it steps down only while the GPU is the one over budget.
+class QualityGovernor {
+public:
+    QualityGovernor();
+
+    void Update(float cpuMs, float gpuMs, RenderSettings& settings);
+
+    int GetLevel() const { return m_Level; }
+    float GetSmoothedMs() const { return std::max(m_SmoothedCpuMs, m_SmoothedGpuMs); }
+
+private:
+    struct QualityLevel {
+        float renderScale;
+        int msaaSamples;
+        float fogDensity;
+    };
+
+    std::vector<QualityLevel> m_Ladder;
+    int m_Level;
+    float m_SmoothedCpuMs;
+    float m_SmoothedGpuMs;
+    int m_Cooldown;
+    int m_HeadroomFrames;
+
+    void Apply(RenderSettings& settings) const;
+};
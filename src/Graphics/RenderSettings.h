@@ -0,0 +1,23 @@
+#pragma once
+
+// Runtime-switchable renderer options, toggled from the debug keys in Game.
+struct RenderSettings {
+    bool gpuCulling = false;
+    bool depthPrepass = false;
+    bool frontToBackSort = true;
+    bool particles = true;
+
+    // Frame budget the QualityGovernor tries to hold when adaptiveQuality is on.
+    bool adaptiveQuality = true;
+    float targetFrameMs = 1000.0f / 165.0f;
+
+    // Current quality, written by the QualityGovernor.
+    float renderScale = 1.0f;
+    int msaaSamples = 4;
+    float fogDensity = 0.09f;
+
+    // GPU memory the texture residency manager may fill with mip levels.
+    int textureBudgetMB = 512;
+    // Memory for sound effects decoded from the sound bank on demand.
+    int soundCacheKB = 4096;
+};
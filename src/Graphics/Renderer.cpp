@@ -3,65 +3,34 @@
 
 Renderer::Renderer() {
     InitCubeMesh();
-
-    glGenBuffers(1, &wallInstanceVBO);
-    glGenBuffers(1, &floorInstanceVBO);
 }
 
 Renderer::~Renderer() {
 
     glDeleteVertexArrays(1, &cubeVAO);
     glDeleteBuffers(1, &cubeVBO);
-    glDeleteBuffers(1, &wallInstanceVBO);
-    glDeleteBuffers(1, &floorInstanceVBO);
 }
 
-void Renderer::SetupInstancedWalls(const std::vector<glm::mat4>& transforms) {
-    glBindVertexArray(cubeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, wallInstanceVBO);
-    glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4), &transforms[0], GL_STATIC_DRAW);
+void Renderer::SetPackedInstanceAttributes(std::size_t firstInstance) {
+    std::size_t base = firstInstance * sizeof(PackedInstance);
 
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(PackedInstance), (void*)(base + offsetof(PackedInstance, position)));
+    glVertexAttribDivisor(3, 1);
 
-    std::size_t vec4Size = sizeof(glm::vec4);
-    for (int i = 0; i < 4; i++) {
-        glEnableVertexAttribArray(3 + i);
-        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, 4 * vec4Size, (void*)(i * vec4Size));
-        glVertexAttribDivisor(3 + i, 1);
-    }
-    glBindVertexArray(0);
-}
-
-void Renderer::DrawInstancedWalls(Shader& instancedShader, unsigned int textureID, int count) {
-    instancedShader.Use();
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glBindVertexArray(cubeVAO);
-
-
-    glBindBuffer(GL_ARRAY_BUFFER, wallInstanceVBO);
-    std::size_t vec4Size = sizeof(glm::vec4);
-    for (int i = 0; i < 4; i++) {
-        glEnableVertexAttribArray(3 + i);
-        glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, 4 * vec4Size, (void*)(i * vec4Size));
-        glVertexAttribDivisor(3 + i, 1);
-    }
-
-    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, count);
-    glBindVertexArray(0);
+    glEnableVertexAttribArray(4);
+    glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(PackedInstance), (void*)(base + offsetof(PackedInstance, scaleMaterial)));
+    glVertexAttribDivisor(4, 1);
 }
 
 void Renderer::DrawCube(Shader& shader, const glm::mat4& model, unsigned int textureID) {
     shader.Use();
     shader.SetMat4("model", model);
+    shader.SetMat3("normalMatrix", glm::mat3(glm::transpose(glm::inverse(model))));
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, textureID);
 
     glBindVertexArray(cubeVAO);
-
-
-    for(int i=0; i<4; i++) glDisableVertexAttribArray(3+i);
-
     glDrawArrays(GL_TRIANGLES, 0, 36);
     glBindVertexArray(0);
 }
@@ -113,13 +82,20 @@ void Renderer::InitCubeMesh() {
     };
 
 
-    glGenVertexArrays(1, &cubeVAO);
     glGenBuffers(1, &cubeVBO);
-
-    glBindVertexArray(cubeVAO);
     glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
+    cubeVAO = CreateMeshVAO();
+}
+
+unsigned int Renderer::CreateMeshVAO() {
+    unsigned int vao;
+    glGenVertexArrays(1, &vao);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
+
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
@@ -131,4 +107,5 @@ void Renderer::InitCubeMesh() {
     glEnableVertexAttribArray(2);
 
     glBindVertexArray(0);
+    return vao;
 }
\ No newline at end of file
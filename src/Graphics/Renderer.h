@@ -1,8 +1,9 @@
 #pragma once
 #include <glad/glad.h>
 #include <glm/glm.hpp>
-#include <vector>
+#include <cstddef>
 #include "Shader.h"
+#include "InstanceData.h"
 
 class Renderer {
 public:
@@ -13,20 +14,13 @@ public:
     void DrawCube(Shader& shader, const glm::mat4& model, unsigned int textureID);
 
 
-
-    void SetupInstancedWalls(const std::vector<glm::mat4>& transforms);
-    void SetupInstancedFloors(const std::vector<glm::mat4>& transforms);
-
-
-    void DrawInstancedWalls(Shader& instancedShader, unsigned int textureID, int count);
-    void DrawInstancedFloors(Shader& instancedShader, unsigned int textureID, int count);
+    // New VAO over the shared cube mesh (attributes 0-2); callers add their own instance streams.
+    unsigned int CreateMeshVAO();
+    // Points attributes 3-4 at PackedInstance records in the currently bound GL_ARRAY_BUFFER.
+    static void SetPackedInstanceAttributes(std::size_t firstInstance = 0);
 
 private:
     unsigned int cubeVAO, cubeVBO;
 
-
-    unsigned int wallInstanceVBO;
-    unsigned int floorInstanceVBO;
-
     void InitCubeMesh();
-};
\ No newline at end of file
+};
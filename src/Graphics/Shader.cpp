@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "../Core/Profiler.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -6,7 +7,17 @@
 
 Shader::Shader() : ID(0) {}
 
-void Shader::Load(const char* vertPath, const char* fragPath) {
+namespace {
+    // Inserts extra #define lines right after the #version directive.
+    std::string InjectDefines(const std::string& code, const std::string& defines) {
+        if (defines.empty()) return code;
+        std::size_t lineEnd = code.find('\n');
+        if (lineEnd == std::string::npos) return code + "\n" + defines;
+        return code.substr(0, lineEnd + 1) + defines + code.substr(lineEnd + 1);
+    }
+}
+
+void Shader::Load(const char* vertPath, const char* fragPath, const std::string& defines) {
     std::string vertexCode;
     std::string fragmentCode;
     std::ifstream vShaderFile;
@@ -31,6 +42,11 @@ void Shader::Load(const char* vertPath, const char* fragPath) {
         return;
     }
 
+    LoadFromSource(InjectDefines(vertexCode, defines), InjectDefines(fragmentCode, defines));
+}
+
+void Shader::LoadFromSource(const std::string& vertexCode, const std::string& fragmentCode) {
+    MAZE_PROFILE_SCOPE("Shader::Compile");
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
@@ -59,6 +75,37 @@ void Shader::Load(const char* vertPath, const char* fragPath) {
     glDeleteShader(fragment);
 }
 
+void Shader::LoadCompute(const char* computePath) {
+    std::string computeCode;
+    std::ifstream cShaderFile;
+    cShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+
+    try {
+        cShaderFile.open(computePath);
+        std::stringstream cShaderStream;
+        cShaderStream << cShaderFile.rdbuf();
+        cShaderFile.close();
+        computeCode = cShaderStream.str();
+    } catch (std::ifstream::failure& e) {
+        std::cerr << "CRITICAL ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ: " << e.what() << std::endl;
+        return;
+    }
+
+    const char* cShaderCode = computeCode.c_str();
+
+    unsigned int compute = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute, 1, &cShaderCode, NULL);
+    glCompileShader(compute);
+    CheckCompileErrors(compute, "COMPUTE");
+
+    ID = glCreateProgram();
+    glAttachShader(ID, compute);
+    glLinkProgram(ID);
+    CheckCompileErrors(ID, "PROGRAM");
+
+    glDeleteShader(compute);
+}
+
 void Shader::Use() {
     glUseProgram(ID);
 }
@@ -69,12 +116,24 @@ void Shader::SetBool(const std::string &name, bool value) {
 void Shader::SetInt(const std::string &name, int value) {
     glUniform1i(GetUniformLocation(name), value);
 }
+void Shader::SetUInt(const std::string &name, unsigned int value) {
+    glUniform1ui(GetUniformLocation(name), value);
+}
 void Shader::SetFloat(const std::string &name, float value) {
     glUniform1f(GetUniformLocation(name), value);
 }
+void Shader::SetVec2(const std::string &name, const glm::vec2 &value) {
+    glUniform2fv(GetUniformLocation(name), 1, &value[0]);
+}
 void Shader::SetVec3(const std::string &name, const glm::vec3 &value) {
     glUniform3fv(GetUniformLocation(name), 1, &value[0]);
 }
+void Shader::SetVec4(const std::string &name, const glm::vec4 &value) {
+    glUniform4fv(GetUniformLocation(name), 1, &value[0]);
+}
+void Shader::SetMat3(const std::string &name, const glm::mat3 &mat) {
+    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
+}
 void Shader::SetMat4(const std::string &name, const glm::mat4 &mat) {
     glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
@@ -8,14 +8,21 @@ class Shader {
 public:
     Shader();
 
-    void Load(const char* vertPath, const char* fragPath);
+    // defines are inserted after the #version line of both stages.
+    void Load(const char* vertPath, const char* fragPath, const std::string& defines = "");
+    void LoadFromSource(const std::string& vertexCode, const std::string& fragmentCode);
+    void LoadCompute(const char* computePath);
     void Use();
 
 
     void SetBool(const std::string &name, bool value);
     void SetInt(const std::string &name, int value);
+    void SetUInt(const std::string &name, unsigned int value);
     void SetFloat(const std::string &name, float value);
+    void SetVec2(const std::string &name, const glm::vec2 &value);
     void SetVec3(const std::string &name, const glm::vec3 &value);
+    void SetVec4(const std::string &name, const glm::vec4 &value);
+    void SetMat3(const std::string &name, const glm::mat3 &mat);
     void SetMat4(const std::string &name, const glm::mat4 &mat);
 
     unsigned int GetID() const { return ID; }
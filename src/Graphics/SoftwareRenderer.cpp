@@ -0,0 +1,453 @@
+#include "SoftwareRenderer.h"
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "Frustum.h"
+#include "../Core/JobSystem.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define MAZE_SOFTWARE_SSE2 1
+#endif
+
+namespace {
+    constexpr int TEXTURE_SIZE = 256;
+    constexpr int GAMMA_LUT_SIZE = 4096;
+    constexpr int STRIP_WIDTH = 16;
+
+    constexpr float FLOOR_Y = 0.0f;
+    constexpr float CEILING_Y = 3.5f;
+    constexpr float WALL_BOTTOM = -0.5f;
+    constexpr float DOOR_TOP = 2.0f;
+    // Floor and ceiling rows closer to the horizon than this (in pixels) are treated as this far,
+    // so a row centred on it gets a distant but finite distance.
+    constexpr float MIN_HORIZON_OFFSET = 0.5f;
+
+    // Same values Game::ApplySceneUniforms feeds shader.frag.
+    const glm::vec3 AMBIENT(0.01f, 0.01f, 0.02f);
+    const glm::vec3 DIFFUSE(2.5f, 2.4f, 2.0f);
+    const glm::vec3 SPECULAR(1.0f);
+    const glm::vec3 ATMOSPHERE(0.005f, 0.005f, 0.01f);
+    constexpr float ATT_CONSTANT = 1.0f;
+    constexpr float ATT_LINEAR = 0.045f;
+    constexpr float ATT_QUADRATIC = 0.0075f;
+
+    struct Lighting {
+        glm::vec3 position;
+        glm::vec3 direction;
+        float outerCutOff;
+        float epsilon;
+        float power;
+        glm::vec3 viewPos;
+        float fogDensity;
+    };
+
+    bool IsSolid(int tile) {
+        return tile == 1 || tile == 2 || tile == 5 || tile == 9;
+    }
+
+#ifdef MAZE_SOFTWARE_SSE2
+    // exp(x) for x <= 0: Cephes-style range reduction to 2^n * e^r with |r| <= ln2/2 and a degree-7
+    // polynomial, about 1e-7 relative error, far below what the 12-bit gamma LUT resolves.
+    __m128 Exp4(__m128 x) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_setzero_ps());
+        __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)));
+        __m128 nf = _mm_cvtepi32_ps(n);
+        __m128 r = _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(0.693359375f))),
+                              _mm_mul_ps(nf, _mm_set1_ps(-2.12194440e-4f)));
+
+        __m128 p = _mm_set1_ps(1.9875691500e-4f);
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.3981999507e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+        __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), one);
+
+        __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+        return _mm_mul_ps(e, scale);
+    }
+#endif
+
+    // Four wrapped nearest-texel lookups, one texture per lane. Sizes are powers of two, so the
+    // wrap is a mask; SSE2 has no gather, so only the loads stay scalar.
+    void Gather4(const std::uint32_t* const* textures, const float* sizes, const float* u, const float* v,
+                 std::uint32_t* texels)
+    {
+#ifdef MAZE_SOFTWARE_SSE2
+        __m128 size = _mm_loadu_ps(sizes);
+        __m128i mask = _mm_sub_epi32(_mm_cvttps_epi32(size), _mm_set1_epi32(1));
+        __m128i ix = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(u), size)), mask);
+        __m128i iy = _mm_and_si128(_mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(v), size)), mask);
+        __m128i index = _mm_add_epi32(_mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(iy), size)), ix);
+
+        alignas(16) std::int32_t offsets[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(offsets), index);
+        for (int i = 0; i < 4; i++) texels[i] = textures[i][offsets[i]];
+#else
+        for (int i = 0; i < 4; i++) {
+            int size = static_cast<int>(sizes[i]);
+            int ix = static_cast<int>(u[i] * size) & (size - 1);
+            int iy = static_cast<int>(v[i] * size) & (size - 1);
+            texels[i] = textures[i][iy * size + ix];
+        }
+#endif
+    }
+
+    // Four pixels of flashlight + fog shading. Inputs are world positions, one shared normal and
+    // packed RGBA albedo texels; outputs are linear colours.
+    void Shade4(const Lighting& light, const float* px, const float* py, const float* pz, glm::vec3 n,
+                const std::uint32_t* texels, float* outR, float* outG, float* outB)
+    {
+#ifdef MAZE_SOFTWARE_SSE2
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texels));
+        __m128i byteMask = _mm_set1_epi32(0xFF);
+        __m128 inv255 = _mm_set1_ps(1.0f / 255.0f);
+        __m128 albedoR = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(packed, byteMask)), inv255);
+        __m128 albedoG = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 8), byteMask)), inv255);
+        __m128 albedoB = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 16), byteMask)), inv255);
+
+        __m128 x = _mm_loadu_ps(px);
+        __m128 y = _mm_loadu_ps(py);
+        __m128 z = _mm_loadu_ps(pz);
+
+        __m128 lx = _mm_sub_ps(_mm_set1_ps(light.position.x), x);
+        __m128 ly = _mm_sub_ps(_mm_set1_ps(light.position.y), y);
+        __m128 lz = _mm_sub_ps(_mm_set1_ps(light.position.z), z);
+        __m128 dist2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, lx), _mm_mul_ps(ly, ly)), _mm_mul_ps(lz, lz));
+        __m128 dist = _mm_sqrt_ps(dist2);
+        __m128 invDist = _mm_div_ps(one, _mm_max_ps(dist, _mm_set1_ps(1e-5f)));
+        lx = _mm_mul_ps(lx, invDist);
+        ly = _mm_mul_ps(ly, invDist);
+        lz = _mm_mul_ps(lz, invDist);
+
+        __m128 theta = _mm_sub_ps(zero, _mm_add_ps(_mm_add_ps(
+            _mm_mul_ps(lx, _mm_set1_ps(light.direction.x)),
+            _mm_mul_ps(ly, _mm_set1_ps(light.direction.y))),
+            _mm_mul_ps(lz, _mm_set1_ps(light.direction.z))));
+        __m128 intensity = _mm_div_ps(_mm_sub_ps(theta, _mm_set1_ps(light.outerCutOff)), _mm_set1_ps(light.epsilon));
+        intensity = _mm_min_ps(_mm_max_ps(intensity, zero), one);
+
+        __m128 attenuation = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(_mm_set1_ps(ATT_CONSTANT),
+            _mm_mul_ps(_mm_set1_ps(ATT_LINEAR), dist)), _mm_mul_ps(_mm_set1_ps(ATT_QUADRATIC), dist2)));
+
+        __m128 ndl = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(n.x)), _mm_mul_ps(ly, _mm_set1_ps(n.y))),
+                                _mm_mul_ps(lz, _mm_set1_ps(n.z)));
+        __m128 diff = _mm_max_ps(ndl, zero);
+
+        __m128 vx = _mm_sub_ps(_mm_set1_ps(light.viewPos.x), x);
+        __m128 vy = _mm_sub_ps(_mm_set1_ps(light.viewPos.y), y);
+        __m128 vz = _mm_sub_ps(_mm_set1_ps(light.viewPos.z), z);
+        __m128 viewDist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        __m128 invView = _mm_div_ps(one, _mm_max_ps(viewDist, _mm_set1_ps(1e-5f)));
+
+        // reflect(-L, n) = 2 (n.L) n - L
+        __m128 twoNdl = _mm_add_ps(ndl, ndl);
+        __m128 rx = _mm_sub_ps(_mm_mul_ps(twoNdl, _mm_set1_ps(n.x)), lx);
+        __m128 ry = _mm_sub_ps(_mm_mul_ps(twoNdl, _mm_set1_ps(n.y)), ly);
+        __m128 rz = _mm_sub_ps(_mm_mul_ps(twoNdl, _mm_set1_ps(n.z)), lz);
+        __m128 spec = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, rx), _mm_mul_ps(vy, ry)), _mm_mul_ps(vz, rz)), invView);
+        spec = _mm_max_ps(spec, zero);
+        for (int i = 0; i < 5; i++) spec = _mm_mul_ps(spec, spec);
+
+        __m128 scale = _mm_mul_ps(_mm_mul_ps(intensity, attenuation), _mm_set1_ps(light.power));
+
+        __m128 fogDist = _mm_mul_ps(viewDist, _mm_set1_ps(light.fogDensity));
+        __m128 fog = Exp4(_mm_sub_ps(zero, _mm_mul_ps(fogDist, fogDist)));
+
+        auto channel = [&](__m128 albedo, float ambient, float diffuse, float specular, float atmosphere) {
+            __m128 lit = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(diff, _mm_set1_ps(diffuse)), _mm_mul_ps(spec, _mm_set1_ps(specular))), scale);
+            __m128 result = _mm_mul_ps(albedo, _mm_add_ps(_mm_set1_ps(ambient), lit));
+            __m128 atm = _mm_set1_ps(atmosphere);
+            return _mm_add_ps(atm, _mm_mul_ps(_mm_sub_ps(result, atm), fog));
+        };
+        _mm_storeu_ps(outR, channel(albedoR, AMBIENT.r, DIFFUSE.r, SPECULAR.r, ATMOSPHERE.r));
+        _mm_storeu_ps(outG, channel(albedoG, AMBIENT.g, DIFFUSE.g, SPECULAR.g, ATMOSPHERE.g));
+        _mm_storeu_ps(outB, channel(albedoB, AMBIENT.b, DIFFUSE.b, SPECULAR.b, ATMOSPHERE.b));
+#else
+        for (int i = 0; i < 4; i++) {
+            glm::vec3 albedo(texels[i] & 0xFFu, (texels[i] >> 8) & 0xFFu, (texels[i] >> 16) & 0xFFu);
+            albedo /= 255.0f;
+            glm::vec3 p(px[i], py[i], pz[i]);
+
+            glm::vec3 toLight = light.position - p;
+            float dist = glm::length(toLight);
+            glm::vec3 lightDir = toLight / std::max(dist, 1e-5f);
+
+            float theta = glm::dot(lightDir, -light.direction);
+            float intensity = glm::clamp((theta - light.outerCutOff) / light.epsilon, 0.0f, 1.0f);
+            float attenuation = 1.0f / (ATT_CONSTANT + ATT_LINEAR * dist + ATT_QUADRATIC * dist * dist);
+
+            float diff = std::max(glm::dot(n, lightDir), 0.0f);
+            glm::vec3 toView = light.viewPos - p;
+            float viewDist = glm::length(toView);
+            glm::vec3 viewDir = toView / std::max(viewDist, 1e-5f);
+            float spec = std::pow(std::max(glm::dot(viewDir, glm::reflect(-lightDir, n)), 0.0f), 32.0f);
+
+            glm::vec3 result = albedo * (AMBIENT + (DIFFUSE * diff + SPECULAR * spec) * intensity * attenuation * light.power);
+            float fogDist = viewDist * light.fogDensity;
+            float fog = std::exp(-fogDist * fogDist);
+            glm::vec3 color = ATMOSPHERE + (result - ATMOSPHERE) * fog;
+            outR[i] = color.r;
+            outG[i] = color.g;
+            outB[i] = color.b;
+        }
+#endif
+    }
+}
+
+struct SoftwareRenderer::Frame {
+    const Map* map;
+    SoftwareCamera camera;
+    Lighting lighting;
+    glm::vec2 forward;
+    glm::vec2 right;
+    float focal;
+    float horizon;
+    float maxDistance;
+};
+
+SoftwareCamera SoftwareCamera::FromPlayer(const Player& player, float fogDensity) {
+    SoftwareCamera camera;
+    camera.eyePosition = player.GetEyePosition();
+    camera.viewPosition = player.GetPosition();
+    camera.front = player.GetFront();
+    camera.flashlightPosition = player.GetFlashlightPosition();
+    camera.fovDegrees = player.GetCurrentFOV();
+    camera.flashIntensity = (player.IsFlashlightOn() && player.GetBattery() > 0.0f) ? 1.0f : 0.0f;
+    camera.fogDensity = fogDensity;
+    return camera;
+}
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+    : m_Width(width), m_Height(height), m_Pixels(static_cast<std::size_t>(width) * height * 4, 255)
+{
+    // shader output goes through postprocess gamma 2.2; done here with a lookup table.
+    m_GammaLut.resize(GAMMA_LUT_SIZE);
+    for (int i = 0; i < GAMMA_LUT_SIZE; i++) {
+        float linear = static_cast<float>(i) / (GAMMA_LUT_SIZE - 1);
+        m_GammaLut[i] = static_cast<std::uint8_t>(std::lround(std::pow(linear, 1.0f / 2.2f) * 255.0f));
+    }
+}
+
+bool SoftwareRenderer::LoadTextures() {
+    bool ok = LoadTexture("assets/textures/wall/PaintedPlaster.png", m_WallTex);
+    ok &= LoadTexture("assets/textures/floor/fabricfloor.png", m_FloorTex);
+    ok &= LoadTexture("assets/textures/Ceiling/OfficeCeiling006_4K-PNG_Color.png", m_CeilingTex);
+    ok &= LoadTexture("assets/textures/door/Door001_8K-PNG_Color.png", m_DoorTex);
+    ok &= LoadTexture("assets/textures/door/DoorLocked.png", m_LockedDoorTex);
+    return ok;
+}
+
+// Box-filters the image down (or point-samples it up) to TEXTURE_SIZE^2 so lookups can wrap with a mask.
+bool SoftwareRenderer::LoadTexture(const std::string& path, Texture& out) {
+    sf::Image image;
+    if (!image.loadFromFile(path)) {
+        std::cerr << "ERROR: Failed to load texture: " << path << std::endl;
+        return false;
+    }
+
+    const unsigned int srcWidth = image.getSize().x;
+    const unsigned int srcHeight = image.getSize().y;
+    const std::uint8_t* src = image.getPixelsPtr();
+    if (srcWidth == 0 || srcHeight == 0) {
+        std::cerr << "ERROR: Empty texture: " << path << std::endl;
+        return false;
+    }
+
+    out.size = TEXTURE_SIZE;
+    out.texels.assign(TEXTURE_SIZE * TEXTURE_SIZE, 0);
+
+    for (int y = 0; y < TEXTURE_SIZE; y++) {
+        unsigned int y0 = y * srcHeight / TEXTURE_SIZE;
+        unsigned int y1 = std::max(y0 + 1, (y + 1) * srcHeight / TEXTURE_SIZE);
+        for (int x = 0; x < TEXTURE_SIZE; x++) {
+            unsigned int x0 = x * srcWidth / TEXTURE_SIZE;
+            unsigned int x1 = std::max(x0 + 1, (x + 1) * srcWidth / TEXTURE_SIZE);
+
+            std::uint64_t sum[3] = {0, 0, 0};
+            for (unsigned int sy = y0; sy < y1; sy++) {
+                const std::uint8_t* row = src + (static_cast<std::size_t>(sy) * srcWidth + x0) * 4;
+                for (unsigned int sx = x0; sx < x1; sx++, row += 4) {
+                    sum[0] += row[0];
+                    sum[1] += row[1];
+                    sum[2] += row[2];
+                }
+            }
+            std::uint64_t count = static_cast<std::uint64_t>(y1 - y0) * (x1 - x0);
+            out.texels[y * TEXTURE_SIZE + x] = static_cast<std::uint32_t>(sum[0] / count)
+                                             | static_cast<std::uint32_t>(sum[1] / count) << 8
+                                             | static_cast<std::uint32_t>(sum[2] / count) << 16
+                                             | 0xFF000000u;
+        }
+    }
+    return true;
+}
+
+void SoftwareRenderer::Render(const Map& map, const SoftwareCamera& camera) {
+    Frame frame;
+    frame.map = &map;
+    frame.camera = camera;
+
+    frame.lighting.position = camera.flashlightPosition;
+    frame.lighting.direction = camera.front;
+    float cutOff = std::cos(glm::radians(12.5f));
+    frame.lighting.outerCutOff = std::cos(glm::radians(25.0f));
+    frame.lighting.epsilon = cutOff - frame.lighting.outerCutOff;
+    frame.lighting.power = glm::clamp(camera.flashIntensity, 0.0f, 1.0f);
+    frame.lighting.viewPos = camera.viewPosition;
+    frame.lighting.fogDensity = camera.fogDensity;
+
+    // Yaw comes from the flattened view direction, pitch becomes a vertical shear of the horizon.
+    glm::vec2 flat(camera.front.x, camera.front.z);
+    frame.forward = glm::length(flat) > 1e-4f ? glm::normalize(flat) : glm::vec2(0.0f, -1.0f);
+    frame.right = glm::vec2(-frame.forward.y, frame.forward.x);
+    frame.focal = (m_Height * 0.5f) / std::tan(glm::radians(camera.fovDegrees) * 0.5f);
+    float pitch = std::asin(glm::clamp(camera.front.y, -1.0f, 1.0f));
+    frame.horizon = m_Height * 0.5f + frame.focal * std::tan(pitch);
+    frame.maxDistance = FogCullDistance(camera.fogDensity);
+
+    JobSystem::Shared().ParallelFor(0, m_Width, STRIP_WIDTH, [&](int first, int last) {
+        RenderColumns(frame, first, last);
+    });
+}
+
+void SoftwareRenderer::RenderColumns(const Frame& frame, int firstColumn, int lastColumn) {
+    const Map& map = *frame.map;
+    const glm::vec3 eye = frame.camera.eyePosition;
+
+    alignas(16) float px[4], py[4], pz[4];
+    alignas(16) float texU[4], texV[4], texSize[4];
+    const std::uint32_t* textures[4];
+    alignas(16) std::uint32_t texels[4];
+    alignas(16) float outR[4], outG[4], outB[4];
+    int rows[4];
+    int count = 0;
+    int column = firstColumn;
+
+    auto flush = [&](glm::vec3 normal) {
+        if (count == 0) return;
+        for (int i = count; i < 4; i++) {
+            px[i] = px[0]; py[i] = py[0]; pz[i] = pz[0];
+            texU[i] = texU[0]; texV[i] = texV[0]; texSize[i] = texSize[0]; textures[i] = textures[0];
+        }
+        Gather4(textures, texSize, texU, texV, texels);
+        Shade4(frame.lighting, px, py, pz, normal, texels, outR, outG, outB);
+
+        const float lutScale = static_cast<float>(GAMMA_LUT_SIZE - 1);
+        for (int i = 0; i < count; i++) {
+            std::uint8_t* pixel = &m_Pixels[(static_cast<std::size_t>(rows[i]) * m_Width + column) * 4];
+            pixel[0] = m_GammaLut[static_cast<int>(glm::clamp(outR[i], 0.0f, 1.0f) * lutScale)];
+            pixel[1] = m_GammaLut[static_cast<int>(glm::clamp(outG[i], 0.0f, 1.0f) * lutScale)];
+            pixel[2] = m_GammaLut[static_cast<int>(glm::clamp(outB[i], 0.0f, 1.0f) * lutScale)];
+            pixel[3] = 255;
+        }
+        count = 0;
+    };
+
+    auto push = [&](int row, glm::vec3 position, const Texture& texture, float u, float v, glm::vec3 normal) {
+        px[count] = position.x;
+        py[count] = position.y;
+        pz[count] = position.z;
+        texU[count] = u;
+        texV[count] = v;
+        texSize[count] = static_cast<float>(texture.size);
+        textures[count] = texture.texels.data();
+        rows[count] = row;
+        if (++count == 4) flush(normal);
+    };
+
+    for (column = firstColumn; column < lastColumn; column++) {
+        float cameraX = (column + 0.5f - m_Width * 0.5f) / frame.focal;
+        glm::vec2 dir = frame.forward + frame.right * cameraX;
+
+        // DDA through the tile grid; dir has unit length along forward, so t is the perpendicular distance.
+        int mapX = static_cast<int>(std::floor(eye.x));
+        int mapZ = static_cast<int>(std::floor(eye.z));
+        float deltaX = (dir.x == 0.0f) ? 1e30f : std::abs(1.0f / dir.x);
+        float deltaZ = (dir.y == 0.0f) ? 1e30f : std::abs(1.0f / dir.y);
+        int stepX = dir.x < 0.0f ? -1 : 1;
+        int stepZ = dir.y < 0.0f ? -1 : 1;
+        float sideX = (dir.x < 0.0f ? eye.x - mapX : mapX + 1.0f - eye.x) * deltaX;
+        float sideZ = (dir.y < 0.0f ? eye.z - mapZ : mapZ + 1.0f - eye.z) * deltaZ;
+
+        bool hit = false;
+        bool xSide = false;
+        int tile = 0;
+        float perp = frame.maxDistance;
+        while (true) {
+            float t;
+            if (sideX < sideZ) { t = sideX; sideX += deltaX; mapX += stepX; xSide = true; }
+            else               { t = sideZ; sideZ += deltaZ; mapZ += stepZ; xSide = false; }
+            if (t > frame.maxDistance) break;
+
+            tile = map.GetTile(mapX, mapZ);
+            if (IsSolid(tile)) {
+                hit = true;
+                perp = std::max(t, 1e-3f);
+                break;
+            }
+        }
+
+        float wallTop = frame.horizon;
+        float wallBottom = frame.horizon;
+        glm::vec3 wallNormal(0.0f);
+        glm::vec2 hitPoint(0.0f);
+        float wallU = 0.0f;
+        if (hit) {
+            wallTop = frame.horizon - (CEILING_Y - eye.y) * frame.focal / perp;
+            wallBottom = frame.horizon + (eye.y - FLOOR_Y) * frame.focal / perp;
+            hitPoint = glm::vec2(eye.x, eye.z) + dir * perp;
+            if (xSide) {
+                wallNormal = glm::vec3(static_cast<float>(-stepX), 0.0f, 0.0f);
+                wallU = hitPoint.y - std::floor(hitPoint.y);
+            } else {
+                wallNormal = glm::vec3(0.0f, 0.0f, static_cast<float>(-stepZ));
+                wallU = hitPoint.x - std::floor(hitPoint.x);
+            }
+        }
+        int yTop = std::clamp(static_cast<int>(std::ceil(wallTop - 0.5f)), 0, m_Height);
+        int yBottom = std::clamp(static_cast<int>(std::ceil(wallBottom - 0.5f)), 0, m_Height);
+
+        const glm::vec3 down(0.0f, -1.0f, 0.0f);
+        for (int y = 0; y < yTop; y++) {
+            float rowDistance = (CEILING_Y - eye.y) * frame.focal / std::max(frame.horizon - (y + 0.5f), MIN_HORIZON_OFFSET);
+            glm::vec2 p = glm::vec2(eye.x, eye.z) + dir * rowDistance;
+            push(y, glm::vec3(p.x, CEILING_Y, p.y), m_CeilingTex, p.x - std::floor(p.x), p.y - std::floor(p.y), down);
+        }
+        flush(down);
+
+        bool isDoor = (tile == 2 || tile == 5);
+        const Texture& doorTex = (tile == 2) ? m_DoorTex : m_LockedDoorTex;
+        for (int y = yTop; y < yBottom; y++) {
+            float worldY = eye.y + (frame.horizon - (y + 0.5f)) * perp / frame.focal;
+            glm::vec3 position(hitPoint.x, worldY, hitPoint.y);
+            if (isDoor && worldY < DOOR_TOP) push(y, position, doorTex, wallU, (DOOR_TOP - worldY) / (DOOR_TOP - WALL_BOTTOM), wallNormal);
+            else if (isDoor) push(y, position, m_WallTex, wallU, (CEILING_Y - worldY) / (CEILING_Y - DOOR_TOP), wallNormal);
+            else push(y, position, m_WallTex, wallU, (CEILING_Y - worldY) / (CEILING_Y - WALL_BOTTOM), wallNormal);
+        }
+        flush(wallNormal);
+
+        const glm::vec3 up(0.0f, 1.0f, 0.0f);
+        for (int y = yBottom; y < m_Height; y++) {
+            float rowDistance = (eye.y - FLOOR_Y) * frame.focal / std::max((y + 0.5f) - frame.horizon, MIN_HORIZON_OFFSET);
+            glm::vec2 p = glm::vec2(eye.x, eye.z) + dir * rowDistance;
+            push(y, glm::vec3(p.x, FLOOR_Y, p.y), m_FloorTex, p.x - std::floor(p.x), p.y - std::floor(p.y), up);
+        }
+        flush(up);
+    }
+}
+
+bool SoftwareRenderer::SavePng(const std::string& path) const {
+    sf::Image image(sf::Vector2u(static_cast<unsigned int>(m_Width), static_cast<unsigned int>(m_Height)), m_Pixels.data());
+    if (!image.saveToFile(path)) {
+        std::cerr << "ERROR: Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
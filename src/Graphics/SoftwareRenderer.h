@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../Entities/Map.h"
+#include "../Entities/Player.h"
+
+// Camera and lighting inputs; viewPosition is the player's feet, matching viewPos in shader.frag.
+struct SoftwareCamera {
+    glm::vec3 eyePosition;
+    glm::vec3 viewPosition;
+    glm::vec3 front;
+    glm::vec3 flashlightPosition;
+    float fovDegrees;
+    float flashIntensity;
+    float fogDensity;
+
+    static SoftwareCamera FromPlayer(const Player& player, float fogDensity);
+};
+
+// CPU fallback for machines without GL: DDA column raycasting for walls and doors, per-column
+// floor/ceiling casting, the flashlight + fog model of shader.frag evaluated four pixels at a time
+// (SSE2 when available), split into column strips across all cores.
+// Pickups and dynamic lights are not drawn.
+class SoftwareRenderer {
+public:
+    SoftwareRenderer(int width, int height);
+
+    // Loads the same texture assets as Game, resampled to power-of-two squares.
+    bool LoadTextures();
+
+    void Render(const Map& map, const SoftwareCamera& camera);
+
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    // RGBA8, top row first.
+    const std::vector<std::uint8_t>& GetPixels() const { return m_Pixels; }
+    bool SavePng(const std::string& path) const;
+
+private:
+    struct Texture {
+        int size = 1;
+        std::vector<std::uint32_t> texels{0xFFFFFFFFu};
+    };
+
+    struct Frame;
+
+    static bool LoadTexture(const std::string& path, Texture& out);
+    void RenderColumns(const Frame& frame, int firstColumn, int lastColumn);
+
+    int m_Width, m_Height;
+    std::vector<std::uint8_t> m_Pixels;
+    std::vector<std::uint8_t> m_GammaLut;
+
+    Texture m_WallTex, m_FloorTex, m_CeilingTex, m_DoorTex, m_LockedDoorTex;
+};
@@ -0,0 +1,275 @@
+#include "TextureCache.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr std::uint32_t CACHE_MAGIC = 0x5845544D; // "MTEX"
+    constexpr std::uint32_t CACHE_VERSION = 1;
+    constexpr std::size_t DATA_ALIGNMENT = 16;
+
+    struct CacheHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t format;
+        std::uint32_t levelCount;
+    };
+
+    struct CacheLevel {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    std::size_t EncodedSize(int width, int height, TextureFormat format) {
+        std::size_t blocks = static_cast<std::size_t>((width + 3) / 4) * ((height + 3) / 4);
+        switch (format) {
+            case TextureFormat::BC1: return blocks * 8;
+            case TextureFormat::BC3: return blocks * 16;
+            default: return static_cast<std::size_t>(width) * height * 4;
+        }
+    }
+
+    std::uint16_t To565(const int color[3]) {
+        return static_cast<std::uint16_t>(((color[0] * 31 + 127) / 255) << 11 |
+                                          ((color[1] * 63 + 127) / 255) << 5 |
+                                          ((color[2] * 31 + 127) / 255));
+    }
+
+    void From565(std::uint16_t packed, int color[3]) {
+        int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    void PutLE(std::uint8_t* out, std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+
+    // Endpoints from the block's bounding box, flipped onto the diagonal that follows the colour
+    // correlation and inset by 1/16 of the range, then each pixel takes the nearest palette entry.
+    void EncodeColorBlock(const std::uint8_t block[16][4], std::uint8_t out[8]) {
+        int lo[3] = {255, 255, 255}, hi[3] = {0, 0, 0};
+        int mean[3] = {0, 0, 0};
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) {
+                lo[c] = std::min(lo[c], static_cast<int>(block[i][c]));
+                hi[c] = std::max(hi[c], static_cast<int>(block[i][c]));
+                mean[c] += block[i][c];
+            }
+        }
+        for (int c = 0; c < 3; c++) mean[c] = (mean[c] + 8) / 16;
+
+        int covRG = 0, covBG = 0;
+        for (int i = 0; i < 16; i++) {
+            int g = block[i][1] - mean[1];
+            covRG += (block[i][0] - mean[0]) * g;
+            covBG += (block[i][2] - mean[2]) * g;
+        }
+        if (covRG < 0) std::swap(lo[0], hi[0]);
+        if (covBG < 0) std::swap(lo[2], hi[2]);
+
+        for (int c = 0; c < 3; c++) {
+            int inset = (hi[c] - lo[c]) / 16;
+            hi[c] -= inset;
+            lo[c] += inset;
+        }
+
+        std::uint16_t c0 = To565(hi), c1 = To565(lo);
+        if (c0 < c1) std::swap(c0, c1);      // c0 > c1 selects the four-colour mode
+
+        std::uint32_t indices = 0;
+        if (c0 != c1) {
+            int palette[4][3];
+            From565(c0, palette[0]);
+            From565(c1, palette[1]);
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (int i = 0; i < 16; i++) {
+                int best = 0, bestError = 1 << 30;
+                for (int p = 0; p < 4; p++) {
+                    int dr = block[i][0] - palette[p][0], dg = block[i][1] - palette[p][1], db = block[i][2] - palette[p][2];
+                    int error = dr * dr + dg * dg + db * db;
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                indices |= static_cast<std::uint32_t>(best) << (2 * i);
+            }
+        }
+        PutLE(out, c0, 2);
+        PutLE(out + 2, c1, 2);
+        PutLE(out + 4, indices, 4);
+    }
+
+    // Eight-value alpha ramp between the block's extremes.
+    void EncodeAlphaBlock(const std::uint8_t block[16][4], std::uint8_t out[8]) {
+        int a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; i++) {
+            a0 = std::max(a0, static_cast<int>(block[i][3]));
+            a1 = std::min(a1, static_cast<int>(block[i][3]));
+        }
+
+        std::uint64_t indices = 0;
+        if (a0 != a1) {
+            int ramp[8] = {a0, a1};
+            for (int i = 2; i < 8; i++) ramp[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            for (int i = 0; i < 16; i++) {
+                int best = 0, bestError = 1 << 30;
+                for (int p = 0; p < 8; p++) {
+                    int error = std::abs(block[i][3] - ramp[p]);
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                indices |= static_cast<std::uint64_t>(best) << (3 * i);
+            }
+        }
+        out[0] = static_cast<std::uint8_t>(a0);
+        out[1] = static_cast<std::uint8_t>(a1);
+        PutLE(out + 2, indices, 6);
+    }
+}
+
+std::vector<TextureImage> TextureCache::BuildMipChain(TextureImage base) {
+    std::vector<TextureImage> levels;
+    levels.push_back(std::move(base));
+
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        const TextureImage& src = levels.back();
+        TextureImage dst;
+        dst.width = std::max(1, src.width / 2);
+        dst.height = std::max(1, src.height / 2);
+        dst.pixels.resize(static_cast<std::size_t>(dst.width) * dst.height * 4);
+
+        for (int y = 0; y < dst.height; y++) {
+            int y0 = std::min(y * 2, src.height - 1);
+            int y1 = std::min(y * 2 + 1, src.height - 1);
+            for (int x = 0; x < dst.width; x++) {
+                int x0 = std::min(x * 2, src.width - 1);
+                int x1 = std::min(x * 2 + 1, src.width - 1);
+                const std::uint8_t* a = &src.pixels[(static_cast<std::size_t>(y0) * src.width + x0) * 4];
+                const std::uint8_t* b = &src.pixels[(static_cast<std::size_t>(y0) * src.width + x1) * 4];
+                const std::uint8_t* c = &src.pixels[(static_cast<std::size_t>(y1) * src.width + x0) * 4];
+                const std::uint8_t* d = &src.pixels[(static_cast<std::size_t>(y1) * src.width + x1) * 4];
+                std::uint8_t* out = &dst.pixels[(static_cast<std::size_t>(y) * dst.width + x) * 4];
+                for (int ch = 0; ch < 4; ch++) {
+                    out[ch] = static_cast<std::uint8_t>((a[ch] + b[ch] + c[ch] + d[ch] + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(std::move(dst));
+    }
+    return levels;
+}
+
+bool TextureCache::HasAlpha(const TextureImage& image) {
+    for (std::size_t i = 3; i < image.pixels.size(); i += 4) {
+        if (image.pixels[i] != 255) return true;
+    }
+    return false;
+}
+
+std::vector<std::uint8_t> TextureCache::Encode(const TextureImage& image, TextureFormat format) {
+    if (format == TextureFormat::RGBA8) return image.pixels;
+
+    std::vector<std::uint8_t> out(EncodedSize(image.width, image.height, format));
+    std::uint8_t* cursor = out.data();
+    std::uint8_t block[16][4];
+
+    for (int by = 0; by < image.height; by += 4) {
+        for (int bx = 0; bx < image.width; bx += 4) {
+            // Partial edge blocks repeat their last row/column.
+            for (int y = 0; y < 4; y++) {
+                int sy = std::min(by + y, image.height - 1);
+                for (int x = 0; x < 4; x++) {
+                    int sx = std::min(bx + x, image.width - 1);
+                    std::memcpy(block[y * 4 + x], &image.pixels[(static_cast<std::size_t>(sy) * image.width + sx) * 4], 4);
+                }
+            }
+            if (format == TextureFormat::BC3) {
+                EncodeAlphaBlock(block, cursor);
+                cursor += 8;
+            }
+            EncodeColorBlock(block, cursor);
+            cursor += 8;
+        }
+    }
+    return out;
+}
+
+bool TextureCache::Write(const std::string& path, const std::vector<TextureImage>& levels, TextureFormat format, int maxSize) {
+    std::size_t first = 0;
+    while (maxSize > 0 && first + 1 < levels.size() &&
+           (levels[first].width > maxSize || levels[first].height > maxSize)) {
+        first++;
+    }
+
+    std::vector<std::vector<std::uint8_t>> encoded;
+    for (std::size_t i = first; i < levels.size(); i++) encoded.push_back(Encode(levels[i], format));
+
+    CacheHeader header = {CACHE_MAGIC, CACHE_VERSION, static_cast<std::uint32_t>(format), static_cast<std::uint32_t>(encoded.size())};
+    std::vector<CacheLevel> table(encoded.size());
+    std::uint64_t offset = sizeof(CacheHeader) + sizeof(CacheLevel) * table.size();
+    for (std::size_t i = 0; i < encoded.size(); i++) {
+        offset = (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+        table[i] = {static_cast<std::uint32_t>(levels[first + i].width), static_cast<std::uint32_t>(levels[first + i].height),
+                    offset, encoded[i].size()};
+        offset += encoded[i].size();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "ERROR: Could not write texture cache: " << path << std::endl;
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(sizeof(CacheLevel) * table.size()));
+    for (std::size_t i = 0; i < encoded.size(); i++) {
+        std::uint64_t position = static_cast<std::uint64_t>(file.tellp());
+        const char padding[DATA_ALIGNMENT] = {};
+        file.write(padding, static_cast<std::streamsize>(table[i].offset - position));
+        file.write(reinterpret_cast<const char*>(encoded[i].data()), static_cast<std::streamsize>(encoded[i].size()));
+    }
+    return static_cast<bool>(file);
+}
+
+bool TextureCache::Open(const std::string& path, const std::string& sourcePath) {
+    m_Levels.clear();
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) return false;
+    // A missing source is fine (cooked-only installs); an edited one invalidates the cache.
+    if (std::filesystem::exists(sourcePath, error) &&
+        std::filesystem::last_write_time(sourcePath, error) > std::filesystem::last_write_time(path, error)) {
+        return false;
+    }
+    if (!m_File.Open(path)) return false;
+
+    const std::uint8_t* data = m_File.GetData();
+    const std::size_t size = m_File.GetSize();
+    CacheHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_VERSION || header.format > static_cast<std::uint32_t>(TextureFormat::BC3) ||
+        header.levelCount == 0 || sizeof(header) + sizeof(CacheLevel) * header.levelCount > size) {
+        std::cerr << "ERROR: Invalid texture cache: " << path << std::endl;
+        m_File.Close();
+        return false;
+    }
+
+    m_Format = static_cast<TextureFormat>(header.format);
+    for (std::uint32_t i = 0; i < header.levelCount; i++) {
+        CacheLevel level;
+        std::memcpy(&level, data + sizeof(header) + sizeof(CacheLevel) * i, sizeof(level));
+        if (level.offset + level.size > size || level.size != EncodedSize(level.width, level.height, m_Format)) {
+            std::cerr << "ERROR: Invalid texture cache: " << path << std::endl;
+            m_Levels.clear();
+            m_File.Close();
+            return false;
+        }
+        m_Levels.push_back({static_cast<int>(level.width), static_cast<int>(level.height), data + level.offset, static_cast<std::size_t>(level.size)});
+    }
+    return true;
+}
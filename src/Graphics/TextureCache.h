@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../Core/MappedFile.h"
+
+enum class TextureFormat : std::uint32_t {
+    RGBA8 = 0,
+    BC1,        // S3TC DXT1, opaque, 8 bytes per 4x4 block
+    BC3         // S3TC DXT5, with alpha, 16 bytes per 4x4 block
+};
+
+// One uncompressed RGBA8 mip level.
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> pixels;
+};
+
+// A mip level as stored in the cache file, in the file's format.
+struct TextureLevelView {
+    int width, height;
+    const std::uint8_t* data;
+    std::size_t size;
+};
+
+// Cooked texture file (<source>.mtex): header, level table, then every mip level already in its
+// upload format, so loading is a map and a straight copy to the GPU per level. Written offline by
+// the texture-cooker tool; ResourceManager uses it in place of the PNG when it's not stale.
+class TextureCache {
+public:
+    static std::string GetCachePath(const std::string& sourcePath) { return sourcePath + ".mtex"; }
+
+    // Box-filtered chain down to 1x1; level 0 is the image itself.
+    static std::vector<TextureImage> BuildMipChain(TextureImage base);
+
+    static bool HasAlpha(const TextureImage& image);
+    static std::vector<std::uint8_t> Encode(const TextureImage& image, TextureFormat format);
+
+    // Levels wider or taller than maxSize are dropped (0 keeps everything).
+    static bool Write(const std::string& path, const std::vector<TextureImage>& levels, TextureFormat format, int maxSize);
+
+    // Maps path; fails when the file is missing or malformed, or older than sourcePath.
+    bool Open(const std::string& path, const std::string& sourcePath);
+
+    TextureFormat GetFormat() const { return m_Format; }
+    const std::vector<TextureLevelView>& GetLevels() const { return m_Levels; }
+
+private:
+    MappedFile m_File;
+    TextureFormat m_Format = TextureFormat::RGBA8;
+    std::vector<TextureLevelView> m_Levels;
+};
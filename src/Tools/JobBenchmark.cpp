@@ -0,0 +1,91 @@
+#include "Core/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Scaling benchmark for the JobSystem: lights a square grid from a set of point lights, one
+// ParallelFor over rows per pass, with 1 thread up to one per core.
+//   job-benchmark [--size N] [--lights N] [--passes N] [--threads N]
+
+struct GridLight {
+    float x, z, radius, intensity;
+};
+
+static std::vector<GridLight> MakeLights(int count, int size) {
+    std::vector<GridLight> lights;
+    unsigned int seed = 12345u;
+    auto next = [&seed] {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    };
+    for (int i = 0; i < count; i++) lights.push_back({next() * size, next() * size, 8.0f + next() * 56.0f, 0.5f + next()});
+    return lights;
+}
+
+static void LightRows(std::vector<float>& grid, int size, const std::vector<GridLight>& lights, int firstRow, int lastRow) {
+    for (int z = firstRow; z < lastRow; z++) {
+        for (int x = 0; x < size; x++) {
+            float sum = 0.0f;
+            for (const GridLight& light : lights) {
+                float dx = x + 0.5f - light.x, dz = z + 0.5f - light.z;
+                float distance = std::sqrt(dx * dx + dz * dz);
+                float falloff = std::max(0.0f, 1.0f - distance / light.radius);
+                sum += light.intensity * falloff * falloff;
+            }
+            grid[static_cast<std::size_t>(z) * size + x] = sum;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int size = 1024, lightCount = 64, passes = 4;
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) size = std::atoi(argv[++i]);
+        else if (arg == "--lights" && i + 1 < argc) lightCount = std::atoi(argv[++i]);
+        else if (arg == "--passes" && i + 1 < argc) passes = std::atoi(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) maxThreads = static_cast<unsigned int>(std::max(1, std::atoi(argv[++i])));
+        else {
+            std::fprintf(stderr, "usage: job-benchmark [--size N] [--lights N] [--passes N] [--threads N]\n");
+            return 1;
+        }
+    }
+    if (size <= 0 || lightCount <= 0 || passes <= 0) {
+        std::fprintf(stderr, "ERROR: --size, --lights and --passes must be positive\n");
+        return 1;
+    }
+
+    const std::vector<GridLight> lights = MakeLights(lightCount, size);
+    std::vector<float> grid(static_cast<std::size_t>(size) * size);
+    // Powers of two up to one thread per core (or --threads), plus the full count.
+    std::vector<unsigned int> threadCounts;
+    for (unsigned int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+    std::printf("%dx%d grid, %d lights, %d passes\n", size, size, lightCount, passes);
+    std::printf("%8s %10s %8s %10s %14s\n", "threads", "ms/pass", "speedup", "efficiency", "checksum");
+
+    double baseline = 0.0;
+    for (unsigned int threads : threadCounts) {
+        JobSystem jobs(threads - 1);
+        auto run = [&] {
+            jobs.ParallelFor(0, size, 4, [&](int first, int last) { LightRows(grid, size, lights, first, last); });
+        };
+        run();  // warm up the workers and the grid
+
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; pass++) run();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / passes;
+
+        double checksum = 0.0;
+        for (float value : grid) checksum += value;
+        if (threads == 1) baseline = ms;
+        const double speedup = baseline / ms;
+        std::printf("%8u %10.2f %7.2fx %9.0f%% %14.1f\n", threads, ms, speedup, 100.0 * speedup / threads, checksum);
+    }
+    return 0;
+}
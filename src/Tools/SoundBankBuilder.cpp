@@ -0,0 +1,46 @@
+#include "Core/SoundBank.h"
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Offline sound bank builder: decodes each effect and writes them all ADPCM-compressed into one bank.
+//   sound-bank-builder bank.msbk sound.wav...
+// Effects are stored under their file name, which is what AudioManager looks them up by.
+
+static bool ReadSound(const std::string& path, SoundBank::Source& out) {
+    sf::InputSoundFile file;
+    if (!file.openFromFile(path) || file.getChannelCount() == 0 || file.getChannelCount() > 2) {
+        std::cerr << "ERROR: Failed to load sound (mono or stereo only): " << path << std::endl;
+        return false;
+    }
+
+    out.name = std::filesystem::path(path).filename().string();
+    out.sampleRate = file.getSampleRate();
+    out.channels = file.getChannelCount();
+    out.samples.resize(static_cast<std::size_t>(file.getSampleCount()));
+    out.samples.resize(static_cast<std::size_t>(file.read(out.samples.data(), out.samples.size())));
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: sound-bank-builder bank.msbk sound.wav..." << std::endl;
+        return -1;
+    }
+
+    std::vector<SoundBank::Source> sounds;
+    std::size_t pcmBytes = 0;
+    for (int i = 2; i < argc; i++) {
+        SoundBank::Source sound;
+        if (!ReadSound(argv[i], sound)) return 1;
+        pcmBytes += sound.samples.size() * sizeof(std::int16_t);
+        sounds.push_back(std::move(sound));
+    }
+
+    if (!SoundBank::Write(argv[1], sounds)) return 1;
+    std::cout << argv[1] << ": " << sounds.size() << " sounds, " << pcmBytes / 1024 << " KB PCM -> "
+              << std::filesystem::file_size(argv[1]) / 1024 << " KB" << std::endl;
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "Graphics/TextureCache.h"
+#include <SFML/Graphics/Image.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Offline texture cooker: decodes each PNG, builds its mip chain and writes <png>.mtex next to it.
+//   texture-cooker [--format auto|bc1|bc3|rgba8] [--max-size N] image.png...
+// auto picks BC3 when the image has any transparency and BC1 otherwise.
+
+static bool CookTexture(const std::string& path, const std::string& formatName, int maxSize) {
+    sf::Image image;
+    if (!image.loadFromFile(path) || image.getSize().x == 0 || image.getSize().y == 0) {
+        std::cerr << "ERROR: Failed to load texture: " << path << std::endl;
+        return false;
+    }
+
+    TextureImage base;
+    base.width = static_cast<int>(image.getSize().x);
+    base.height = static_cast<int>(image.getSize().y);
+    base.pixels.assign(image.getPixelsPtr(), image.getPixelsPtr() + static_cast<std::size_t>(base.width) * base.height * 4);
+
+    TextureFormat format = TextureFormat::RGBA8;
+    if (formatName == "bc1") format = TextureFormat::BC1;
+    else if (formatName == "bc3") format = TextureFormat::BC3;
+    else if (formatName == "auto") format = TextureCache::HasAlpha(base) ? TextureFormat::BC3 : TextureFormat::BC1;
+
+    const int width = base.width, height = base.height;
+    std::vector<TextureImage> levels = TextureCache::BuildMipChain(std::move(base));
+    const std::string cachePath = TextureCache::GetCachePath(path);
+    if (!TextureCache::Write(cachePath, levels, format, maxSize)) return false;
+
+    static const char* FORMAT_NAMES[] = {"RGBA8", "BC1", "BC3"};
+    std::cout << path << ": " << width << "x" << height << " -> " << cachePath
+              << " (" << FORMAT_NAMES[static_cast<int>(format)] << ")" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::string formatName = "auto";
+    int maxSize = 0;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            formatName = argv[++i];
+        } else if (arg == "--max-size" && i + 1 < argc) {
+            maxSize = std::atoi(argv[++i]);
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (inputs.empty() || (formatName != "auto" && formatName != "bc1" && formatName != "bc3" && formatName != "rgba8")) {
+        std::cerr << "Usage: texture-cooker [--format auto|bc1|bc3|rgba8] [--max-size N] image.png..." << std::endl;
+        return -1;
+    }
+
+    int failures = 0;
+    for (const std::string& input : inputs) {
+        if (!CookTexture(input, formatName, maxSize)) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
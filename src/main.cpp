@@ -1,14 +1,106 @@
 #include "Core/Game.h"
+#include "Graphics/LightmapBaker.h"
+#include "Graphics/MazeGeometry.h"
+#include "Graphics/SoftwareRenderer.h"
+#include "Core/Profiler.h"
+#include <SFML/System/Clock.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+
+// Offline bake: writes <level>.lightmap next to the level without opening a window.
+static int BakeLightmap(const std::string& levelPath) {
+    Map map;
+    glm::vec3 playerStart, paperPos;
+    if (!map.LoadLevel(levelPath, playerStart, paperPos)) return -1;
+
+    MazeGeometry geometry = MazeGeometry::Build(map);
+    LightmapBaker::LoadOrBake(levelPath, map, geometry.staticLights);
+    return 0;
+}
+
+// CPU-only frame from the level's start position, for machines without a usable GL driver.
+static int RenderSoftware(const std::string& levelPath, const std::string& outputPath, int width, int height) {
+    Map map;
+    glm::vec3 playerStart, paperPos;
+    if (!map.LoadLevel(levelPath, playerStart, paperPos)) return -1;
+
+    Player player(playerStart);
+    SoftwareRenderer renderer(width, height);
+    if (!renderer.LoadTextures()) return -1;
+    SoftwareCamera camera = SoftwareCamera::FromPlayer(player, RenderSettings().fogDensity);
+
+    const int frames = 10;
+    renderer.Render(map, camera);
+    sf::Clock clock;
+    for (int i = 0; i < frames; i++) renderer.Render(map, camera);
+    float ms = clock.getElapsedTime().asSeconds() * 1000.0f / frames;
+    std::cout << "Software render " << width << "x" << height << ": " << ms << " ms/frame" << std::endl;
+
+    return renderer.SavePng(outputPath) ? 0 : -1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--bake-lightmap") {
+        return BakeLightmap(argv[2]);
+    }
+    if (argc > 3 && std::string(argv[1]) == "--render-software") {
+        int width = argc > 5 ? std::atoi(argv[4]) : 1280;
+        int height = argc > 5 ? std::atoi(argv[5]) : 720;
+        if (width <= 0 || height <= 0) {
+            std::cerr << "ERROR: Invalid software render size" << std::endl;
+            return -1;
+        }
+        return RenderSoftware(argv[2], argv[3], width, height);
+    }
+
+    RenderSettings renderSettings;
+    BenchmarkOptions benchmark;
+    bool runBenchmark = false;
+    std::string tracePath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--target-fps" && hasValue) {
+            float fps = static_cast<float>(std::atof(argv[++i]));
+            if (fps > 0.0f) renderSettings.targetFrameMs = 1000.0f / fps;
+        }
+        else if (arg == "--texture-budget" && hasValue) {
+            renderSettings.textureBudgetMB = std::max(16, std::atoi(argv[++i]));
+        }
+        else if (arg == "--sound-cache" && hasValue) {
+            renderSettings.soundCacheKB = std::max(256, std::atoi(argv[++i]));
+        }
+        else if (arg == "--benchmark") runBenchmark = true;
+        else if (arg == "--trace" && hasValue) tracePath = argv[++i];
+        else if (arg == "--update-golden") benchmark.updateGolden = true;
+        else if (arg == "--level" && hasValue) benchmark.levelPath = argv[++i];
+        else if (arg == "--camera-path" && hasValue) benchmark.cameraPath = argv[++i];
+        else if (arg == "--golden-dir" && hasValue) benchmark.goldenDir = argv[++i];
+        else if (arg == "--tolerance" && hasValue) benchmark.tolerance = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--size" && i + 2 < argc) {
+            benchmark.width = std::max(1, std::atoi(argv[++i]));
+            benchmark.height = std::max(1, std::atoi(argv[++i]));
+        }
+    }
 
-int main() {
     try {
-        Game game;
+        if (runBenchmark) {
+            FrameBenchmark frameBenchmark(benchmark);
+            Game game(renderSettings, &benchmark);
+            int result = game.RunBenchmark(frameBenchmark);
+            if (!tracePath.empty()) Profiler::WriteTrace(tracePath);
+            return result;
+        }
+
+        Game game(renderSettings);
         game.Run();
+        if (!tracePath.empty()) Profiler::WriteTrace(tracePath);
     }
     catch (const std::exception& e) {
         std::cerr << "FATAL ERROR: " << e.what() << std::endl;
         return -1;
     }
     return 0;
-}
\ No newline at end of file
+}